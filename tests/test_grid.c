@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <glib.h>
+
+#include "grid.h"
+
+#define NUMBER_OF_PAGES 100000
+#define PADDING 8
+
+static zathura_grid_t* grid_new(unsigned int npag, unsigned int ncol, unsigned int first_page_column,
+                                bool right_to_left) {
+  zathura_grid_t* grid    = g_new0(zathura_grid_t, 1);
+  grid->npag              = npag;
+  grid->ncol              = ncol;
+  grid->nrow              = (npag + first_page_column - 1 + ncol - 1) / ncol;
+  grid->first_page_column = first_page_column;
+  grid->right_to_left     = right_to_left;
+  grid->rows              = g_new0(zathura_grid_line_t, grid->nrow);
+  grid->cols              = g_new0(zathura_grid_line_t, grid->ncol);
+
+  for (unsigned int i = 0; i < npag; i++) {
+    unsigned int row, col;
+    zathura_grid_page_to_cell(grid, i, &row, &col);
+
+    grid->rows[row].size = MAX(grid->rows[row].size, (unsigned int)g_test_rand_int_range(100, 1500));
+    grid->cols[col].size = MAX(grid->cols[col].size, (unsigned int)g_test_rand_int_range(100, 1000));
+  }
+
+  zathura_grid_lines_prefix_sum(grid->rows, grid->nrow, 0, PADDING);
+  zathura_grid_lines_prefix_sum(grid->cols, grid->ncol, 0, PADDING);
+
+  return grid;
+}
+
+static void grid_free(zathura_grid_t* grid) {
+  g_free(grid->rows);
+  g_free(grid->cols);
+  g_free(grid);
+}
+
+static unsigned int grid_height(const zathura_grid_t* grid) {
+  return grid->rows[grid->nrow - 1].pos + grid->rows[grid->nrow - 1].size;
+}
+
+static unsigned int grid_width(const zathura_grid_t* grid) {
+  return grid->cols[grid->ncol - 1].pos + grid->cols[grid->ncol - 1].size;
+}
+
+/* the linear scan position_to_page_number used to do */
+static unsigned int linear_position_to_page(const zathura_grid_t* grid, double x, double y) {
+  unsigned int row = grid->nrow - 1;
+  for (unsigned int i = 0; i < grid->nrow; i++) {
+    if (y <= grid->rows[i].pos + grid->rows[i].size) {
+      row = i;
+      break;
+    }
+  }
+
+  unsigned int col = grid->ncol - 1;
+  for (unsigned int i = 0; i < grid->ncol; i++) {
+    if (x <= grid->cols[i].pos + grid->cols[i].size) {
+      col = i;
+      break;
+    }
+  }
+  if (grid->right_to_left == true) {
+    col = grid->ncol - 1 - col;
+  }
+
+  const unsigned int page = grid->ncol * row + col;
+  const unsigned int c0   = grid->first_page_column;
+  if (page < c0 - 1) {
+    return 0;
+  }
+  return MIN(page - (c0 - 1), grid->npag - 1);
+}
+
+static void check_grid(const zathura_grid_t* grid) {
+  const unsigned int height = grid_height(grid);
+  const unsigned int width  = grid_width(grid);
+
+  /* arbitrary positions, including ones outside of the document */
+  for (unsigned int i = 0; i < 10000; i++) {
+    const double x = g_test_rand_double_range(-10, width + 10);
+    const double y = g_test_rand_double_range(-10, height + 10);
+    g_assert_cmpuint(zathura_grid_position_to_page(grid, x, y), ==, linear_position_to_page(grid, x, y));
+  }
+
+  /* the center of the cell of a page maps back to the page */
+  for (unsigned int i = 0; i < 10000; i++) {
+    const unsigned int page = g_test_rand_int_range(0, grid->npag);
+    unsigned int row, col;
+    zathura_grid_page_to_cell(grid, page, &row, &col);
+
+    const double x = grid->cols[col].pos + 0.5 * grid->cols[col].size;
+    const double y = grid->rows[row].pos + 0.5 * grid->rows[row].size;
+    g_assert_cmpuint(zathura_grid_position_to_page(grid, x, y), ==, page);
+  }
+
+  /* page ranges cover exactly the pages of the rows intersecting the range */
+  for (unsigned int i = 0; i < 1000; i++) {
+    const double top    = g_test_rand_double_range(0, height);
+    const double bottom = top + g_test_rand_double_range(0, 3000);
+
+    unsigned int first = 0, last = 0;
+    g_assert_true(zathura_grid_page_range(grid, top, bottom, &first, &last));
+
+    unsigned int first_row, last_row, col;
+    zathura_grid_page_to_cell(grid, first, &first_row, &col);
+    zathura_grid_page_to_cell(grid, last, &last_row, &col);
+    g_assert_cmpfloat(grid->rows[first_row].pos + grid->rows[first_row].size, >=, top);
+    g_assert_true(first_row == 0 || grid->rows[first_row - 1].pos + grid->rows[first_row - 1].size < top);
+    g_assert_true(last_row == grid->nrow - 1 || grid->rows[last_row + 1].pos > bottom);
+  }
+}
+
+static void test_grid_single_column(void) {
+  zathura_grid_t* grid = grid_new(NUMBER_OF_PAGES, 1, 1, false);
+  check_grid(grid);
+  grid_free(grid);
+}
+
+static void test_grid_multiple_columns(void) {
+  zathura_grid_t* grid = grid_new(NUMBER_OF_PAGES, 2, 2, false);
+  check_grid(grid);
+  grid_free(grid);
+
+  grid = grid_new(NUMBER_OF_PAGES + 1, 3, 1, false);
+  check_grid(grid);
+  grid_free(grid);
+}
+
+static void test_grid_right_to_left(void) {
+  zathura_grid_t* grid = grid_new(NUMBER_OF_PAGES, 3, 2, true);
+  check_grid(grid);
+  grid_free(grid);
+}
+
+static void test_grid_empty(void) {
+  zathura_grid_t grid = {0};
+  unsigned int first  = 0, last = 0;
+  g_assert_cmpuint(zathura_grid_position_to_page(&grid, 10, 10), ==, 0);
+  g_assert_false(zathura_grid_page_range(&grid, 0, 100, &first, &last));
+}
+
+static void test_grid_prefix_sum_from(void) {
+  zathura_grid_t* grid = grid_new(1000, 1, 1, false);
+
+  /* only the lines after a changed line move */
+  const unsigned int before = grid->rows[499].pos;
+  grid->rows[500].size += 10;
+  zathura_grid_lines_prefix_sum(grid->rows, grid->nrow, 501, PADDING);
+  g_assert_cmpuint(grid->rows[499].pos, ==, before);
+  g_assert_cmpuint(grid->rows[501].pos, ==, grid->rows[500].pos + grid->rows[500].size + PADDING);
+
+  zathura_grid_line_t* copy = g_memdup2(grid->rows, grid->nrow * sizeof(zathura_grid_line_t));
+  zathura_grid_lines_prefix_sum(copy, grid->nrow, 0, PADDING);
+  for (unsigned int i = 0; i < grid->nrow; i++) {
+    g_assert_cmpuint(copy[i].pos, ==, grid->rows[i].pos);
+  }
+  g_free(copy);
+
+  /* nothing to do past the last line */
+  zathura_grid_lines_prefix_sum(grid->rows, grid->nrow, grid->nrow, PADDING);
+  grid_free(grid);
+}
+
+static void test_grid_benchmark(void) {
+  zathura_grid_t* grid      = grid_new(NUMBER_OF_PAGES, 2, 1, false);
+  const unsigned int height = grid_height(grid);
+  /* scroll through the whole document in 10000 steps */
+  const unsigned int step = height / 10000;
+  unsigned int checksum   = 0;
+
+  g_test_timer_start();
+  for (unsigned int y = 0; y < height; y += step) {
+    checksum += linear_position_to_page(grid, 0, y);
+  }
+  const double linear = g_test_timer_elapsed();
+
+  g_test_timer_start();
+  for (unsigned int y = 0; y < height; y += step) {
+    checksum -= zathura_grid_position_to_page(grid, 0, y);
+  }
+  const double binary = g_test_timer_elapsed();
+
+  g_assert_cmpuint(checksum, ==, 0);
+  g_test_message("%u positions: linear %.3f ms, binary search %.3f ms (%.1fx)", height / step, linear * 1000,
+                 binary * 1000, linear / binary);
+  g_test_minimized_result(binary, "binary search: %.3f ms", binary * 1000);
+
+  grid_free(grid);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/grid/single_column", test_grid_single_column);
+  g_test_add_func("/grid/multiple_columns", test_grid_multiple_columns);
+  g_test_add_func("/grid/right_to_left", test_grid_right_to_left);
+  g_test_add_func("/grid/empty", test_grid_empty);
+  g_test_add_func("/grid/prefix_sum_from", test_grid_prefix_sum_from);
+  if (g_test_perf()) {
+    g_test_add_func("/grid/benchmark", test_grid_benchmark);
+  }
+  return g_test_run();
+}
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <glib.h>
+
+#include "link-index.h"
+
+#define NUMBER_OF_LINKS 500
+#define PAGE_WIDTH 600
+#define PAGE_HEIGHT 800
+
+static int find_linear(const zathura_rectangle_t* rectangles, unsigned int n, double x, double y) {
+  for (unsigned int idx = 0; idx < n; ++idx) {
+    const zathura_rectangle_t* rectangle = &rectangles[idx];
+    if (MIN(rectangle->x1, rectangle->x2) <= x && MAX(rectangle->x1, rectangle->x2) >= x &&
+        MIN(rectangle->y1, rectangle->y2) <= y && MAX(rectangle->y1, rectangle->y2) >= y) {
+      return idx;
+    }
+  }
+
+  return -1;
+}
+
+static void test_link_index_empty(void) {
+  zathura_link_index_t* index = zathura_link_index_new(NULL, 0, PAGE_WIDTH, PAGE_HEIGHT);
+  g_assert_nonnull(index);
+  g_assert_cmpint(zathura_link_index_find(index, 10, 10), ==, -1);
+  zathura_link_index_free(index);
+}
+
+static void test_link_index_overlap(void) {
+  const zathura_rectangle_t rectangles[] = {
+      {.x1 = 100, .y1 = 100, .x2 = 200, .y2 = 150},
+      {.x1 = 0, .y1 = 0, .x2 = PAGE_WIDTH, .y2 = PAGE_HEIGHT},
+      /* swapped coordinates and areas outside of the page */
+      {.x1 = 50, .y1 = 30, .x2 = -20, .y2 = -10},
+  };
+
+  zathura_link_index_t* index = zathura_link_index_new(rectangles, G_N_ELEMENTS(rectangles), PAGE_WIDTH, PAGE_HEIGHT);
+  g_assert_cmpint(zathura_link_index_find(index, 150, 120), ==, 0);
+  g_assert_cmpint(zathura_link_index_find(index, 200, 150), ==, 0);
+  g_assert_cmpint(zathura_link_index_find(index, 300, 400), ==, 1);
+  g_assert_cmpint(zathura_link_index_find(index, -5, -5), ==, 2);
+  g_assert_cmpint(zathura_link_index_find(index, PAGE_WIDTH + 1, 10), ==, -1);
+  zathura_link_index_free(index);
+}
+
+static void test_link_index_random(void) {
+  zathura_rectangle_t rectangles[NUMBER_OF_LINKS];
+  for (unsigned int idx = 0; idx < NUMBER_OF_LINKS; ++idx) {
+    const double x     = g_test_rand_double_range(-20, PAGE_WIDTH);
+    const double y     = g_test_rand_double_range(-20, PAGE_HEIGHT);
+    rectangles[idx].x1 = x;
+    rectangles[idx].y1 = y;
+    rectangles[idx].x2 = x + g_test_rand_double_range(1, idx % 10 == 0 ? 300 : 40);
+    rectangles[idx].y2 = y + g_test_rand_double_range(1, 20);
+  }
+
+  zathura_link_index_t* index = zathura_link_index_new(rectangles, NUMBER_OF_LINKS, PAGE_WIDTH, PAGE_HEIGHT);
+  for (unsigned int idx = 0; idx < 10000; ++idx) {
+    const double x = g_test_rand_double_range(-30, PAGE_WIDTH + 30);
+    const double y = g_test_rand_double_range(-30, PAGE_HEIGHT + 30);
+    g_assert_cmpint(zathura_link_index_find(index, x, y), ==, find_linear(rectangles, NUMBER_OF_LINKS, x, y));
+  }
+
+  /* corners of the link areas lie on their borders */
+  for (unsigned int idx = 0; idx < NUMBER_OF_LINKS; ++idx) {
+    const zathura_rectangle_t* rectangle = &rectangles[idx];
+    g_assert_cmpint(zathura_link_index_find(index, rectangle->x2, rectangle->y2), ==,
+                    find_linear(rectangles, NUMBER_OF_LINKS, rectangle->x2, rectangle->y2));
+  }
+  zathura_link_index_free(index);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/link_index/empty", test_link_index_empty);
+  g_test_add_func("/link_index/overlap", test_link_index_overlap);
+  g_test_add_func("/link_index/random", test_link_index_random);
+  return g_test_run();
+}
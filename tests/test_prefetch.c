@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <glib.h>
+
+#include "prefetch.h"
+
+#define VIEW_SIZE 1000
+
+static void test_prefetch_idle(void) {
+  zathura_prefetch_t prefetch = {0};
+  double start = 0, end = 0;
+  g_assert_false(zathura_prefetch_get_range(&prefetch, 0, VIEW_SIZE, 3, &start, &end));
+
+  /* a single position gives no direction */
+  zathura_prefetch_update(&prefetch, 5000, 100000, G_USEC_PER_SEC);
+  g_assert_false(zathura_prefetch_get_range(&prefetch, 5000, VIEW_SIZE, 3, &start, &end));
+
+  /* neither does a position after zooming */
+  zathura_prefetch_update(&prefetch, 5100, 100000, G_USEC_PER_SEC + 10000);
+  zathura_prefetch_update(&prefetch, 9000, 200000, G_USEC_PER_SEC + 20000);
+  g_assert_false(zathura_prefetch_get_range(&prefetch, 9000, VIEW_SIZE, 3, &start, &end));
+
+  zathura_prefetch_reset(&prefetch);
+  g_assert_false(zathura_prefetch_get_range(&prefetch, 9000, VIEW_SIZE, 3, &start, &end));
+}
+
+static void test_prefetch_direction(void) {
+  zathura_prefetch_t prefetch = {0};
+  double start = 0, end = 0;
+
+  /* slow scrolling down prefetches the next screen */
+  zathura_prefetch_update(&prefetch, 5000, 100000, G_USEC_PER_SEC);
+  zathura_prefetch_update(&prefetch, 5050, 100000, G_USEC_PER_SEC + 100000);
+  g_assert_true(zathura_prefetch_get_range(&prefetch, 5050, VIEW_SIZE, 3, &start, &end));
+  g_assert_cmpfloat(start, ==, 6050);
+  g_assert_cmpfloat(end, ==, 7050);
+
+  /* scrolling up after a pause prefetches the previous screen */
+  zathura_prefetch_update(&prefetch, 4900, 100000, 2 * G_USEC_PER_SEC);
+  g_assert_true(zathura_prefetch_get_range(&prefetch, 4900, VIEW_SIZE, 3, &start, &end));
+  g_assert_cmpfloat(start, ==, 3900);
+  g_assert_cmpfloat(end, ==, 4900);
+}
+
+static void test_prefetch_velocity(void) {
+  zathura_prefetch_t prefetch = {0};
+  double start = 0, end = 0;
+
+  /* 2500 pixels per second cover three screens within a second */
+  for (unsigned int idx = 0; idx <= 10; ++idx) {
+    zathura_prefetch_update(&prefetch, 250 * idx, 100000, idx * 100000);
+  }
+  g_assert_cmpfloat_with_epsilon(prefetch.velocity, 2500, 5);
+  g_assert_true(zathura_prefetch_get_range(&prefetch, 2500, VIEW_SIZE, 10, &start, &end));
+  g_assert_cmpfloat(start, ==, 3500);
+  g_assert_cmpfloat(end, ==, 6500);
+
+  /* but no more than allowed */
+  g_assert_true(zathura_prefetch_get_range(&prefetch, 2500, VIEW_SIZE, 2, &start, &end));
+  g_assert_cmpfloat(end, ==, 5500);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/prefetch/idle", test_prefetch_idle);
+  g_test_add_func("/prefetch/direction", test_prefetch_direction);
+  g_test_add_func("/prefetch/velocity", test_prefetch_velocity);
+  return g_test_run();
+}
@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "recolor.h"
+
+static const zathura_recolor_implementation_t implementations[] = {
+    ZATHURA_RECOLOR_LUT,
+    ZATHURA_RECOLOR_LUT_SSE2,
+    ZATHURA_RECOLOR_LUT_AVX2,
+};
+
+static unsigned char* random_pixels(unsigned int count) {
+  unsigned char* pixels = g_malloc(4 * count);
+  for (unsigned int idx = 0; idx < count; ++idx) {
+    const guint32 value = g_test_rand_int();
+    pixels[4 * idx + 0] = value & 0xFF;
+    pixels[4 * idx + 1] = (value >> 8) & 0xFF;
+    pixels[4 * idx + 2] = (value >> 16) & 0xFF;
+    pixels[4 * idx + 3] = 0xFF;
+  }
+
+  return pixels;
+}
+
+static void check_implementations(const GdkRGBA* light, const GdkRGBA* dark, bool adjust_lightness) {
+  /* an odd number of pixels to exercise the scalar tails of the vector code */
+  const unsigned int count = 4099;
+
+  zathura_recolor_t* recolor = zathura_recolor_new(light, dark, false, adjust_lightness);
+  g_assert_nonnull(recolor);
+
+  g_autofree unsigned char* input     = random_pixels(count);
+  g_autofree unsigned char* reference = g_memdup2(input, 4 * count);
+  g_assert_true(zathura_recolor_set_implementation(recolor, ZATHURA_RECOLOR_REFERENCE));
+  zathura_recolor_span(recolor, reference, count);
+
+  for (size_t i = 0; i < G_N_ELEMENTS(implementations); ++i) {
+    if (zathura_recolor_set_implementation(recolor, implementations[i]) == false) {
+      g_test_message("implementation %d not supported", implementations[i]);
+      continue;
+    }
+
+    g_autofree unsigned char* output = g_memdup2(input, 4 * count);
+    zathura_recolor_span(recolor, output, count);
+
+    for (unsigned int idx = 0; idx < 4 * count; ++idx) {
+      g_assert_cmpint(abs(output[idx] - reference[idx]), <=, 1);
+    }
+  }
+
+  zathura_recolor_free(recolor);
+}
+
+static void test_recolor_lut(void) {
+  const GdkRGBA white = {1, 1, 1, 1};
+  const GdkRGBA black = {0, 0, 0, 1};
+  const GdkRGBA light = {0.9, 0.85, 0.7, 1};
+  const GdkRGBA dark  = {0.1, 0.2, 0.15, 1};
+
+  check_implementations(&black, &white, false);
+  check_implementations(&black, &white, true);
+  check_implementations(&light, &dark, false);
+  check_implementations(&light, &dark, true);
+}
+
+static void test_recolor_lut_unavailable(void) {
+  const GdkRGBA light       = {0.9, 0.85, 0.7, 1};
+  const GdkRGBA dark        = {0.1, 0.2, 0.15, 1};
+  const GdkRGBA transparent = {0.1, 0.2, 0.15, 0.5};
+
+  /* keeping the hue depends on more than the lightness */
+  zathura_recolor_t* recolor = zathura_recolor_new(&light, &dark, true, false);
+  g_assert_nonnull(recolor);
+  g_assert_cmpint(zathura_recolor_get_implementation(recolor), ==, ZATHURA_RECOLOR_REFERENCE);
+  g_assert_false(zathura_recolor_set_implementation(recolor, ZATHURA_RECOLOR_LUT));
+  zathura_recolor_free(recolor);
+
+  /* so does mixing with transparent colors */
+  recolor = zathura_recolor_new(&light, &transparent, false, false);
+  g_assert_nonnull(recolor);
+  g_assert_cmpint(zathura_recolor_get_implementation(recolor), ==, ZATHURA_RECOLOR_REFERENCE);
+  zathura_recolor_free(recolor);
+}
+
+static void test_recolor_benchmark(void) {
+  const GdkRGBA light = {0.9, 0.85, 0.7, 1};
+  const GdkRGBA dark  = {0.1, 0.2, 0.15, 1};
+  /* one 4K frame */
+  const unsigned int count = 3840 * 2160;
+
+  zathura_recolor_t* recolor = zathura_recolor_new(&light, &dark, false, false);
+  g_assert_nonnull(recolor);
+
+  g_autofree unsigned char* input  = random_pixels(count);
+  g_autofree unsigned char* output = g_malloc(4 * count);
+
+  g_assert_true(zathura_recolor_set_implementation(recolor, ZATHURA_RECOLOR_REFERENCE));
+  memcpy(output, input, 4 * count);
+  g_test_timer_start();
+  zathura_recolor_span(recolor, output, count);
+  const double reference = g_test_timer_elapsed();
+  g_test_message("reference: %.3f ms", reference * 1000);
+
+  for (size_t i = 0; i < G_N_ELEMENTS(implementations); ++i) {
+    if (zathura_recolor_set_implementation(recolor, implementations[i]) == false) {
+      continue;
+    }
+
+    memcpy(output, input, 4 * count);
+    g_test_timer_start();
+    zathura_recolor_span(recolor, output, count);
+    const double elapsed = g_test_timer_elapsed();
+    g_test_message("implementation %d: %.3f ms (%.1fx)", implementations[i], elapsed * 1000, reference / elapsed);
+    g_test_minimized_result(elapsed, "implementation %d: %.3f ms", implementations[i], elapsed * 1000);
+  }
+
+  zathura_recolor_free(recolor);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/recolor/lut", test_recolor_lut);
+  g_test_add_func("/recolor/lut_unavailable", test_recolor_lut_unavailable);
+  if (g_test_perf()) {
+    g_test_add_func("/recolor/benchmark", test_recolor_benchmark);
+  }
+  return g_test_run();
+}
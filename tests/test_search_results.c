@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <girara/datastructures.h>
+
+#include "search-results.h"
+
+static girara_list_t* make_rectangles(unsigned int count) {
+  girara_list_t* list = girara_list_new_with_free(g_free);
+  for (unsigned int idx = 0; idx < count; ++idx) {
+    zathura_rectangle_t* rectangle = g_new0(zathura_rectangle_t, 1);
+    rectangle->x1                  = idx;
+    rectangle->x2                  = idx + 1;
+    girara_list_append(list, rectangle);
+  }
+
+  return list;
+}
+
+static void set_page(zathura_search_results_t* results, unsigned int page, unsigned int count) {
+  girara_list_t* list = make_rectangles(count);
+  zathura_search_results_set_page(results, page, list);
+  girara_list_free(list);
+}
+
+static void test_search_results_pages(void) {
+  zathura_search_results_t* results = zathura_search_results_new(10);
+  g_assert_nonnull(results);
+
+  set_page(results, 5, 2);
+  set_page(results, 1, 1);
+  set_page(results, 9, 3);
+  g_assert_cmpuint(zathura_search_results_get_total(results), ==, 6);
+
+  unsigned int length               = 0;
+  const zathura_rectangle_t* page_9 = zathura_search_results_get_page(results, 9, &length);
+  g_assert_cmpuint(length, ==, 3);
+  g_assert_cmpfloat(page_9[2].x1, ==, 2);
+  g_assert_null(zathura_search_results_get_page(results, 0, &length));
+  g_assert_cmpuint(length, ==, 0);
+
+  unsigned int page = 0;
+  g_assert_true(zathura_search_results_find_page(results, 0, true, &page));
+  g_assert_cmpuint(page, ==, 1);
+  g_assert_true(zathura_search_results_find_page(results, 6, true, &page));
+  g_assert_cmpuint(page, ==, 9);
+  g_assert_true(zathura_search_results_find_page(results, 5, false, &page));
+  g_assert_cmpuint(page, ==, 5);
+  g_assert_true(zathura_search_results_find_page(results, 4, false, &page));
+  g_assert_cmpuint(page, ==, 1);
+  g_assert_true(zathura_search_results_find_page(results, 0, false, &page));
+  g_assert_cmpuint(page, ==, 9);
+
+  /* replacing and removing pages updates the total */
+  set_page(results, 5, 4);
+  g_assert_cmpuint(zathura_search_results_get_total(results), ==, 8);
+  zathura_search_results_set_page(results, 1, NULL);
+  g_assert_cmpuint(zathura_search_results_get_total(results), ==, 7);
+  g_assert_true(zathura_search_results_find_page(results, 0, true, &page));
+  g_assert_cmpuint(page, ==, 5);
+
+  zathura_search_results_clear(results);
+  g_assert_cmpuint(zathura_search_results_get_total(results), ==, 0);
+  g_assert_false(zathura_search_results_find_page(results, 0, true, &page));
+
+  zathura_search_results_free(results);
+}
+
+static void test_search_results_cursor(void) {
+  zathura_search_results_t* results = zathura_search_results_new(10);
+  set_page(results, 5, 2);
+  set_page(results, 1, 1);
+  set_page(results, 9, 3);
+
+  unsigned int page  = 0;
+  unsigned int index = 0;
+  g_assert_false(zathura_search_results_get_current(results, &page, &index));
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 0);
+  g_assert_false(zathura_search_results_set_current(results, 5, 2));
+  g_assert_false(zathura_search_results_set_current(results, 4, 0));
+
+  g_assert_true(zathura_search_results_set_current(results, 5, 1));
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 3);
+
+  g_assert_true(zathura_search_results_move(results, true));
+  g_assert_true(zathura_search_results_get_current(results, &page, &index));
+  g_assert_cmpuint(page, ==, 9);
+  g_assert_cmpuint(index, ==, 0);
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 4);
+
+  /* moving wraps around the end of the document */
+  for (unsigned int idx = 0; idx < 3; ++idx) {
+    g_assert_true(zathura_search_results_move(results, true));
+  }
+  g_assert_true(zathura_search_results_get_current(results, &page, &index));
+  g_assert_cmpuint(page, ==, 1);
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 1);
+
+  g_assert_true(zathura_search_results_move(results, false));
+  g_assert_true(zathura_search_results_get_current(results, &page, &index));
+  g_assert_cmpuint(page, ==, 9);
+  g_assert_cmpuint(index, ==, 2);
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 6);
+
+  /* results on earlier pages shift the position of the current result */
+  set_page(results, 0, 2);
+  g_assert_true(zathura_search_results_get_current(results, &page, &index));
+  g_assert_cmpuint(page, ==, 9);
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 8);
+  zathura_search_results_set_page(results, 5, NULL);
+  g_assert_cmpuint(zathura_search_results_get_current_number(results), ==, 6);
+
+  /* the current result vanishes with its page */
+  zathura_search_results_set_page(results, 9, NULL);
+  g_assert_false(zathura_search_results_get_current(results, &page, &index));
+  g_assert_false(zathura_search_results_move(results, true));
+
+  zathura_search_results_free(results);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/search_results/pages", test_search_results_pages);
+  g_test_add_func("/search_results/cursor", test_search_results_cursor);
+  return g_test_run();
+}
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "text-index.h"
+
+static const uint8_t hash[32] = {0xde, 0xad, 0xbe, 0xef};
+
+static void test_text_index_normalize(void) {
+  g_assert_null(zathura_text_index_normalize(NULL));
+  g_assert_null(zathura_text_index_normalize("\xff"));
+
+  g_autofree char* text = zathura_text_index_normalize("Exam-\nple TEXT\xc2\xad here");
+  g_assert_cmpstr(text, ==, "exampletexthere");
+
+  /* ligatures are decomposed and diacritics dropped */
+  g_autofree char* ligature = zathura_text_index_normalize("\xef\xac\x81n\xc3\xa9");
+  g_assert_cmpstr(ligature, ==, "fine");
+}
+
+static void test_text_index_pages(void) {
+  zathura_text_index_t* index = zathura_text_index_new(NULL, NULL, 2, 0);
+  g_assert_nonnull(index);
+
+  g_assert_null(zathura_text_index_get_page(index, 0));
+  g_assert_cmpstr(zathura_text_index_set_page(index, 0, "Hello World"), ==, "helloworld");
+  g_assert_cmpstr(zathura_text_index_get_page(index, 0), ==, "helloworld");
+
+  /* indexed pages are not replaced */
+  g_assert_cmpstr(zathura_text_index_set_page(index, 0, "other"), ==, "helloworld");
+  g_assert_null(zathura_text_index_get_page(index, 1));
+
+  /* nothing to save without a cache directory */
+  g_assert_true(zathura_text_index_save(index));
+  zathura_text_index_free(index);
+}
+
+static void test_text_index_persist(void) {
+  g_autofree char* cache_dir = g_dir_make_tmp("zathura-text-index-XXXXXX", NULL);
+  g_assert_nonnull(cache_dir);
+
+  zathura_text_index_t* index = zathura_text_index_new(cache_dir, hash, 3, 0);
+  zathura_text_index_set_page(index, 0, "first page");
+  zathura_text_index_set_page(index, 2, "");
+  g_assert_true(zathura_text_index_save(index));
+  zathura_text_index_free(index);
+
+  index = zathura_text_index_new(cache_dir, hash, 3, 0);
+  g_assert_cmpstr(zathura_text_index_get_page(index, 0), ==, "firstpage");
+  g_assert_null(zathura_text_index_get_page(index, 1));
+  g_assert_cmpstr(zathura_text_index_get_page(index, 2), ==, "");
+  zathura_text_index_free(index);
+
+  /* an index with a different number of pages is ignored */
+  index = zathura_text_index_new(cache_dir, hash, 4, 0);
+  g_assert_null(zathura_text_index_get_page(index, 0));
+  zathura_text_index_free(index);
+
+  zathura_text_index_remove(cache_dir, hash);
+  index = zathura_text_index_new(cache_dir, hash, 3, 0);
+  g_assert_null(zathura_text_index_get_page(index, 0));
+  zathura_text_index_free(index);
+
+  g_autofree char* dir = g_build_filename(cache_dir, "text-index", NULL);
+  g_rmdir(dir);
+  g_rmdir(cache_dir);
+}
+
+static void test_text_index_prune(void) {
+  g_autofree char* cache_dir = g_dir_make_tmp("zathura-text-index-XXXXXX", NULL);
+  g_assert_nonnull(cache_dir);
+
+  static const uint8_t other_hash[32] = {0xca, 0xfe};
+
+  /* every index takes 19 bytes, so only one of them fits */
+  zathura_text_index_t* index = zathura_text_index_new(cache_dir, hash, 1, 30);
+  zathura_text_index_set_page(index, 0, "abc");
+  g_assert_true(zathura_text_index_save(index));
+  zathura_text_index_free(index);
+
+  index = zathura_text_index_new(cache_dir, other_hash, 1, 30);
+  zathura_text_index_set_page(index, 0, "def");
+  g_assert_true(zathura_text_index_save(index));
+  zathura_text_index_free(index);
+
+  index = zathura_text_index_new(cache_dir, hash, 1, 0);
+  g_assert_null(zathura_text_index_get_page(index, 0));
+  zathura_text_index_free(index);
+  index = zathura_text_index_new(cache_dir, other_hash, 1, 0);
+  g_assert_cmpstr(zathura_text_index_get_page(index, 0), ==, "def");
+  zathura_text_index_free(index);
+
+  /* an index that is larger than the cache is not saved */
+  index = zathura_text_index_new(cache_dir, hash, 1, 10);
+  zathura_text_index_set_page(index, 0, "abc");
+  g_assert_true(zathura_text_index_save(index));
+  zathura_text_index_free(index);
+  index = zathura_text_index_new(cache_dir, hash, 1, 0);
+  g_assert_null(zathura_text_index_get_page(index, 0));
+  zathura_text_index_free(index);
+
+  zathura_text_index_remove(cache_dir, other_hash);
+  g_autofree char* dir = g_build_filename(cache_dir, "text-index", NULL);
+  g_rmdir(dir);
+  g_rmdir(cache_dir);
+}
+
+int main(int argc, char* argv[]) {
+  g_test_init(&argc, &argv, NULL);
+  g_test_add_func("/text_index/normalize", test_text_index_normalize);
+  g_test_add_func("/text_index/pages", test_text_index_pages);
+  g_test_add_func("/text_index/persist", test_text_index_persist);
+  g_test_add_func("/text_index/prune", test_text_index_prune);
+  return g_test_run();
+}
@@ -1,5 +1,8 @@
 /* SPDX-License-Identifier: Zlib */
 
+#include <girara/datastructures.h>
+#include <math.h>
+
 #include "utils.h"
 
 static void test_file_valid_extension(void) {
@@ -8,8 +11,206 @@ static void test_file_valid_extension(void) {
   g_assert_false(file_valid_extension(NULL, "pdf"));
 }
 
+/* quadratic implementation of flatten_rectangles kept as reference */
+typedef struct zathura_point_s {
+  uintptr_t x;
+  uintptr_t y;
+} zathura_point_t;
+
+static int cmp_point(const void* va, const void* vb) {
+  const zathura_point_t* a = va;
+  const zathura_point_t* b = vb;
+
+  if (a->x == b->x) {
+    if (a->y == b->y) {
+      return 0;
+    }
+
+    return a->y < b->y ? -1 : 1;
+  }
+
+  return a->x < b->x ? -1 : 1;
+}
+
+static inline uintptr_t ufloor(double f) {
+  return floor(f);
+}
+
+static inline uintptr_t uceil(double f) {
+  return ceil(f);
+}
+
+static int cmp_uint(const void* vx, const void* vy) {
+  const uintptr_t x = (uintptr_t)vx;
+  const uintptr_t y = (uintptr_t)vy;
+
+  return x == y ? 0 : (x > y ? 1 : -1);
+}
+
+static int cmp_rectangle(const void* vr1, const void* vr2) {
+  const zathura_rectangle_t* r1 = vr1;
+  const zathura_rectangle_t* r2 = vr2;
+
+  // we only care about equlity here, no ordering
+  return (ufloor(r1->x1) == ufloor(r2->x1) && uceil(r1->x2) == uceil(r2->x2) && ufloor(r1->y1) == ufloor(r2->y1) &&
+          uceil(r1->y2) == uceil(r2->y2))
+             ? 0
+             : -1;
+}
+
+static bool list_append_unique(girara_list_t* l, girara_compare_function_t cmp, void* item) {
+  if (girara_list_find(l, cmp, item) != NULL) {
+    return false;
+  }
+
+  girara_list_append(l, item);
+  return true;
+}
+
+static void append_unique_point(girara_list_t* list, const uintptr_t x, const uintptr_t y) {
+  zathura_point_t* p = g_try_malloc(sizeof(zathura_point_t));
+  if (p == NULL) {
+    return;
+  }
+
+  p->x = x;
+  p->y = y;
+
+  if (list_append_unique(list, cmp_point, p) == false) {
+    g_free(p);
+  }
+}
+
+static void rectangle_to_points(void* vrect, void* vlist) {
+  const zathura_rectangle_t* rect = vrect;
+  girara_list_t* list             = vlist;
+
+  append_unique_point(list, ufloor(rect->x1), ufloor(rect->y1));
+  append_unique_point(list, ufloor(rect->x1), uceil(rect->y2));
+  append_unique_point(list, uceil(rect->x2), ufloor(rect->y1));
+  append_unique_point(list, uceil(rect->x2), uceil(rect->y2));
+}
+
+static void append_unique_uint(girara_list_t* list, const uintptr_t v) {
+  list_append_unique(list, cmp_uint, (void*)v);
+}
+
+// transform a rectangle into multiple new ones according a grid of points
+static void cut_rectangle(const zathura_rectangle_t* rect, girara_list_t* points, girara_list_t* rectangles) {
+  // Lists of ordred relevant points
+  g_autoptr(girara_list_t) xs = girara_sorted_list_new(cmp_uint);
+  g_autoptr(girara_list_t) ys = girara_sorted_list_new(cmp_uint);
+
+  append_unique_uint(xs, uceil(rect->x2));
+  append_unique_uint(ys, uceil(rect->y2));
+
+  for (size_t idx = 0; idx != girara_list_size(points); ++idx) {
+    const zathura_point_t* pt = girara_list_nth(points, idx);
+    if (pt->x > ufloor(rect->x1) && pt->x < uceil(rect->x2)) {
+      append_unique_uint(xs, pt->x);
+    }
+    if (pt->y > ufloor(rect->y1) && pt->y < uceil(rect->y2)) {
+      append_unique_uint(ys, pt->y);
+    }
+  }
+
+  double x = ufloor(rect->x1);
+  for (size_t idx = 0; idx != girara_list_size(xs); ++idx) {
+    const uintptr_t cx = (uintptr_t)girara_list_nth(xs, idx);
+    double y           = ufloor(rect->y1);
+    for (size_t inner_idx = 0; inner_idx != girara_list_size(ys); ++inner_idx) {
+      const uintptr_t cy     = (uintptr_t)girara_list_nth(ys, inner_idx);
+      zathura_rectangle_t* r = g_try_malloc(sizeof(zathura_rectangle_t));
+
+      *r = (zathura_rectangle_t){x, y, cx, cy};
+      y  = cy;
+      if (list_append_unique(rectangles, cmp_rectangle, r) == false) {
+        g_free(r);
+      }
+    }
+    x = cx;
+  }
+}
+
+static girara_list_t* flatten_rectangles_reference(girara_list_t* rectangles) {
+  girara_list_t* new_rectangles   = girara_list_new_with_free(g_free);
+  g_autoptr(girara_list_t) points = girara_list_new_with_free(g_free);
+  girara_list_foreach(rectangles, rectangle_to_points, points);
+
+  for (size_t idx = 0; idx != girara_list_size(rectangles); ++idx) {
+    const zathura_rectangle_t* r = girara_list_nth(rectangles, idx);
+    cut_rectangle(r, points, new_rectangles);
+  }
+  return new_rectangles;
+}
+
+
+static girara_list_t* random_rectangles(unsigned int n) {
+  girara_list_t* rectangles = girara_list_new_with_free(g_free);
+  for (unsigned int idx = 0; idx < n; ++idx) {
+    zathura_rectangle_t* r = g_new(zathura_rectangle_t, 1);
+    if (idx > 0 && g_test_rand_int_range(0, 20) == 0) {
+      /* duplicated rectangles */
+      *r = *(zathura_rectangle_t*)girara_list_nth(rectangles, g_test_rand_int_range(0, idx));
+    } else {
+      /* lines of text, partly overlapping */
+      r->x1 = g_test_rand_double_range(0, 500);
+      r->y1 = g_test_rand_double_range(0, 800);
+      r->x2 = r->x1 + g_test_rand_double_range(0, 200);
+      r->y2 = r->y1 + g_test_rand_double_range(0, 30);
+    }
+    girara_list_append(rectangles, r);
+  }
+
+  return rectangles;
+}
+
+static void assert_same_rectangles(girara_list_t* expected, girara_list_t* actual) {
+  g_assert_cmpuint(girara_list_size(actual), ==, girara_list_size(expected));
+  for (size_t idx = 0; idx != girara_list_size(expected); ++idx) {
+    const zathura_rectangle_t* e = girara_list_nth(expected, idx);
+    const zathura_rectangle_t* a = girara_list_nth(actual, idx);
+    g_assert_cmpfloat(a->x1, ==, e->x1);
+    g_assert_cmpfloat(a->y1, ==, e->y1);
+    g_assert_cmpfloat(a->x2, ==, e->x2);
+    g_assert_cmpfloat(a->y2, ==, e->y2);
+  }
+}
+
+static void test_flatten_rectangles(void) {
+  g_autoptr(girara_list_t) empty     = girara_list_new_with_free(g_free);
+  g_autoptr(girara_list_t) flattened = flatten_rectangles(empty);
+  g_assert_cmpuint(girara_list_size(flattened), ==, 0);
+
+  for (unsigned int round = 0; round < 100; ++round) {
+    g_autoptr(girara_list_t) rectangles = random_rectangles(g_test_rand_int_range(1, 25));
+    g_autoptr(girara_list_t) expected   = flatten_rectangles_reference(rectangles);
+    g_autoptr(girara_list_t) actual     = flatten_rectangles(rectangles);
+    assert_same_rectangles(expected, actual);
+  }
+}
+
+static void test_flatten_rectangles_perf(void) {
+  g_autoptr(girara_list_t) rectangles = random_rectangles(100);
+
+  g_test_timer_start();
+  g_autoptr(girara_list_t) expected = flatten_rectangles_reference(rectangles);
+  const double reference            = g_test_timer_elapsed();
+
+  g_test_timer_start();
+  g_autoptr(girara_list_t) actual = flatten_rectangles(rectangles);
+  const double elapsed            = g_test_timer_elapsed();
+
+  assert_same_rectangles(expected, actual);
+  g_test_minimized_result(elapsed, "flatten_rectangles: %gs, reference: %gs", elapsed, reference);
+}
+
 int main(int argc, char* argv[]) {
   g_test_init(&argc, &argv, NULL);
   g_test_add_func("/utils/file_valid_extension", test_file_valid_extension);
+  g_test_add_func("/utils/flatten_rectangles", test_flatten_rectangles);
+  if (g_test_perf() == TRUE) {
+    g_test_add_func("/utils/flatten_rectangles_perf", test_flatten_rectangles_perf);
+  }
   return g_test_run();
 }
@@ -5,17 +5,12 @@
 #include <math.h>
 
 #include "document-widget.h"
+#include "internal.h"
 #include "page.h"
 #include "zathura.h"
 
-double page_calc_height_width(zathura_document_t* document, zathura_page_t* page, unsigned int* page_height,
-                              unsigned int* page_width, bool rotate) {
-  g_return_val_if_fail(document != NULL && page_height != NULL && page_width != NULL, 0.0);
-
-  const double zoom   = zathura_page_get_zoom(page);
-  const double height = zathura_page_get_height(page);
-  const double width  = zathura_page_get_width(page);
-
+static double calc_height_width(zathura_document_t* document, double width, double height, double zoom,
+                                unsigned int* page_height, unsigned int* page_width, bool rotate) {
   double scale = zoom * zathura_document_get_scale(document);
 
   if (rotate == true && zathura_document_get_rotation(document) % 180 != 0) {
@@ -31,6 +26,29 @@ double page_calc_height_width(zathura_document_t* document, zathura_page_t* page
   return scale;
 }
 
+double page_calc_height_width(zathura_document_t* document, zathura_page_t* page, unsigned int* page_height,
+                              unsigned int* page_width, bool rotate) {
+  g_return_val_if_fail(document != NULL && page_height != NULL && page_width != NULL, 0.0);
+
+  const double zoom   = zathura_page_get_zoom(page);
+  const double height = zathura_page_get_height(page);
+  const double width  = zathura_page_get_width(page);
+
+  return calc_height_width(document, width, height, zoom, page_height, page_width, rotate);
+}
+
+double page_calc_height_width_estimate(zathura_document_t* document, unsigned int* page_height,
+                                       unsigned int* page_width, bool rotate) {
+  g_return_val_if_fail(document != NULL && page_height != NULL && page_width != NULL, 0.0);
+
+  double width  = 0;
+  double height = 0;
+  zathura_document_get_page_size_estimate(document, &width, &height);
+
+  /* pages that were not created yet have not been zoomed */
+  return calc_height_width(document, width, height, 1.0, page_height, page_width, rotate);
+}
+
 void page_calc_position(zathura_document_t* document, double x, double y, double* xn, double* yn) {
   g_return_if_fail(document != NULL && xn != NULL && yn != NULL);
 
@@ -58,43 +76,10 @@ unsigned int position_to_page_number(zathura_t* zathura, double pos_x, double po
 
   ZathuraDocumentWidget* doc_widget = ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget);
 
-  unsigned int doc_width, doc_height;
+  unsigned int doc_width = 0, doc_height = 0;
   zathura_document_widget_get_document_size(doc_widget, &doc_height, &doc_width);
 
-  unsigned int c0   = zathura_document_widget_get_first_page_column(doc_widget);
-  unsigned int npag = zathura_document_get_number_of_pages(document);
-  unsigned int ncol = zathura_document_widget_get_pages_per_row(doc_widget);
-  unsigned int nrow = (npag + c0 - 1 + ncol - 1) / ncol;
-
-  // This could be done using binary search if linear is too slow
-  unsigned int row = 0;
-  for (unsigned int i = 0; i < nrow; i++) {
-    unsigned int row_pos, row_height;
-    zathura_document_widget_get_row(doc_widget, i, &row_pos, &row_height);
-
-    if (pos_y * doc_height <= row_pos + row_height) {
-      row = i;
-      break;
-    }
-  }
-
-  unsigned int col = 0;
-  for (unsigned int i = 0; i < ncol; i++) {
-    unsigned int col_pos, col_width;
-    zathura_document_widget_get_col(doc_widget, i, &col_pos, &col_width);
-
-    if (pos_x * doc_width <= col_pos + col_width) {
-      col = i;
-      break;
-    }
-  }
-
-  unsigned int page = ncol * (row % nrow) + (col % ncol);
-  if (page < c0 - 1) {
-    return 0;
-  } else {
-    return MIN(page - (c0 - 1), npag - 1);
-  }
+  return zathura_document_widget_get_page_at(doc_widget, pos_x * doc_width, pos_y * doc_height);
 }
 
 void page_number_to_position(zathura_t* zathura, unsigned int page_number, double xalign, double yalign, double* pos_x,
@@ -22,6 +22,19 @@
 double page_calc_height_width(zathura_document_t* document, zathura_page_t* page, unsigned int* page_height,
                               unsigned int* page_width, bool rotate);
 
+/**
+ * Calculate the size of a page whose page object was not created yet from the
+ * estimated page size, see page_calc_height_width.
+ *
+ * @param document the document
+ * @param page_height the scaled and rotated height
+ * @param page_width the scaled and rotated width
+ * @param rotate honor page's rotation
+ * @return real scale after rounding
+ */
+double page_calc_height_width_estimate(zathura_document_t* document, unsigned int* page_height,
+                                       unsigned int* page_width, bool rotate);
+
 /**
  * Calculate a page relative position after a rotation. The positions x y are
  * relative to a page, i.e. 0=top of page, 1=bottom of page. They are NOT
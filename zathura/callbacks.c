@@ -49,54 +49,179 @@ void cb_buffer_changed(girara_session_t* session) {
   }
 }
 
+static void update_visible_page(zathura_t* zathura, unsigned int page_id, unsigned int number_of_pages,
+                                unsigned int pages_per_row) {
+  zathura_document_t* document = zathura_get_document(zathura);
+  zathura_page_t* page         = zathura_document_get_page(document, page_id);
+  GtkWidget* page_widget       = zathura_page_acquire_widget(zathura, page_id);
+  if (page_widget == NULL) {
+    return;
+  }
+  ZathuraPageWidget* zathura_page_widget = ZATHURA_PAGE_WIDGET(page_widget);
+
+  // make page visible
+  if (zathura_page_get_visibility(page) == false) {
+    zathura_page_set_visibility(page, true);
+    zathura_renderer_page_cache_add(zathura->sync.render_thread, zathura_page_get_index(page));
+  }
+
+  // keep adjacent pages rendered so scrolling lands on ready content
+  // consider pages_per_row pages before and after, with the more recents ones close to the page itself
+  for (unsigned int i = pages_per_row; i; --i) {
+    GtkWidget* before = page_id >= i ? zathura_page_get_widget_by_number(zathura, page_id - i) : NULL;
+    if (before != NULL) {
+      zathura_page_widget_update_view_time(ZATHURA_PAGE_WIDGET(before));
+    }
+    GtkWidget* after = page_id + i < number_of_pages ? zathura_page_get_widget_by_number(zathura, page_id + i) : NULL;
+    if (after != NULL) {
+      zathura_page_widget_update_view_time(ZATHURA_PAGE_WIDGET(after));
+    }
+  }
+
+  zathura_page_widget_update_view_time(zathura_page_widget);
+}
+
+static void update_invisible_page(zathura_t* zathura, unsigned int page_id) {
+  zathura_document_t* document = zathura_get_document(zathura);
+  zathura_page_t* page         = zathura_document_get_page(document, page_id);
+  if (page == NULL) {
+    return;
+  }
+
+  /* invisible pages far from the viewport might not have a widget */
+  GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+
+  /* make page invisible */
+  if (zathura_page_get_visibility(page) == true) {
+    zathura_page_set_visibility(page, false);
+    /* If a page becomes invisible, abort the render request. */
+    if (page_widget != NULL) {
+      zathura_page_widget_abort_render_request(ZATHURA_PAGE_WIDGET(page_widget));
+    }
+  }
+}
+
 void update_visible_pages(zathura_t* zathura) {
   zathura_document_t* document       = zathura_get_document(zathura);
+  ZathuraDocumentWidget* doc_widget  = ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget);
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
-  const unsigned int pages_per_row   = zathura_document_widget_get_pages_per_row(zathura->ui.document_widget);
+  const unsigned int pages_per_row   = zathura_document_widget_get_pages_per_row(doc_widget);
+
+  /* only the rows intersecting the viewport can contain visible pages */
+  unsigned int doc_height = 0, doc_width = 0;
+  zathura_document_widget_get_document_size(doc_widget, &doc_height, &doc_width);
+  unsigned int view_height = 0, view_width = 0;
+  zathura_document_get_viewport_size(document, &view_height, &view_width);
+
+  const double center = zathura_document_get_position_y(document) * doc_height;
+  unsigned int first  = 0;
+  unsigned int last   = 0;
+  if (zathura_document_widget_get_page_range(doc_widget, floor(center - 0.5 * view_height),
+                                             ceil(center + 0.5 * view_height), &first, &last) == false) {
+    return;
+  }
 
-  for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
-    zathura_page_t* page                   = zathura_document_get_page(document, page_id);
-    GtkWidget* page_widget                 = zathura_page_get_widget(zathura, page);
-    ZathuraPageWidget* zathura_page_widget = ZATHURA_PAGE_WIDGET(page_widget);
+  /* pages that left the range become invisible, all others outside of it already are */
+  if (zathura->global.visible_pages.valid == true) {
+    const unsigned int old_last = MIN(zathura->global.visible_pages.last, number_of_pages - 1);
+    for (unsigned int page_id = zathura->global.visible_pages.first; page_id <= old_last; page_id++) {
+      if (page_id < first || page_id > last) {
+        update_invisible_page(zathura, page_id);
+      }
+    }
+  }
 
+  for (unsigned int page_id = first; page_id <= last; page_id++) {
     if (page_is_visible(zathura, page_id) == true) {
-      // make page visible
-      if (zathura_page_get_visibility(page) == false) {
-        zathura_page_set_visibility(page, true);
-        zathura_renderer_page_cache_add(zathura->sync.render_thread, zathura_page_get_index(page));
-      }
+      update_visible_page(zathura, page_id, number_of_pages, pages_per_row);
+    } else {
+      update_invisible_page(zathura, page_id);
+    }
+  }
 
-      // keep adjacent pages rendered so scrolling lands on ready content
-      // consider pages_per_row pages before and after, with the more recents ones close to the page itself
-      for (unsigned int i = pages_per_row; i; --i) {
-        if (page_id >= i) {
-          zathura_page_widget_update_view_time(
-              ZATHURA_PAGE_WIDGET(zathura_page_get_widget_by_number(zathura, page_id - i)));
-        }
-        if (page_id + i < number_of_pages) {
-          zathura_page_widget_update_view_time(
-              ZATHURA_PAGE_WIDGET(zathura_page_get_widget_by_number(zathura, page_id + i)));
-        }
-      }
+  zathura->global.visible_pages.first = first;
+  zathura->global.visible_pages.last  = last;
+  zathura->global.visible_pages.valid = true;
+}
 
-      zathura_page_widget_update_view_time(zathura_page_widget);
-    } else {
-      /* make page invisible */
-      if (zathura_page_get_visibility(page) == true) {
-        zathura_page_set_visibility(page, false);
-        /* If a page becomes invisible, abort the render request. */
-        zathura_page_widget_abort_render_request(zathura_page_widget);
-      }
+/* renders the pages the view is scrolled towards before they become visible */
+static void update_prefetch_pages(zathura_t* zathura) {
+  zathura_document_t* document      = zathura_get_document(zathura);
+  ZathuraDocumentWidget* doc_widget = ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget);
+
+  unsigned int doc_height = 0, doc_width = 0;
+  zathura_document_widget_get_document_size(doc_widget, &doc_height, &doc_width);
+  unsigned int view_height = 0, view_width = 0;
+  zathura_document_get_viewport_size(document, &view_height, &view_width);
 
-      /* reset current search result */
-      girara_list_t* results   = NULL;
-      GObject* obj_page_widget = G_OBJECT(page_widget);
-      g_object_get(obj_page_widget, "search-results", &results, NULL);
-      if (results != NULL) {
-        g_object_set(obj_page_widget, "search-current", 0, NULL);
+  const double view_top = zathura_document_get_position_y(document) * doc_height - 0.5 * view_height;
+  zathura_prefetch_update(&zathura->global.prefetch.tracker, view_top, doc_height, g_get_monotonic_time());
+
+  /* the page cache has to hold the visible pages as well */
+  size_t budget = 0;
+  if (zathura->global.visible_pages.valid == true) {
+    zathura_page_cache_stats_t stats;
+    zathura_renderer_page_cache_get_stats(zathura->sync.render_thread, &stats);
+
+    const size_t visible = zathura->global.visible_pages.last - zathura->global.visible_pages.first + 1;
+    size_t capacity      = stats.max_pages;
+    if (stats.max_bytes != 0 && stats.pages != 0 && stats.bytes != 0) {
+      const size_t max_bytes = stats.max_bytes - MIN(stats.tile_bytes, stats.max_bytes);
+      capacity               = MIN(capacity, max_bytes / (stats.bytes / stats.pages));
+    }
+    budget = capacity > visible ? capacity - visible : 0;
+  }
+
+  unsigned int screens = 0;
+  girara_setting_get(zathura->ui.session, "render-prefetch", &screens);
+
+  double top         = 0;
+  double bottom      = 0;
+  unsigned int first = 0;
+  unsigned int last  = 0;
+  const bool prefetch =
+      budget > 0 &&
+      zathura_prefetch_get_range(&zathura->global.prefetch.tracker, view_top, view_height, screens, &top, &bottom) ==
+          true &&
+      zathura_document_widget_get_page_range(doc_widget, floor(top), ceil(bottom), &first, &last) == true;
+
+  /* pending renders of pages that are no longer ahead are dropped, rendered pages stay in the cache */
+  if (zathura->global.prefetch.valid == true) {
+    for (unsigned int page_id = zathura->global.prefetch.first; page_id <= zathura->global.prefetch.last; page_id++) {
+      GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+      zathura_page_t* page   = zathura_document_get_page(document, page_id);
+      if (page_widget != NULL && page != NULL && zathura_page_get_visibility(page) == false &&
+          (prefetch == false || page_id < first || page_id > last)) {
+        zathura_page_widget_abort_render_request(ZATHURA_PAGE_WIDGET(page_widget));
       }
     }
   }
+
+  zathura->global.prefetch.valid = prefetch;
+  if (prefetch == false) {
+    return;
+  }
+  zathura->global.prefetch.first = first;
+  zathura->global.prefetch.last  = last;
+
+  /* pages closer to the viewport are rendered first, but after all visible
+   * pages, and they are evicted from the page cache before the visible pages */
+  const bool forward = zathura->global.prefetch.tracker.velocity > 0;
+  const gint64 now   = g_get_real_time();
+  size_t rank        = 0;
+  for (unsigned int idx = 0; idx <= last - first && rank < budget; idx++) {
+    const unsigned int page_id = forward == true ? first + idx : last - idx;
+    zathura_page_t* page       = zathura_document_get_page(document, page_id);
+    if (page == NULL || zathura_page_get_visibility(page) == true) {
+      continue;
+    }
+
+    /* prefetched pages are kept in the page cache, so they need a widget */
+    GtkWidget* page_widget = zathura_page_acquire_widget(zathura, page_id);
+    if (page_widget != NULL) {
+      zathura_page_widget_prefetch(ZATHURA_PAGE_WIDGET(page_widget), now - (gint64)++rank);
+    }
+  }
 }
 
 void cb_view_hadjustment_value_changed(GtkAdjustment* adjustment, gpointer data) {
@@ -146,6 +271,7 @@ void cb_view_vadjustment_value_changed(GtkAdjustment* adjustment, gpointer data)
   zathura_document_set_position_y(document, position_y);
   zathura_document_set_current_page_number(document, page_id);
 
+  update_prefetch_pages(zathura);
   statusbar_page_number_update(zathura);
 }
 
@@ -409,8 +535,10 @@ static gboolean handle_link(GtkEntry* entry, girara_session_t* session, zathura_
     if (page == NULL || zathura_page_get_visibility(page) == false) {
       continue;
     }
-    GtkWidget* page_widget = zathura_page_get_widget(zathura, page);
-    link                   = zathura_page_widget_link_get(ZATHURA_PAGE_WIDGET(page_widget), index);
+    GtkWidget* page_widget = zathura_page_acquire_widget(zathura, page_id);
+    if (page_widget != NULL) {
+      link = zathura_page_widget_link_get(ZATHURA_PAGE_WIDGET(page_widget), index);
+    }
   }
 
   if (link == NULL) {
@@ -778,12 +906,11 @@ void cb_hide_links(GtkWidget* widget, gpointer data) {
   zathura_document_t* document = zathura_get_document(zathura);
   unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
   for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
-    zathura_page_t* page = zathura_document_get_page(document, page_id);
-    if (page == NULL) {
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+    if (page_widget == NULL) {
       continue;
     }
 
-    GtkWidget* page_widget = zathura_page_get_widget(zathura, page);
     g_object_set(G_OBJECT(page_widget), "draw-links", FALSE, NULL);
   }
 }
@@ -240,14 +240,10 @@ bool cmd_info(girara_session_t* session, girara_list_t* UNUSED(argument_list)) {
       {_("Other"), ZATHURA_DOCUMENT_INFORMATION_OTHER},
   };
 
-  girara_list_t* information = zathura_document_get_information(zathura_get_document(zathura), NULL);
-  if (information == NULL) {
-    girara_notify(session, GIRARA_INFO, _("No information available."));
-    return false;
-  }
+  g_autoptr(girara_list_t) information = zathura_document_get_information(zathura_get_document(zathura), NULL);
 
   g_autoptr(GString) string = g_string_new(NULL);
-  for (size_t i = 0; i < LENGTH(meta_fields); i++) {
+  for (size_t i = 0; information != NULL && i < LENGTH(meta_fields); i++) {
     for (size_t idx = 0; idx != girara_list_size(information); ++idx) {
       zathura_document_information_entry_t* entry = girara_list_nth(information, idx);
       if (entry != NULL && meta_fields[i].field == entry->type) {
@@ -257,13 +253,28 @@ bool cmd_info(girara_session_t* session, girara_list_t* UNUSED(argument_list)) {
     }
   }
 
-  if (string->len > 0) {
-    g_string_erase(string, string->len - 1, 1);
-    girara_notify(session, GIRARA_INFO, "%s", string->str);
-  } else {
-    girara_notify(session, GIRARA_INFO, _("No information available."));
+  /* the statistics are shown in addition to the document information */
+  if (string->len == 0) {
+    g_string_append_printf(string, "%s\n", _("No information available."));
+  }
+
+  if (zathura->sync.render_thread != NULL) {
+    zathura_page_cache_stats_t stats;
+    zathura_renderer_page_cache_get_stats(zathura->sync.render_thread, &stats);
+
+    g_autofree char* bytes = g_format_size(stats.bytes);
+    g_string_append_printf(string, _("<b>Page cache:</b> %zu pages (%s), %zu hits, %zu misses, %zu evictions\n"),
+                           stats.pages, bytes, stats.hits, stats.misses, stats.evictions);
+
+    zathura_render_stats_t render_stats;
+    zathura_renderer_get_render_stats(zathura->sync.render_thread, &render_stats);
+    g_string_append_printf(string, _("<b>Render jobs:</b> %zu executed, %zu coalesced\n"), render_stats.executed,
+                           render_stats.coalesced);
   }
 
+  g_string_erase(string, string->len - 1, 1);
+  girara_notify(session, GIRARA_INFO, "%s", string->str);
+
   return false;
 }
 
@@ -409,73 +420,19 @@ bool cmd_search(girara_session_t* session, const char* input, girara_argument_t*
     return false;
   }
 
-  zathura_error_t error = ZATHURA_ERROR_OK;
-
   /* set search direction */
   zathura->global.search_direction = argument->n;
 
-  unsigned int number_of_pages     = zathura_document_get_number_of_pages(document);
-  unsigned int current_page_number = zathura_document_get_current_page_number(document);
-
-  zathura->global.total_search_results  = 0;
-  zathura->global.current_search_result = 0;
-
-  /* reset search highlighting */
-  bool nohlsearch = false;
-  girara_setting_get(session, "nohlsearch", &nohlsearch);
-
-  /* search pages */
-  for (unsigned int page_id = 0; page_id < number_of_pages; ++page_id) {
-    unsigned int index   = (page_id + current_page_number) % number_of_pages;
-    zathura_page_t* page = zathura_document_get_page(document, index);
-    if (page == NULL) {
-      continue;
-    }
-
-    GtkWidget* page_widget   = zathura_page_get_widget(zathura, page);
-    GObject* obj_page_widget = G_OBJECT(page_widget);
-    g_object_set(obj_page_widget, "draw-links", FALSE, NULL);
-
-    zathura_renderer_lock(zathura->sync.render_thread);
-    girara_list_t* result = zathura_page_search_text(page, input, &error);
-    zathura_renderer_unlock(zathura->sync.render_thread);
-
-    if (result == NULL || girara_list_size(result) == 0) {
-      girara_list_free(result);
-      g_object_set(obj_page_widget, "search-results", NULL, NULL);
-
-      if (error == ZATHURA_ERROR_NOT_IMPLEMENTED) {
-        break;
-      } else {
-        continue;
-      }
-    }
-
-    g_object_set(obj_page_widget, "search-results", result, NULL);
-
-    if (argument->n == BACKWARD) {
-      /* start at bottom hit in page */
-      g_object_set(obj_page_widget, "search-current", girara_list_size(result) - 1, NULL);
-    } else {
-      g_object_set(obj_page_widget, "search-current", 0, NULL);
-    }
-
-    zathura->global.total_search_results += girara_list_size(result);
-  }
-
-  g_autofree girara_argument_t* arg = g_try_malloc0(sizeof(girara_argument_t));
-  if (arg == NULL) {
-    return false;
-  }
-
   bool inc_search = false;
   girara_setting_get(session, "incremental-search", &inc_search);
 
-  arg->n    = FORWARD;
-  arg->data = (void*)input;
-  search_document(zathura, arg, inc_search);
+  /* a new query replaces the running search, but may narrow down its pages */
+  zathura_search_t* previous = zathura->sync.search;
+  zathura_search_cancel(previous);
+  zathura->sync.search = zathura_search_new(zathura, input, argument->n, inc_search, previous);
+  zathura_search_free(previous);
 
-  return true;
+  return zathura->sync.search != NULL;
 }
 
 bool cmd_export(girara_session_t* session, girara_list_t* argument_list) {
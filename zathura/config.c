@@ -187,6 +187,32 @@ static void cb_show_signature_info(girara_session_t* session, const char* UNUSED
   update_visible_pages(zathura);
 }
 
+static void cb_incremental_reload_changed(girara_session_t* session, const char* UNUSED(name),
+                                         girara_setting_type_t UNUSED(type), const void* value, void* UNUSED(data)) {
+  g_return_if_fail(value != NULL);
+  g_return_if_fail(session != NULL);
+  g_return_if_fail(session->global.data != NULL);
+  zathura_t* zathura = session->global.data;
+
+  /* pages that are already rendered are fingerprinted when they are rendered again */
+  if (zathura->sync.render_thread != NULL) {
+    zathura_renderer_enable_fingerprints(zathura->sync.render_thread, *(const bool*)value);
+  }
+}
+
+static void cb_filemonitor_quiet_period_changed(girara_session_t* session, const char* UNUSED(name),
+                                                girara_setting_type_t UNUSED(type), const void* value,
+                                                void* UNUSED(data)) {
+  g_return_if_fail(value != NULL);
+  g_return_if_fail(session != NULL);
+  g_return_if_fail(session->global.data != NULL);
+  zathura_t* zathura = session->global.data;
+
+  if (zathura->file_monitor.monitor != NULL) {
+    g_object_set(zathura->file_monitor.monitor, "quiet-period", *(const unsigned int*)value, NULL);
+  }
+}
+
 static void cb_setting_recolor_adjust_lightness_change(girara_session_t* session, const char* name,
                                                        girara_setting_type_t UNUSED(type), const void* value,
                                                        void* UNUSED(data)) {
@@ -497,6 +523,8 @@ void config_load_default(zathura_t* zathura) {
 
   girara_setting_add(gsession, "database",              DEFAULT_DB,   STRING, true,  _("Database backend"),         NULL, NULL);
   girara_setting_add(gsession, "filemonitor",           "glib",       STRING, true,  _("File monitor backend"),     NULL, NULL);
+  uint_value = ZATHURA_FILEMONITOR_DEFAULT_QUIET_PERIOD;
+  girara_setting_add(gsession, "filemonitor-quiet-period", &uint_value, UINT,   true,  _("Time in milliseconds the file has to stay unchanged before it is reloaded"), cb_filemonitor_quiet_period_changed, NULL);
   uint_value = 10;
   girara_setting_add(gsession, "zoom-step",             &uint_value,  UINT,   false, _("Zoom step"),                NULL, NULL);
   int_value = 1;
@@ -520,8 +548,16 @@ void config_load_default(zathura_t* zathura) {
   girara_setting_add(gsession, "zoom-max",              &uint_value,  UINT,   false, _("Zoom maximum"), NULL, NULL);
   uint_value = ZATHURA_PAGE_CACHE_DEFAULT_SIZE;
   girara_setting_add(gsession, "page-cache-size",       &uint_value,  UINT,   true,  _("Maximum number of pages to keep in the cache"), NULL, NULL);
+  uint_value = ZATHURA_PAGE_CACHE_DEFAULT_MEMORY;
+  girara_setting_add(gsession, "page-cache-memory",     &uint_value,  UINT,   true,  _("Maximum size in MiB of the pages kept in the cache"), NULL, NULL);
   uint_value = ZATHURA_PAGE_THUMBNAIL_DEFAULT_SIZE;
   girara_setting_add(gsession, "page-thumbnail-size",   &uint_value,  UINT,   true,  _("Maximum size in pixels of thumbnails to keep in the cache"), NULL, NULL);
+  uint_value = 64;
+  girara_setting_add(gsession, "text-index-cache-size", &uint_value,  UINT,   false, _("Maximum size in MiB of the text kept in the cache directory"), NULL, NULL);
+  uint_value = 1;
+  girara_setting_add(gsession, "render-threads",        &uint_value,  UINT,   true,  _("Number of threads used for rendering pages"), NULL, NULL);
+  uint_value = 2;
+  girara_setting_add(gsession, "render-prefetch",       &uint_value,  UINT,   false, _("Maximum number of screens to render ahead while scrolling"), NULL, NULL);
   uint_value = 2000;
   girara_setting_add(gsession, "jumplist-size",         &uint_value,  UINT,   false, _("Number of positions to remember in the jumplist"), cb_jumplist_change, NULL);
   girara_setting_add(gsession, "recolor-darkcolor",     "#FFFFFF",    STRING, false, _("Recoloring (dark color)"), cb_color_change, NULL);
@@ -561,6 +597,10 @@ void config_load_default(zathura_t* zathura) {
   girara_setting_add(gsession, "search-hadjust",             &bool_value,  BOOLEAN, false, _("Center result horizontally"), NULL, NULL);
   bool_value = true;
   girara_setting_add(gsession, "render-loading",             &bool_value,  BOOLEAN, false, _("Render 'Loading ...'"), NULL, NULL);
+  bool_value = true;
+  girara_setting_add(gsession, "render-preview",             &bool_value,  BOOLEAN, false, _("Render a low resolution preview before the page"), NULL, NULL);
+  bool_value = false;
+  girara_setting_add(gsession, "incremental-reload",         &bool_value,  BOOLEAN, false, _("Only render the pages that changed when reloading the document"), cb_incremental_reload_changed, NULL);
   girara_setting_add(gsession, "adjust-open",                "best-fit",   STRING,  false, _("Adjust to when opening file"), NULL, NULL);
   bool_value = false;
   girara_setting_add(gsession, "show-hidden",                &bool_value,  BOOLEAN, false, _("Show hidden files and directories"), NULL, NULL);
@@ -579,6 +619,8 @@ void config_load_default(zathura_t* zathura) {
   bool_value = true;
   girara_setting_add(gsession, "abort-clear-search",         &bool_value,  BOOLEAN, false, _("Clear search results on abort"), NULL, NULL);
   bool_value = false;
+  girara_setting_add(gsession, "text-index-cache",           &bool_value,  BOOLEAN, false, _("Keep the text extracted for searches in the cache directory"), NULL, NULL);
+  bool_value = false;
   girara_setting_add(gsession, "window-title-basename",      &bool_value,  BOOLEAN, false, _("Use basename of the file in the window title"), cb_window_statbusbar_changed, NULL);
   bool_value = false;
   girara_setting_add(gsession, "window-title-home-tilde",    &bool_value,  BOOLEAN, false, _("Use ~ instead of $HOME in the filename in the window title"), cb_window_statbusbar_changed, NULL);
@@ -11,7 +11,8 @@
 #include "macros.h"
 
 struct zathura_content_type_context_s {
-  magic_t magic;
+  magic_t magic; /**< libmagic cookie */
+  GMutex mutex;  /**< Serializes guesses, libmagic cookies are not thread-safe */
 };
 
 static int list_cmpstr(const void* lhs, const void* rhs) {
@@ -23,6 +24,7 @@ zathura_content_type_context_t* zathura_content_type_new(void) {
   if (context == NULL) {
     return NULL;
   }
+  g_mutex_init(&context->mutex);
 
   /* create magic cookie */
   static const int flags = MAGIC_ERROR | MAGIC_MIME_TYPE | MAGIC_SYMLINK | MAGIC_NO_CHECK_APPTYPE | MAGIC_NO_CHECK_CDF |
@@ -45,10 +47,15 @@ zathura_content_type_context_t* zathura_content_type_new(void) {
 }
 
 void zathura_content_type_free(zathura_content_type_context_t* context) {
-  if (context != NULL && context->magic != NULL) {
+  if (context == NULL) {
+    return;
+  }
+
+  if (context->magic != NULL) {
     magic_close(context->magic);
   }
 
+  g_mutex_clear(&context->mutex);
   g_free(context);
 }
 
@@ -116,7 +123,13 @@ static char* guess_type_glib(const char* path) {
 char* zathura_content_type_guess(zathura_content_type_context_t* context, const char* path,
                                  const girara_list_t* supported_content_types) {
   /* try libmagic first */
+  if (context != NULL) {
+    g_mutex_lock(&context->mutex);
+  }
   char* content_type = guess_type_magic(context, path);
+  if (context != NULL) {
+    g_mutex_unlock(&context->mutex);
+  }
   if (content_type != NULL) {
     if (supported_content_types == NULL ||
         girara_list_find(supported_content_types, list_cmpstr, content_type) != NULL) {
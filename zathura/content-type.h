@@ -23,8 +23,9 @@ void zathura_content_type_free(zathura_content_type_context_t* context);
 
 /**
  * "Guess" the content type of a file. Various methods are tried depending on
- * the available libraries.
+ * the available libraries. The context may be shared between threads.
  *
+ * @param context The context.
  * @param path file name
  * @return content type of path, needs to freeed with g_free.
  */
@@ -41,6 +41,18 @@ static bool get_fileinfo(zathura_database_t* GIRARA_UNUSED(db), const char* GIRA
   return false;
 }
 
+static bool set_file_hash(zathura_database_t* GIRARA_UNUSED(db), const char* GIRARA_UNUSED(file),
+                          const zathura_file_identity_t* GIRARA_UNUSED(identity),
+                          const uint8_t* GIRARA_UNUSED(hash_sha256)) {
+  return true;
+}
+
+static bool get_file_hash(zathura_database_t* GIRARA_UNUSED(db), const char* GIRARA_UNUSED(file),
+                          const zathura_file_identity_t* GIRARA_UNUSED(identity),
+                          uint8_t* GIRARA_UNUSED(hash_sha256)) {
+  return false;
+}
+
 static void io_append(GiraraInputHistoryIO* GIRARA_UNUSED(db), const char* GIRARA_UNUSED(input)) {}
 
 static girara_list_t* io_read(GiraraInputHistoryIO* GIRARA_UNUSED(db)) {
@@ -61,6 +73,8 @@ static void db_interface_init(ZathuraDatabaseInterface* iface) {
   iface->save_jumplist    = save_list;
   iface->set_fileinfo     = set_fileinfo;
   iface->get_fileinfo     = get_fileinfo;
+  iface->set_file_hash    = set_file_hash;
+  iface->get_file_hash    = get_file_hash;
   iface->get_recent_files = get_recent_files;
   iface->load_quickmarks  = load_list;
   iface->save_quickmarks  = save_list;
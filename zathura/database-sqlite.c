@@ -12,7 +12,7 @@
 #include "utils.h"
 
 /* version of the database layout */
-#define DATABASE_VERSION 3
+#define DATABASE_VERSION 4
 
 static char* sqlite3_column_text_dup(sqlite3_stmt* stmt, int col) {
   return g_strdup((const char*)sqlite3_column_text(stmt, col));
@@ -197,6 +197,17 @@ static void sqlite_db_check_layout(sqlite3* session, const int database_version,
                                           "adjust_mode INTEGER"
                                           ");";
 
+  /* create file hash table */
+  static const char SQL_FILEHASH_INIT[] = "CREATE TABLE IF NOT EXISTS filehash ("
+                                          "file TEXT PRIMARY KEY,"
+                                          "device INTEGER,"
+                                          "inode INTEGER,"
+                                          "size INTEGER,"
+                                          "mtime INTEGER,"
+                                          "sample BLOB,"
+                                          "sha256 BLOB"
+                                          ");";
+
   /* create history table */
   static const char SQL_HISTORY_INIT[] = "CREATE TABLE IF NOT EXISTS history ("
                                          "time TIMESTAMP,"
@@ -207,8 +218,8 @@ static void sqlite_db_check_layout(sqlite3* session, const int database_version,
   static const char QUICKMARKS_INIT[] = "CREATE TABLE IF NOT EXISTS quickmarks (file TEXT, key INTEGER, x FLOAT, y "
                                         "FLOAT, page INTEGER, zoom FLOAT, PRIMARY KEY(file, key));";
 
-  static const char* ALL_INIT[] = {SQL_BOOKMARK_INIT, SQL_JUMPLIST_INIT, SQL_FILEINFO_INIT, SQL_HISTORY_INIT,
-                                   QUICKMARKS_INIT};
+  static const char* ALL_INIT[] = {SQL_BOOKMARK_INIT, SQL_JUMPLIST_INIT, SQL_FILEINFO_INIT, SQL_FILEHASH_INIT,
+                                   SQL_HISTORY_INIT, QUICKMARKS_INIT};
 
   /* update fileinfo table (part 1) */
   static const char SQL_FILEINFO_ALTER[] = "ALTER TABLE fileinfo ADD COLUMN pages_per_row INTEGER;"
@@ -354,7 +365,11 @@ static void sqlite_db_init(ZathuraSQLDatabase* db, const char* path) {
 
   const bool db_exists = g_file_test(path, G_FILE_TEST_EXISTS);
   sqlite3* session     = NULL;
-  if (sqlite3_open(path, &session) != SQLITE_OK) {
+
+  /* documents are opened and hashed on worker threads, so the connection is
+   * shared between threads */
+  if (sqlite3_open_v2(path, &session, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, NULL) !=
+      SQLITE_OK) {
     girara_error("Could not open database: %s\n", path);
     return;
   }
@@ -875,6 +890,79 @@ static girara_list_t* sqlite_io_read(GiraraInputHistoryIO* db) {
   return list;
 }
 
+static bool sqlite_set_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                                 const uint8_t* hash_sha256) {
+  if (db == NULL || file == NULL || identity == NULL || hash_sha256 == NULL) {
+    return false;
+  }
+
+  ZathuraSQLDatabase* sqldb       = ZATHURA_SQLDATABASE(db);
+  ZathuraSQLDatabasePrivate* priv = zathura_sqldatabase_get_instance_private(sqldb);
+
+  static const char SQL_FILEHASH_SET[] =
+      "REPLACE INTO filehash (file, device, inode, size, mtime, sample, sha256) VALUES (?, ?, ?, ?, ?, ?, ?);";
+
+  sqlite3_stmt* stmt = prepare_statement(priv->session, SQL_FILEHASH_SET);
+  if (stmt == NULL) {
+    return false;
+  }
+
+  if (sqlite3_bind_text(stmt, 1, file, -1, SQLITE_STATIC) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 2, identity->device) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 3, identity->inode) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 4, identity->size) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 5, identity->mtime) != SQLITE_OK ||
+      sqlite3_bind_blob(stmt, 6, identity->sample_sha256, 32, SQLITE_STATIC) != SQLITE_OK ||
+      sqlite3_bind_blob(stmt, 7, hash_sha256, 32, SQLITE_STATIC) != SQLITE_OK) {
+    sqlite3_finalize(stmt);
+    girara_error("Failed to bind arguments.");
+    return false;
+  }
+
+  int res = sqlite3_step(stmt);
+  sqlite3_finalize(stmt);
+
+  return (res == SQLITE_DONE) ? true : false;
+}
+
+static bool sqlite_get_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                                 uint8_t* hash_sha256) {
+  if (db == NULL || file == NULL || identity == NULL || hash_sha256 == NULL) {
+    return false;
+  }
+
+  ZathuraSQLDatabase* sqldb       = ZATHURA_SQLDATABASE(db);
+  ZathuraSQLDatabasePrivate* priv = zathura_sqldatabase_get_instance_private(sqldb);
+
+  static const char SQL_FILEHASH_GET[] = "SELECT sha256 FROM filehash WHERE file = ? AND device = ? AND inode = ? AND "
+                                         "size = ? AND mtime = ? AND sample = ?;";
+
+  sqlite3_stmt* stmt = prepare_statement(priv->session, SQL_FILEHASH_GET);
+  if (stmt == NULL) {
+    return false;
+  }
+
+  if (sqlite3_bind_text(stmt, 1, file, -1, SQLITE_STATIC) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 2, identity->device) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 3, identity->inode) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 4, identity->size) != SQLITE_OK ||
+      sqlite3_bind_int64(stmt, 5, identity->mtime) != SQLITE_OK ||
+      sqlite3_bind_blob(stmt, 6, identity->sample_sha256, 32, SQLITE_STATIC) != SQLITE_OK) {
+    sqlite3_finalize(stmt);
+    girara_error("Failed to bind arguments.");
+    return false;
+  }
+
+  bool found = false;
+  if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_bytes(stmt, 0) == 32) {
+    memcpy(hash_sha256, sqlite3_column_blob(stmt, 0), 32);
+    found = true;
+  }
+  sqlite3_finalize(stmt);
+
+  return found;
+}
+
 static girara_list_t* sqlite_get_recent_files(zathura_database_t* db, int max, const char* basepath) {
   static const char SQL_HISTORY_GET[] = "SELECT file FROM fileinfo ORDER BY time DESC LIMIT ?";
   static const char SQL_HISTORY_GET_WITH_BASEPATH[] =
@@ -929,6 +1017,8 @@ static void zathura_database_interface_init(ZathuraDatabaseInterface* iface) {
   iface->save_jumplist    = sqlite_save_jumplist;
   iface->set_fileinfo     = sqlite_set_fileinfo;
   iface->get_fileinfo     = sqlite_get_fileinfo;
+  iface->set_file_hash    = sqlite_set_file_hash;
+  iface->get_file_hash    = sqlite_get_file_hash;
   iface->get_recent_files = sqlite_get_recent_files;
   iface->load_quickmarks  = sqlite_load_quickmarks;
   iface->save_quickmarks  = sqlite_save_quickmarks;
@@ -50,6 +50,20 @@ bool zathura_db_get_fileinfo(zathura_database_t* db, const char* file, const uin
   return ZATHURA_DATABASE_GET_INTERFACE(db)->get_fileinfo(db, file, hash_sha256, file_info);
 }
 
+bool zathura_db_set_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                              const uint8_t* hash_sha256) {
+  g_return_val_if_fail(ZATHURA_IS_DATABASE(db) && file != NULL && identity != NULL && hash_sha256 != NULL, false);
+
+  return ZATHURA_DATABASE_GET_INTERFACE(db)->set_file_hash(db, file, identity, hash_sha256);
+}
+
+bool zathura_db_get_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                              uint8_t* hash_sha256) {
+  g_return_val_if_fail(ZATHURA_IS_DATABASE(db) && file != NULL && identity != NULL && hash_sha256 != NULL, false);
+
+  return ZATHURA_DATABASE_GET_INTERFACE(db)->get_file_hash(db, file, identity, hash_sha256);
+}
+
 girara_list_t* zathura_db_get_recent_files(zathura_database_t* db, int max, const char* basepath) {
   g_return_val_if_fail(ZATHURA_IS_DATABASE(db), NULL);
 
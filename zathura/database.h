@@ -23,6 +23,18 @@ typedef struct zathura_fileinfo_s {
   bool page_right_to_left;
 } zathura_fileinfo_t;
 
+/**
+ * Cheap identity of a file version. It is derived from the file's metadata
+ * and a few sampled blocks and is used to look up the cached full hash.
+ */
+typedef struct zathura_file_identity_s {
+  uint64_t device;           /**< Device containing the file */
+  uint64_t inode;            /**< Inode of the file */
+  int64_t size;              /**< Size in bytes */
+  int64_t mtime;             /**< Modification time in microseconds */
+  uint8_t sample_sha256[32]; /**< SHA256 hash of the sampled blocks */
+} zathura_file_identity_t;
+
 #define ZATHURA_TYPE_DATABASE (zathura_database_get_type())
 #define ZATHURA_DATABASE(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), ZATHURA_TYPE_DATABASE, ZathuraDatabase))
 #define ZATHURA_IS_DATABASE(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), ZATHURA_TYPE_DATABASE))
@@ -52,6 +64,12 @@ struct _ZathuraDatabaseInterface {
   bool (*get_fileinfo)(ZathuraDatabase* db, const char* file, const uint8_t* hash_sha256,
                        zathura_fileinfo_t* file_info);
 
+  bool (*set_file_hash)(ZathuraDatabase* db, const char* file, const zathura_file_identity_t* identity,
+                        const uint8_t* hash_sha256);
+
+  bool (*get_file_hash)(ZathuraDatabase* db, const char* file, const zathura_file_identity_t* identity,
+                        uint8_t* hash_sha256);
+
   girara_list_t* (*get_recent_files)(ZathuraDatabase* db, int max, const char* basepath);
 
   girara_list_t* (*load_quickmarks)(ZathuraDatabase* db, const char* file);
@@ -154,6 +172,31 @@ bool zathura_db_set_fileinfo(zathura_database_t* db, const char* file, const uin
 bool zathura_db_get_fileinfo(zathura_database_t* db, const char* file, const uint8_t* hash_sha256,
                              zathura_fileinfo_t* file_info);
 
+/**
+ * Cache the full hash of a file version in the database.
+ *
+ * @param db The database instance
+ * @param file The file
+ * @param identity The identity of the hashed file version
+ * @param hash_sha256 The file's hash
+ * @return true on success, false otherwise.
+ */
+bool zathura_db_set_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                              const uint8_t* hash_sha256);
+
+/**
+ * Get the cached full hash of a file. The hash is only returned if it was
+ * computed for a file version with the same identity.
+ *
+ * @param db The database instance
+ * @param file The file
+ * @param identity The identity of the current file version
+ * @param hash_sha256 Buffer of 32 bytes receiving the file's hash
+ * @return true if a matching hash was found, false otherwise.
+ */
+bool zathura_db_get_file_hash(zathura_database_t* db, const char* file, const zathura_file_identity_t* identity,
+                              uint8_t* hash_sha256);
+
 /* Get a list of recent files from the database. The most recent file is listed
  * first.
  *
@@ -238,8 +238,8 @@ typedef struct {
 static gboolean synctex_highlight_rects_impl(gpointer ptr) {
   highlights_rect_data_t* data = ptr;
 
-  /* synctex_highlight_rects transfers ownership of each rectangles[i] to the
-   * page widget via g_object_set "search-results"; only free the array. */
+  /* synctex_highlight_rects copies the rectangles into the search results and
+   * frees each rectangles[i]; only free the array. */
   synctex_highlight_rects(data->zathura, data->page, data->rectangles);
 
   g_free(data->rectangles);
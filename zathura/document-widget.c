@@ -6,15 +6,15 @@
 #include <girara/log.h>
 
 #include "adjustment.h"
+#include "grid.h"
+#include "internal.h"
 #include "page-widget.h"
 #include "page.h"
 #include "utils.h"
 #include "zathura.h"
 
-typedef struct {
-  unsigned int pos;
-  unsigned int size;
-} document_widget_line_s;
+/* number of unbound page widgets kept for pages scrolled into view */
+#define PAGE_WIDGET_POOL_SIZE 16
 
 typedef struct zathura_document_widget_private_s {
   zathura_t* zathura;
@@ -22,10 +22,8 @@ typedef struct zathura_document_widget_private_s {
   /* Layout */
   document_widget_mode_t layout_mode;
   gboolean pages_right_to_left;
-  unsigned int nrow;
-  unsigned int ncol;
-  document_widget_line_s* row_heights;
-  document_widget_line_s* col_widths;
+  zathura_grid_t grid;            /**< geometry of the pages, updated by arrange_grid */
+  unsigned int* col_sizes;        /**< size of each column over the rows up to each row, nrow * ncol entries */
   unsigned int pages_per_row;     /**< number of pages in a row */
   unsigned int first_page_column; /**< column of the first page */
   unsigned int page_v_padding;    /**< padding between pages */
@@ -36,6 +34,13 @@ typedef struct zathura_document_widget_private_s {
   GtkAdjustment* vadjustment;
   GtkScrollablePolicy hscroll_policy;
   GtkScrollablePolicy vscroll_policy;
+
+  GHashTable* children;           /**< Page widgets currently added to the document widget */
+  GQueue* pool;                   /**< Hidden page widgets that are not bound to a page */
+  gboolean allocating;            /**< Pages are currently allocated */
+  guint layout_idle;              /**< Source of a pending layout update or 0 */
+  unsigned int layout_first_page; /**< First page whose size changed for the pending layout update */
+  guint bind_idle;                /**< Source of a pending page binding or 0 */
 } ZathuraDocumentWidgetPrivate;
 
 G_DEFINE_TYPE_WITH_CODE(ZathuraDocumentWidget, zathura_document_widget, GTK_TYPE_CONTAINER,
@@ -104,12 +109,16 @@ static void zathura_document_widget_init(ZathuraDocumentWidget* widget) {
 
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(widget);
 
-  priv->zathura     = NULL;
-  priv->layout_mode = DOCUMENT_WIDGET_GRID;
-  priv->nrow        = 0;
-  priv->ncol        = 0;
-  priv->row_heights = NULL;
-  priv->col_widths  = NULL;
+  priv->zathura           = NULL;
+  priv->layout_mode       = DOCUMENT_WIDGET_GRID;
+  priv->grid              = (zathura_grid_t){0};
+  priv->col_sizes         = NULL;
+  priv->children          = g_hash_table_new(g_direct_hash, g_direct_equal);
+  priv->pool              = g_queue_new();
+  priv->allocating        = false;
+  priv->layout_idle       = 0;
+  priv->layout_first_page = G_MAXUINT;
+  priv->bind_idle         = 0;
 }
 
 GtkWidget* zathura_document_widget_new(zathura_t* zathura) {
@@ -151,7 +160,8 @@ static void zathura_document_widget_set_scroll_adjustment(ZathuraDocumentWidget*
     adjustment = gtk_adjustment_new(0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
   }
 
-  g_signal_connect_swapped(adjustment, "value-changed", G_CALLBACK(gtk_widget_queue_allocate), widget);
+  g_signal_connect_swapped(adjustment, "value-changed", G_CALLBACK(zathura_document_widget_bind_pages), widget);
+  g_signal_connect_swapped(adjustment, "changed", G_CALLBACK(zathura_document_widget_bind_pages), widget);
 
   *to_set = g_object_ref_sink(adjustment);
 
@@ -169,7 +179,7 @@ static void zathura_document_widget_set_property(GObject* object, guint prop_id,
     break;
   case PROP_LAYOUT_MODE:
     priv->layout_mode = g_value_get_int(value);
-    gtk_widget_queue_allocate(GTK_WIDGET(document));
+    zathura_document_widget_bind_pages(document);
     break;
   case PROP_PAGES_RIGHT_TO_LEFT:
     priv->pages_right_to_left = g_value_get_boolean(value);
@@ -222,60 +232,66 @@ static void zathura_document_widget_get_property(GObject* object, guint prop_id,
 }
 
 /* drawing */
-static void zathura_document_widget_get_page_position(ZathuraDocumentWidget* document, unsigned int page_index,
-                                                      unsigned int* row, unsigned int* col) {
-  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
-
-  const unsigned int c0   = priv->first_page_column;
-  const unsigned int ncol = priv->pages_per_row;
 
-  *row = (page_index + c0 - 1) / ncol;
-  *col = (page_index + c0 - 1) % ncol;
-}
-
-static void zathura_document_widget_line_prefix_sum(document_widget_line_s* array, unsigned int n, unsigned int pad) {
-  array[0].pos = 0;
-
-  for (unsigned int i = 1; i < n; i++) {
-    array[i].pos = array[i - 1].pos + array[i - 1].size + pad;
-  }
-}
-
-static void zathura_document_widget_arrange_grid(ZathuraDocumentWidget* widget) {
+/* Updates the geometry of the rows from the row of first_page onward, the rows
+ * before it keep their sizes and positions. Pages whose page object was not
+ * created yet are laid out with the estimated page size, so this does not
+ * create page objects. */
+static void zathura_document_widget_arrange_grid(ZathuraDocumentWidget* widget, unsigned int first_page) {
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(widget);
   zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  const unsigned int c0   = priv->first_page_column;
-  const unsigned int ncol = priv->pages_per_row;
+  zathura_grid_t* grid    = &priv->grid;
   const unsigned int npag = zathura_document_get_number_of_pages(z_document);
-  const unsigned int nrow = (npag + c0 - 1 + ncol - 1) / ncol;
+  const unsigned int ncol = grid->ncol;
+  const unsigned int skip = grid->first_page_column - 1;
 
   const unsigned int page_v_padding = priv->page_v_padding;
   const unsigned int page_h_padding = priv->page_h_padding;
 
-  memset(priv->row_heights, 0, nrow * sizeof(document_widget_line_s));
-  memset(priv->col_widths, 0, ncol * sizeof(document_widget_line_s));
-
-  // calculate the max width and height required for each column and row
-  for (unsigned int i = 0; i < npag; i++) {
-    zathura_page_t* page = zathura_document_get_page(z_document, i);
+  grid->right_to_left = priv->pages_right_to_left;
+  if (first_page >= npag || priv->col_sizes == NULL) {
+    return;
+  }
 
-    unsigned int row = 0;
-    unsigned int col = 0;
-    zathura_document_widget_get_page_position(widget, i, &row, &col);
+  unsigned int first_row = 0;
+  unsigned int col       = 0;
+  zathura_grid_page_to_cell(grid, first_page, &first_row, &col);
 
-    unsigned int x = priv->pages_right_to_left ? priv->ncol - 1 - col : col;
-    unsigned int y = row;
+  /* the columns start from their sizes over the rows that are kept */
+  memset(&grid->rows[first_row], 0, (grid->nrow - first_row) * sizeof(zathura_grid_line_t));
+  for (unsigned int x = 0; x < ncol; x++) {
+    grid->cols[x].size = first_row > 0 ? priv->col_sizes[(first_row - 1) * ncol + x] : 0;
+  }
 
-    unsigned int page_width, page_height;
-    page_calc_height_width(z_document, page, &page_height, &page_width, true);
+  // calculate the max width and height required for each column and row
+  for (unsigned int y = first_row; y < grid->nrow; y++) {
+    for (unsigned int cell = MAX(y * ncol, skip); cell < (y + 1) * ncol && cell - skip < npag; cell++) {
+      const unsigned int i = cell - skip;
+
+      unsigned int row = 0;
+      unsigned int x   = 0;
+      zathura_grid_page_to_cell(grid, i, &row, &x);
+
+      unsigned int page_width, page_height;
+      zathura_page_t* page = zathura_document_peek_page(z_document, i);
+      if (page != NULL) {
+        page_calc_height_width(z_document, page, &page_height, &page_width, true);
+      } else {
+        page_calc_height_width_estimate(z_document, &page_height, &page_width, true);
+      }
+
+      grid->rows[y].size = MAX(page_height, grid->rows[y].size);
+      grid->cols[x].size = MAX(page_width, grid->cols[x].size);
+    }
 
-    priv->row_heights[y].size = MAX(page_height, priv->row_heights[y].size);
-    priv->col_widths[x].size  = MAX(page_width, priv->col_widths[x].size);
+    for (unsigned int x = 0; x < ncol; x++) {
+      priv->col_sizes[y * ncol + x] = grid->cols[x].size;
+    }
   }
 
-  zathura_document_widget_line_prefix_sum(priv->col_widths, ncol, page_h_padding);
-  zathura_document_widget_line_prefix_sum(priv->row_heights, nrow, page_v_padding);
+  zathura_grid_lines_prefix_sum(grid->cols, ncol, 0, page_h_padding);
+  zathura_grid_lines_prefix_sum(grid->rows, grid->nrow, first_row, page_v_padding);
 }
 
 static void document_adjustment(ZathuraDocumentWidget* document, int height, int width, int* adj_v, int* adj_h) {
@@ -314,16 +330,13 @@ static void page_allocation(ZathuraDocumentWidget* document, int page_id, int he
                             GtkAllocation* page_alloc) {
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  unsigned int row = 0, col = 0;
-  zathura_document_widget_get_page_position(document, page_id, &row, &col);
-
-  const unsigned int x = priv->pages_right_to_left ? priv->ncol - 1 - col : col;
-  const unsigned int y = row;
+  unsigned int y = 0, x = 0;
+  zathura_grid_page_to_cell(&priv->grid, page_id, &y, &x);
 
-  const int page_width  = priv->col_widths[x].size;
-  const int page_height = priv->row_heights[y].size;
-  const int value_h     = gtk_adjustment_get_value(priv->hadjustment) - priv->col_widths[x].pos;
-  const int value_v     = gtk_adjustment_get_value(priv->vadjustment) - priv->row_heights[y].pos;
+  const int page_width  = priv->grid.cols[x].size;
+  const int page_height = priv->grid.rows[y].size;
+  const int value_h     = gtk_adjustment_get_value(priv->hadjustment) - priv->grid.cols[x].pos;
+  const int value_v     = gtk_adjustment_get_value(priv->vadjustment) - priv->grid.rows[y].pos;
 
   /* clamp x and y offsets so we don't leave the page */
   const int clamp_h = MAX(MIN(-value_h, 0), -(page_width - width));
@@ -335,30 +348,44 @@ static void page_allocation(ZathuraDocumentWidget* document, int page_id, int he
   page_alloc->height = MAX(page_height, height);
 }
 
-static void size_allocate_grid(ZathuraDocumentWidget* document, GtkAllocation* allocation) {
+bool zathura_document_widget_get_page_range(ZathuraDocumentWidget* document, int top, int bottom,
+                                            unsigned int* first_page, unsigned int* last_page) {
+  g_return_val_if_fail(document != NULL && first_page != NULL && last_page != NULL, false);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
-  zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  const unsigned int npag = zathura_document_get_number_of_pages(z_document);
+  return zathura_grid_page_range(&priv->grid, top, bottom, first_page, last_page);
+}
 
-  gtk_widget_show_all(GTK_WIDGET(document));
+unsigned int zathura_document_widget_get_page_at(ZathuraDocumentWidget* document, double x, double y) {
+  g_return_val_if_fail(document != NULL, 0);
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+
+  return zathura_grid_position_to_page(&priv->grid, x, y);
+}
+
+static void size_allocate_grid(ZathuraDocumentWidget* document, GtkAllocation* allocation) {
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
   int adj_v, adj_h;
   document_adjustment(document, allocation->height, allocation->width, &adj_v, &adj_h);
 
-  for (unsigned int i = 0; i < npag; i++) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
+  /* only the widgets bound to pages are allocated, see zathura_document_widget_bind_pages */
+  GHashTableIter iter;
+  gpointer page_widget = NULL;
+  g_hash_table_iter_init(&iter, priv->children);
+  while (g_hash_table_iter_next(&iter, &page_widget, NULL) == TRUE) {
+    if (gtk_widget_get_child_visible(page_widget) == false) {
+      continue;
+    }
 
-    unsigned int row;
-    unsigned int col;
-    zathura_document_widget_get_page_position(document, i, &row, &col);
+    const unsigned int i = zathura_page_get_index(zathura_page_widget_get_page(ZATHURA_PAGE_WIDGET(page_widget)));
 
-    unsigned int x = priv->pages_right_to_left ? priv->ncol - 1 - col : col;
-    unsigned int y = row;
+    unsigned int y;
+    unsigned int x;
+    zathura_grid_page_to_cell(&priv->grid, i, &y, &x);
 
-    document_widget_line_s col_line = priv->col_widths[x];
-    document_widget_line_s row_line = priv->row_heights[y];
+    zathura_grid_line_t col_line = priv->grid.cols[x];
+    zathura_grid_line_t row_line = priv->grid.rows[y];
 
     GtkAllocation page_alloc = {
         .x      = col_line.pos - adj_h,
@@ -375,22 +402,18 @@ static void size_allocate_single_page(ZathuraDocumentWidget* document, GtkAlloca
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
   zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  const unsigned int npag    = zathura_document_get_number_of_pages(z_document);
   const unsigned int page_id = zathura_document_get_current_page_number(z_document);
 
+  /* all other pages are hidden by zathura_document_widget_bind_pages */
+  GtkWidget* current_widget = zathura_page_get_widget_by_number(priv->zathura, page_id);
+  if (current_widget == NULL || gtk_widget_get_visible(current_widget) == false) {
+    zathura_document_widget_bind_pages(document);
+    return;
+  }
+
   GtkAllocation page_alloc;
   page_allocation(document, page_id, allocation->height, allocation->width, &page_alloc);
-
-  for (unsigned int i = 0; i < npag; i++) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
-
-    gtk_widget_set_visible(page_widget, page_id == i);
-
-    if (i == page_id) {
-      gtk_widget_size_allocate(page_widget, &page_alloc);
-    }
-  }
+  gtk_widget_size_allocate(current_widget, &page_alloc);
 }
 
 static void zathura_document_widget_size_allocate(GtkWidget* widget, GtkAllocation* allocation) {
@@ -398,7 +421,7 @@ static void zathura_document_widget_size_allocate(GtkWidget* widget, GtkAllocati
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
   zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  if (z_document == NULL || priv->zathura == NULL) {
+  if (z_document == NULL || priv->zathura == NULL || priv->grid.rows == NULL || priv->grid.cols == NULL) {
     return;
   }
 
@@ -408,6 +431,9 @@ static void zathura_document_widget_size_allocate(GtkWidget* widget, GtkAllocati
   zathura_document_set_viewport_height(z_document, allocation->height);
   zathura_document_set_viewport_width(z_document, allocation->width);
 
+  /* changes of the adjustments bind pages after the allocation */
+  priv->allocating = true;
+
   adjust_view(priv->zathura);
 
   /* allocate pages */
@@ -422,6 +448,8 @@ static void zathura_document_widget_size_allocate(GtkWidget* widget, GtkAllocati
     girara_error("unknown layout mode");
   }
 
+  priv->allocating = false;
+
   GTK_WIDGET_CLASS(zathura_document_widget_parent_class)->size_allocate(widget, allocation);
 }
 
@@ -434,11 +462,18 @@ static void zathura_document_widget_container_add(GtkContainer* container, GtkWi
     return;
   }
 
+  ZathuraDocumentWidgetPrivate* priv =
+      zathura_document_widget_get_instance_private(ZATHURA_DOCUMENT_WIDGET(container));
+  g_hash_table_add(priv->children, widget);
   gtk_widget_set_parent(widget, GTK_WIDGET(container));
 }
 
-static void zathura_document_widget_container_remove(GtkContainer* UNUSED(container), GtkWidget* widget) {
-  gtk_widget_unparent(widget);
+static void zathura_document_widget_container_remove(GtkContainer* container, GtkWidget* widget) {
+  ZathuraDocumentWidgetPrivate* priv =
+      zathura_document_widget_get_instance_private(ZATHURA_DOCUMENT_WIDGET(container));
+  if (g_hash_table_remove(priv->children, widget) == TRUE) {
+    gtk_widget_unparent(widget);
+  }
 }
 
 static void zathura_document_widget_container_forall(GtkContainer* container, gboolean UNUSED(include_internals),
@@ -446,21 +481,21 @@ static void zathura_document_widget_container_forall(GtkContainer* container, gb
   ZathuraDocumentWidget* document    = ZATHURA_DOCUMENT_WIDGET(container);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  zathura_document_t* z_document = zathura_get_document(priv->zathura);
-  unsigned int npag              = zathura_document_get_number_of_pages(z_document);
-
-  for (unsigned int i = 0; i < npag; i++) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
-
-    callback(page_widget, user_data);
+  /* only pages close to the viewport and the pool have a widget; the callback might remove children */
+  GList* children = g_hash_table_get_keys(priv->children);
+  for (GList* iter = children; iter != NULL; iter = iter->next) {
+    callback(iter->data, user_data);
   }
+  g_list_free(children);
 }
 
 static void zathura_document_widget_dispose(GObject* object) {
   ZathuraDocumentWidget* document    = ZATHURA_DOCUMENT_WIDGET(object);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
+  g_clear_handle_id(&priv->layout_idle, g_source_remove);
+  g_clear_handle_id(&priv->bind_idle, g_source_remove);
+  g_queue_clear_full(priv->pool, g_object_unref);
   g_clear_object(&priv->hadjustment);
   g_clear_object(&priv->vadjustment);
 
@@ -471,11 +506,14 @@ static void zathura_document_widget_finalize(GObject* object) {
   ZathuraDocumentWidget* document    = ZATHURA_DOCUMENT_WIDGET(object);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  g_free(priv->col_widths);
-  g_free(priv->row_heights);
+  g_free(priv->grid.cols);
+  g_free(priv->grid.rows);
+  g_free(priv->col_sizes);
+  g_hash_table_unref(priv->children);
+  g_queue_free(priv->pool);
 
-  priv->col_widths  = NULL;
-  priv->row_heights = NULL;
+  priv->grid.cols = NULL;
+  priv->grid.rows = NULL;
 
   G_OBJECT_CLASS(zathura_document_widget_parent_class)->finalize(object);
 }
@@ -491,30 +529,29 @@ void zathura_document_widget_refresh_layout(ZathuraDocumentWidget* document) {
   const unsigned int npag = zathura_document_get_number_of_pages(z_document);
   const unsigned int nrow = (npag + c0 - 1 + ncol - 1) / ncol;
 
-  document_widget_line_s* tmp = g_try_realloc_n(priv->col_widths, ncol, sizeof(document_widget_line_s));
+  zathura_grid_line_t* tmp = g_try_realloc_n(priv->grid.cols, ncol, sizeof(zathura_grid_line_t));
   if (tmp == NULL) {
     girara_error("Failed to allocate document grid (%u columns, %u rows)", ncol, nrow);
     return;
   }
-  priv->col_widths = tmp;
-  tmp              = g_try_realloc_n(priv->row_heights, nrow, sizeof(document_widget_line_s));
+  priv->grid.cols = tmp;
+  tmp             = g_try_realloc_n(priv->grid.rows, nrow, sizeof(zathura_grid_line_t));
   if (tmp == NULL) {
     girara_error("Failed to allocate document grid (%u columns, %u rows)", ncol, nrow);
     return;
   }
-  priv->row_heights = tmp;
-
-  priv->ncol = ncol;
-  priv->nrow = nrow;
-
-  // parent all page widgets to the document widget
-  for (unsigned int i = 0; i < npag; i++) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
-
-    gtk_widget_unparent(page_widget);
-    gtk_container_add(GTK_CONTAINER(document), page_widget);
+  priv->grid.rows = tmp;
+  unsigned int* col_sizes = g_try_realloc_n(priv->col_sizes, nrow, ncol * sizeof(unsigned int));
+  if (col_sizes == NULL) {
+    girara_error("Failed to allocate document grid (%u columns, %u rows)", ncol, nrow);
+    return;
   }
+  priv->col_sizes = col_sizes;
+
+  priv->grid.ncol              = ncol;
+  priv->grid.nrow              = nrow;
+  priv->grid.npag              = npag;
+  priv->grid.first_page_column = c0;
 
   zathura_document_widget_compute_layout(document);
 
@@ -522,11 +559,9 @@ void zathura_document_widget_refresh_layout(ZathuraDocumentWidget* document) {
   gtk_widget_queue_resize(GTK_WIDGET(document));
 }
 
-void zathura_document_widget_compute_layout(ZathuraDocumentWidget* document) {
-  g_return_if_fail(document != NULL);
-
+static void document_widget_update_layout(ZathuraDocumentWidget* document, unsigned int first_page) {
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
-  zathura_document_widget_arrange_grid(document);
+  zathura_document_widget_arrange_grid(document, first_page);
 
   /* update allocation values */
   unsigned int doc_height = 0, doc_width = 0;
@@ -541,13 +576,70 @@ void zathura_document_widget_compute_layout(ZathuraDocumentWidget* document) {
   gtk_adjustment_set_step_increment(priv->vadjustment, scroll_step);
 }
 
+void zathura_document_widget_compute_layout(ZathuraDocumentWidget* document) {
+  g_return_if_fail(document != NULL);
+
+  document_widget_update_layout(document, 0);
+}
+
+static gboolean document_widget_layout_idle(gpointer data) {
+  ZathuraDocumentWidget* document    = data;
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+  zathura_document_t* z_document     = zathura_get_document(priv->zathura);
+
+  const unsigned int first_page = priv->layout_first_page;
+  priv->layout_idle             = 0;
+  priv->layout_first_page       = G_MAXUINT;
+  if (z_document == NULL) {
+    return G_SOURCE_REMOVE;
+  }
+
+  /* the pages before the first changed page keep their positions */
+  document_widget_update_layout(document, first_page);
+
+  /* only pages whose size changed have to be rendered again, all of them have a widget */
+  GHashTableIter iter;
+  gpointer page_widget = NULL;
+  g_hash_table_iter_init(&iter, priv->children);
+  while (g_hash_table_iter_next(&iter, &page_widget, NULL) == TRUE) {
+    zathura_page_t* page = zathura_page_widget_get_page(ZATHURA_PAGE_WIDGET(page_widget));
+    if (page == NULL || zathura_page_get_index(page) < first_page ||
+        zathura_page_get_widget_by_number(priv->zathura, zathura_page_get_index(page)) != page_widget) {
+      continue;
+    }
+
+    unsigned int page_height = 0, page_width = 0;
+    page_calc_height_width(z_document, page, &page_height, &page_width, true);
+
+    int width = 0, height = 0;
+    gtk_widget_get_size_request(page_widget, &width, &height);
+    if (width != (int)page_width || height != (int)page_height) {
+      zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(page_widget), page_width, page_height);
+    }
+  }
+
+  gtk_widget_queue_resize(GTK_WIDGET(document));
+
+  return G_SOURCE_REMOVE;
+}
+
+void zathura_document_widget_queue_layout(ZathuraDocumentWidget* document, unsigned int page_index) {
+  g_return_if_fail(document != NULL);
+
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+  priv->layout_first_page            = MIN(priv->layout_first_page, page_index);
+  if (priv->layout_idle == 0) {
+    priv->layout_idle = g_idle_add(document_widget_layout_idle, document);
+  }
+}
+
 void zathura_document_widget_get_cell_pos(ZathuraDocumentWidget* document, unsigned int page_index, unsigned int* pos_x,
                                           unsigned int* pos_y) {
   g_return_if_fail(document != NULL && pos_x != NULL && pos_y != NULL);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
   zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  if (priv->col_widths == NULL || priv->row_heights == NULL) {
+  if (priv->grid.cols == NULL || priv->grid.rows == NULL) {
     return;
   }
 
@@ -558,10 +650,10 @@ void zathura_document_widget_get_cell_pos(ZathuraDocumentWidget* document, unsig
   }
 
   unsigned int row, col;
-  zathura_document_widget_get_page_position(document, page_index, &row, &col);
+  zathura_grid_page_to_cell(&priv->grid, page_index, &row, &col);
 
-  *pos_x = priv->col_widths[col].pos;
-  *pos_y = priv->row_heights[row].pos;
+  *pos_x = priv->grid.cols[col].pos;
+  *pos_y = priv->grid.rows[row].pos;
 }
 
 void zathura_document_widget_get_cell_size(ZathuraDocumentWidget* document, unsigned int page_index,
@@ -570,7 +662,7 @@ void zathura_document_widget_get_cell_size(ZathuraDocumentWidget* document, unsi
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
   zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  if (priv->col_widths == NULL || priv->row_heights == NULL) {
+  if (priv->grid.cols == NULL || priv->grid.rows == NULL) {
     return;
   }
 
@@ -581,10 +673,10 @@ void zathura_document_widget_get_cell_size(ZathuraDocumentWidget* document, unsi
   }
 
   unsigned int row, col;
-  zathura_document_widget_get_page_position(document, page_index, &row, &col);
+  zathura_grid_page_to_cell(&priv->grid, page_index, &row, &col);
 
-  *height = priv->row_heights[row].size;
-  *width  = priv->col_widths[col].size;
+  *height = priv->grid.rows[row].size;
+  *width  = priv->grid.cols[col].size;
 }
 
 void zathura_document_widget_get_row(ZathuraDocumentWidget* document, unsigned int row, unsigned int* pos,
@@ -592,17 +684,17 @@ void zathura_document_widget_get_row(ZathuraDocumentWidget* document, unsigned i
   g_return_if_fail(document != NULL && pos != NULL && size != NULL);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  if (priv->col_widths == NULL || priv->row_heights == NULL) {
+  if (priv->grid.cols == NULL || priv->grid.rows == NULL) {
     return;
   }
 
-  if (row >= priv->nrow) {
-    girara_warning("tried to get row %d size, document has %d rows", row, priv->nrow);
+  if (row >= priv->grid.nrow) {
+    girara_warning("tried to get row %d size, document has %d rows", row, priv->grid.nrow);
     return;
   }
 
-  *pos  = priv->row_heights[row].pos;
-  *size = priv->row_heights[row].size;
+  *pos  = priv->grid.rows[row].pos;
+  *size = priv->grid.rows[row].size;
 }
 
 void zathura_document_widget_get_col(ZathuraDocumentWidget* document, unsigned int col, unsigned int* pos,
@@ -610,17 +702,17 @@ void zathura_document_widget_get_col(ZathuraDocumentWidget* document, unsigned i
   g_return_if_fail(document != NULL && pos != NULL && size != NULL);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  if (priv->col_widths == NULL || priv->row_heights == NULL) {
+  if (priv->grid.cols == NULL || priv->grid.rows == NULL) {
     return;
   }
 
-  if (col >= priv->ncol) {
-    girara_warning("tried to get col %d size, document has %d columns", col, priv->ncol);
+  if (col >= priv->grid.ncol) {
+    girara_warning("tried to get col %d size, document has %d columns", col, priv->grid.ncol);
     return;
   }
 
-  *pos  = priv->col_widths[col].pos;
-  *size = priv->col_widths[col].size;
+  *pos  = priv->grid.cols[col].pos;
+  *size = priv->grid.cols[col].size;
 }
 
 void zathura_document_widget_get_document_size(ZathuraDocumentWidget* document, unsigned int* height,
@@ -628,12 +720,12 @@ void zathura_document_widget_get_document_size(ZathuraDocumentWidget* document,
   g_return_if_fail(document != NULL && height != NULL && width != NULL);
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
 
-  if (priv->col_widths == NULL || priv->row_heights == NULL) {
+  if (priv->grid.cols == NULL || priv->grid.rows == NULL) {
     return;
   }
 
-  document_widget_line_s last_row = priv->row_heights[priv->nrow - 1];
-  document_widget_line_s last_col = priv->col_widths[priv->ncol - 1];
+  zathura_grid_line_t last_row = priv->grid.rows[priv->grid.nrow - 1];
+  zathura_grid_line_t last_col = priv->grid.cols[priv->grid.ncol - 1];
 
   *height = last_row.pos + last_row.size;
   *width  = last_col.pos + last_col.size;
@@ -643,28 +735,126 @@ void zathura_document_widget_clear_pages(ZathuraDocumentWidget* document) {
   g_return_if_fail(document != NULL);
 
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
-  zathura_document_t* z_document     = zathura_get_document(priv->zathura);
 
-  const unsigned int number_of_pages = zathura_document_get_number_of_pages(z_document);
-  for (unsigned int i = 0; i < number_of_pages; ++i) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
+  GList* children = g_hash_table_get_keys(priv->children);
+  for (GList* iter = children; iter != NULL; iter = iter->next) {
+    gtk_container_remove(GTK_CONTAINER(document), iter->data);
+  }
+  g_list_free(children);
+
+  /* pooled widgets still point to pages of the closed document */
+  g_queue_clear_full(priv->pool, g_object_unref);
+}
 
-    gtk_widget_unparent(page_widget);
+GtkWidget* zathura_document_widget_take_pooled_page(ZathuraDocumentWidget* document) {
+  g_return_val_if_fail(document != NULL, NULL);
+
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+  GtkWidget* page_widget             = g_queue_pop_head(priv->pool);
+  if (page_widget != NULL) {
+    gtk_widget_set_child_visible(page_widget, true);
   }
+
+  return page_widget;
 }
 
-void zathura_document_widget_clear_thumbnails(ZathuraDocumentWidget* document) {
+void zathura_document_widget_pool_page(ZathuraDocumentWidget* document, GtkWidget* page_widget) {
+  g_return_if_fail(document != NULL && page_widget != NULL);
+
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+  if (g_queue_get_length(priv->pool) >= PAGE_WIDGET_POOL_SIZE) {
+    gtk_container_remove(GTK_CONTAINER(document), page_widget);
+    g_object_unref(page_widget);
+    return;
+  }
+
+  gtk_widget_set_child_visible(page_widget, false);
+  g_queue_push_tail(priv->pool, page_widget);
+}
+
+static gboolean document_widget_bind_idle(gpointer data) {
+  ZathuraDocumentWidget* document    = data;
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+
+  priv->bind_idle = 0;
+  zathura_document_widget_bind_pages(document);
+
+  return G_SOURCE_REMOVE;
+}
+
+void zathura_document_widget_bind_pages(ZathuraDocumentWidget* document) {
   g_return_if_fail(document != NULL);
 
   ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
-  zathura_document_t* z_document     = zathura_get_document(priv->zathura);
+  if (priv->zathura == NULL || zathura_has_document(priv->zathura) == false || priv->zathura->pages == NULL ||
+      priv->grid.rows == NULL || priv->grid.cols == NULL) {
+    return;
+  }
+  zathura_document_t* z_document = zathura_get_document(priv->zathura);
 
-  const unsigned int number_of_pages = zathura_document_get_number_of_pages(z_document);
-  for (unsigned int i = 0; i < number_of_pages; ++i) {
-    zathura_page_t* page   = zathura_document_get_page(z_document, i);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
+  /* adding and hiding children while they are allocated would queue another resize */
+  if (priv->allocating == TRUE) {
+    if (priv->bind_idle == 0) {
+      priv->bind_idle = g_idle_add_full(G_PRIORITY_HIGH_IDLE, document_widget_bind_idle, document, NULL);
+    }
+    return;
+  }
+
+  const bool single_page  = priv->layout_mode == DOCUMENT_WIDGET_SINGLE;
+  unsigned int first_page = 1;
+  unsigned int last_page  = 0;
+  if (single_page == true) {
+    first_page = zathura_document_get_current_page_number(z_document);
+    last_page  = first_page;
+  } else {
+    const int height = gtk_adjustment_get_page_size(priv->vadjustment);
+    const int width  = gtk_adjustment_get_page_size(priv->hadjustment);
+
+    int adj_v, adj_h;
+    document_adjustment(document, height, width, &adj_v, &adj_h);
+
+    /* pages in and one viewport around the visible area get a widget */
+    zathura_document_widget_get_page_range(document, adj_v - height, adj_v + 2 * height, &first_page, &last_page);
+  }
+
+  /* widgets of the other pages go back to the pool unless they carry state */
+  GList* children = g_hash_table_get_keys(priv->children);
+  for (GList* iter = children; iter != NULL; iter = iter->next) {
+    GtkWidget* page_widget = iter->data;
+    if (gtk_widget_get_child_visible(page_widget) == false) {
+      continue;
+    }
+
+    const unsigned int i = zathura_page_get_index(zathura_page_widget_get_page(ZATHURA_PAGE_WIDGET(page_widget)));
+    const bool in_range  = i >= first_page && i <= last_page;
+    if (in_range == false && zathura_page_release_widget(priv->zathura, i) == true) {
+      continue;
+    }
 
+    gtk_widget_set_visible(page_widget, in_range == true || single_page == false);
+  }
+  g_list_free(children);
+
+  for (unsigned int i = first_page; i <= last_page; i++) {
+    GtkWidget* page_widget = zathura_page_acquire_widget(priv->zathura, i);
+    if (page_widget != NULL) {
+      gtk_widget_set_visible(page_widget, true);
+      gtk_widget_get_preferred_size(page_widget, NULL, NULL);
+    }
+  }
+
+  gtk_widget_queue_allocate(GTK_WIDGET(document));
+}
+
+void zathura_document_widget_clear_thumbnails(ZathuraDocumentWidget* document) {
+  g_return_if_fail(document != NULL);
+
+  ZathuraDocumentWidgetPrivate* priv = zathura_document_widget_get_instance_private(document);
+
+  GHashTableIter iter;
+  gpointer page_widget = NULL;
+  g_hash_table_iter_init(&iter, priv->children);
+  while (g_hash_table_iter_next(&iter, &page_widget, NULL) == TRUE) {
     zathura_page_widget_clear_thumbnail(ZATHURA_PAGE_WIDGET(page_widget));
   }
 }
@@ -685,17 +875,19 @@ void zathura_document_widget_render_all(ZathuraDocumentWidget* document) {
   /* unmark all pages */
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(z_document);
   for (unsigned int page_id = 0; page_id < number_of_pages; ++page_id) {
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(priv->zathura, page_id);
+    if (page_widget == NULL) {
+      continue;
+    }
+
     zathura_page_t* page = zathura_document_get_page(z_document, page_id);
 
     unsigned int page_height = 0, page_width = 0;
     page_calc_height_width(z_document, page, &page_height, &page_width, true);
 
     girara_debug("Queuing resize for page %u to %u x %u.", page_id, page_width, page_height);
-    GtkWidget* page_widget = zathura_page_get_widget(priv->zathura, page);
-    if (page_widget != NULL) {
-      zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(page_widget), page_width, page_height);
-      gtk_widget_queue_resize(page_widget);
-    }
+    zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(page_widget), page_width, page_height);
+    gtk_widget_queue_resize(page_widget);
   }
 }
 
@@ -3,6 +3,7 @@
 #ifndef DOCUMENT_WIDGET_H
 #define DOCUMENT_WIDGET_H
 
+#include <stdbool.h>
 #include <gtk/gtk.h>
 #include "types.h"
 
@@ -58,6 +59,16 @@ void zathura_document_widget_refresh_layout(ZathuraDocumentWidget* document);
  */
 void zathura_document_widget_compute_layout(ZathuraDocumentWidget* document);
 
+/**
+ * Schedule an update of the layout from the main loop, e.g. after the actual
+ * size of a page became known. Pages whose size changed are rendered again.
+ * Pages before the given page keep their positions.
+ *
+ * @param document ZathuraDocumentWidget
+ * @param page_index First page whose size changed
+ */
+void zathura_document_widget_queue_layout(ZathuraDocumentWidget* document, unsigned int page_index);
+
 /**
  * Return the position of a cell from the document's layout table in pixels.
  * It takes the current scale into account.
@@ -120,6 +131,33 @@ void zathura_document_widget_get_col(ZathuraDocumentWidget* document, unsigned i
 void zathura_document_widget_get_document_size(ZathuraDocumentWidget* document, unsigned int* height,
                                                unsigned int* width);
 
+/**
+ * Get the pages in the rows intersecting a vertical range of the document.
+ * The rows are found by binary search, so the cost does not depend on the
+ * number of pages. Valid after a call to zathura_document_widget_compute_layout.
+ *
+ * @param document   ZathuraDocumentWidget
+ * @param top        top of the range in pixels
+ * @param bottom     bottom of the range in pixels
+ * @return first_page first page in the range
+ * @return last_page  last page in the range
+ * @return true if the range contains pages, false otherwise
+ */
+bool zathura_document_widget_get_page_range(ZathuraDocumentWidget* document, int top, int bottom,
+                                            unsigned int* first_page, unsigned int* last_page);
+
+/**
+ * Get the page at a position of the document. Positions in padding or empty
+ * cells map to the closest page that follows them. The page is found by binary
+ * search. Valid after a call to zathura_document_widget_compute_layout.
+ *
+ * @param document ZathuraDocumentWidget
+ * @param x        horizontal position in pixels
+ * @param y        vertical position in pixels
+ * @return the page index
+ */
+unsigned int zathura_document_widget_get_page_at(ZathuraDocumentWidget* document, double x, double y);
+
 /**
  * Remove page widgets from document.
  *
@@ -127,6 +165,35 @@ void zathura_document_widget_get_document_size(ZathuraDocumentWidget* document,
  */
 void zathura_document_widget_clear_pages(ZathuraDocumentWidget* document);
 
+/**
+ * Bind page widgets to the pages in and around the viewport and return the
+ * widgets of the other pages to the pool. This happens whenever the
+ * adjustments change, but never while the pages are allocated.
+ *
+ * @param document ZathuraDocumentWidget
+ */
+void zathura_document_widget_bind_pages(ZathuraDocumentWidget* document);
+
+/**
+ * Take a page widget from the pool of widgets that are not bound to a page.
+ * It is still a child of the document widget and has to be bound with
+ * zathura_page_widget_set_page.
+ *
+ * @param document ZathuraDocumentWidget
+ * @return a page widget, or NULL if the pool is empty; the reference is
+ *   transferred to the caller
+ */
+GtkWidget* zathura_document_widget_take_pooled_page(ZathuraDocumentWidget* document);
+
+/**
+ * Return an unbound page widget to the pool. Widgets exceeding the size of the
+ * pool are removed from the document widget.
+ *
+ * @param document ZathuraDocumentWidget
+ * @param page_widget the page widget; the reference is transferred to the pool
+ */
+void zathura_document_widget_pool_page(ZathuraDocumentWidget* document, GtkWidget* page_widget);
+
 /**
  * Clear all thumbnails.
  *
@@ -8,6 +8,7 @@
 #include <glib.h>
 #include <gio/gio.h>
 #include <math.h>
+#include <stdatomic.h>
 
 #include <girara/datastructures.h>
 #include <girara/log.h>
@@ -18,8 +19,12 @@
 #include "plugin.h"
 #include "content-type.h"
 #include "internal.h"
+#include "database.h"
+#include "render.h"
 
 #define DIGEST_SIZE 32
+/* size of the blocks sampled for the file identity */
+#define SAMPLE_SIZE 16384
 
 /**
  * Document
@@ -30,8 +35,8 @@ struct zathura_document_s {
   char* uri;                               /**< URI of the document */
   char* basename;                          /**< Basename of the document */
   uint8_t hash_sha256[DIGEST_SIZE];        /**< SHA256 hash of the document */
-  const char* password;                    /**< Password of the document */
-  unsigned int current_page_number;        /**< Current page number */
+  char* password;                          /**< Password of the document */
+  atomic_uint current_page_number;         /**< Current page number, also read by the page loader */
   unsigned int number_of_pages;            /**< Number of pages */
   double zoom;                             /**< Zoom value */
   unsigned int rotate;                     /**< Rotation */
@@ -45,14 +50,25 @@ struct zathura_document_s {
   double position_y;                       /**< Y adjustment */
 
   /**
-   * Document pages
+   * Document pages, created on first access
    */
   zathura_page_t** pages;
+  GMutex pages_mutex;
+  double page_width_estimate;  /**< Width of pages that have not been initialized */
+  double page_height_estimate; /**< Height of pages that have not been initialized */
+
+  /**
+   * Version of the file the document was opened from
+   */
+  zathura_file_identity_t identity; /**< Identity of the file when it was opened */
+  bool has_identity;                /**< The identity could be determined */
+  atomic_bool file_changed;         /**< The file has been changed since it was opened */
 
   /**
    * Used plugin
    */
   const zathura_plugin_t* plugin;
+  ZathuraRenderer* renderer; /**< Renderer serializing calls into the plugin or NULL */
 };
 
 static bool hash_file_sha256(uint8_t* dst, const char* path) {
@@ -86,8 +102,103 @@ static bool hash_file_sha256(uint8_t* dst, const char* path) {
   return true;
 }
 
+static bool read_sample(GInputStream* stream, GChecksum* checksum, goffset offset) {
+  if (g_seekable_seek(G_SEEKABLE(stream), offset, G_SEEK_SET, NULL, NULL) == FALSE) {
+    return false;
+  }
+
+  uint8_t buf[SAMPLE_SIZE];
+  gsize read = 0;
+  if (g_input_stream_read_all(stream, buf, sizeof(buf), &read, NULL, NULL) == FALSE) {
+    return false;
+  }
+
+  g_checksum_update(checksum, buf, read);
+  return true;
+}
+
+static bool file_identity(zathura_file_identity_t* identity, const char* path) {
+  g_autoptr(GFile) f = g_file_new_for_path(path);
+  if (f == NULL) {
+    return false;
+  }
+
+  g_autoptr(GFileInfo) info = g_file_query_info(
+      f,
+      G_FILE_ATTRIBUTE_UNIX_DEVICE "," G_FILE_ATTRIBUTE_UNIX_INODE "," G_FILE_ATTRIBUTE_STANDARD_SIZE
+                                   "," G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  if (info == NULL || g_file_info_has_attribute(info, G_FILE_ATTRIBUTE_UNIX_INODE) == FALSE ||
+      g_file_info_has_attribute(info, G_FILE_ATTRIBUTE_TIME_MODIFIED) == FALSE) {
+    return false;
+  }
+
+  identity->device = g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_DEVICE);
+  identity->inode  = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_UNIX_INODE);
+  identity->size   = g_file_info_get_size(info);
+  identity->mtime  = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+                    g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+
+  /* the first, middle and last block catch most changes that keep size and
+   * modification time */
+  g_autoptr(GFileInputStream) stream = g_file_read(f, NULL, NULL);
+  if (stream == NULL) {
+    return false;
+  }
+
+  g_autoptr(GChecksum) checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  if (checksum == NULL) {
+    return false;
+  }
+
+  const goffset offsets[] = {0, identity->size / 2 - SAMPLE_SIZE / 2, identity->size - SAMPLE_SIZE};
+  for (size_t idx = 0; idx < LENGTH(offsets); ++idx) {
+    if (read_sample(G_INPUT_STREAM(stream), checksum, MAX(offsets[idx], 0)) == false) {
+      return false;
+    }
+  }
+
+  gsize dst_size = DIGEST_SIZE;
+  g_checksum_get_digest(checksum, identity->sample_sha256, &dst_size);
+  return true;
+}
+
+static bool file_identity_equal(const zathura_file_identity_t* a, const zathura_file_identity_t* b) {
+  return a->device == b->device && a->inode == b->inode && a->size == b->size && a->mtime == b->mtime &&
+         memcmp(a->sample_sha256, b->sample_sha256, DIGEST_SIZE) == 0;
+}
+
+/* Looks up the hash of the file version in the database and only hashes the
+ * whole file if it is not known yet. */
+static bool hash_file_cached(zathura_database_t* database, uint8_t* dst, const char* path,
+                             const zathura_file_identity_t* identity) {
+  const bool has_identity = database != NULL && identity != NULL;
+  if (has_identity == true && zathura_db_get_file_hash(database, path, identity, dst) == true) {
+    girara_debug("Using cached hash of '%s'.", path);
+    return true;
+  }
+
+  if (hash_file_sha256(dst, path) == false) {
+    return false;
+  }
+
+  /* do not cache the hash if the file changed while it was hashed */
+  zathura_file_identity_t after = {0};
+  if (has_identity == true && file_identity(&after, path) == true && file_identity_equal(identity, &after) == true) {
+    zathura_db_set_file_hash(database, path, identity, dst);
+  }
+
+  return true;
+}
+
 zathura_document_t* zathura_document_open(zathura_t* zathura, const char* path, const char* uri, const char* password,
                                           zathura_error_t* error) {
+  return zathura_document_open_with_hash(zathura, path, uri, password, NULL, NULL, error);
+}
+
+zathura_document_t* zathura_document_open_with_hash(zathura_t* zathura, const char* path, const char* uri,
+                                                    const char* password, const uint8_t* hash_sha256,
+                                                    ZathuraRenderer* renderer, zathura_error_t* error) {
   if (zathura == NULL || path == NULL) {
     return NULL;
   }
@@ -135,10 +246,15 @@ zathura_document_t* zathura_document_open(zathura_t* zathura, const char* path,
     g_autoptr(GFile) gf = g_file_new_for_uri(document->uri);
     document->basename  = g_file_get_basename(gf);
   }
-  if (hash_file_sha256(document->hash_sha256, document->file_path) == false) {
+  document->has_identity = file_identity(&document->identity, document->file_path);
+  atomic_init(&document->file_changed, false);
+  if (hash_sha256 != NULL) {
+    memcpy(document->hash_sha256, hash_sha256, DIGEST_SIZE);
+  } else if (hash_file_cached(zathura->database, document->hash_sha256, document->file_path,
+                              document->has_identity == true ? &document->identity : NULL) == false) {
     girara_warning("Failed to hash file '%s'; fileinfo lookup may be unreliable.", document->file_path);
   }
-  document->password         = password;
+  document->password         = g_strdup(password);
   document->zoom             = 1.0;
   document->plugin           = plugin;
   document->adjust_mode      = ZATHURA_ADJUST_NONE;
@@ -149,32 +265,50 @@ zathura_document_t* zathura_document_open(zathura_t* zathura, const char* path,
   document->device_factors.y = 1.0;
   document->position_x       = 0.0;
   document->position_y       = 0.0;
+  g_mutex_init(&document->pages_mutex);
+
+  /* the shown document may still be rendered by the same plugin, so plugins
+   * that are not thread-safe are serialized with its renderer, which also
+   * covers the initialization of the first page */
+  if (renderer != NULL && zathura_plugin_supports_concurrent_render(plugin) == false) {
+    zathura_document_set_renderer(document, renderer);
+  }
 
   /* open document */
   const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(plugin);
 
+  if (document->renderer != NULL) {
+    zathura_renderer_lock(document->renderer);
+  }
   zathura_error_t int_error = functions->document_open(document);
+  if (document->renderer != NULL) {
+    zathura_renderer_unlock(document->renderer);
+  }
   if (int_error != ZATHURA_ERROR_OK) {
     zathura_check_set_error(error, int_error);
     girara_error("could not open document\n");
     goto error_free;
   }
 
-  /* read all pages */
+  /* pages are created on first access, except for the first one which provides
+   * the size of all pages that have not been initialized yet */
   document->pages = g_try_malloc0_n(document->number_of_pages, sizeof(zathura_page_t*));
   if (document->pages == NULL) {
     zathura_check_set_error(error, ZATHURA_ERROR_OUT_OF_MEMORY);
     goto error_free;
   }
 
-  for (unsigned int page_id = 0; page_id < document->number_of_pages; page_id++) {
-    zathura_page_t* page = zathura_page_new(document, page_id, NULL);
+  if (document->number_of_pages != 0) {
+    zathura_error_t page_error = ZATHURA_ERROR_OK;
+    zathura_page_t* page       = zathura_page_new(document, 0, &page_error);
     if (page == NULL) {
-      zathura_check_set_error(error, ZATHURA_ERROR_OUT_OF_MEMORY);
+      zathura_check_set_error(error, page_error);
       goto error_free;
     }
 
-    document->pages[page_id] = page;
+    document->pages[0]             = page;
+    document->page_width_estimate  = zathura_page_get_width(page);
+    document->page_height_estimate = zathura_page_get_height(page);
   }
 
   return document;
@@ -201,6 +335,7 @@ zathura_error_t zathura_document_free(zathura_document_t* document) {
     }
     g_free(document->pages);
   }
+  g_mutex_clear(&document->pages_mutex);
 
   /* free document */
   const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(document->plugin);
@@ -210,6 +345,8 @@ zathura_error_t zathura_document_free(zathura_document_t* document) {
   g_free(document->file_path);
   g_free(document->uri);
   g_free(document->basename);
+  g_free(document->password);
+  g_clear_object(&document->renderer);
   g_free(document);
 
   return error;
@@ -247,6 +384,22 @@ const char* zathura_document_get_basename(zathura_document_t* document) {
   return document->basename;
 }
 
+bool zathura_document_file_unchanged(zathura_document_t* document) {
+  if (document == NULL || document->has_identity == false || atomic_load(&document->file_changed) == true) {
+    return false;
+  }
+
+  /* a file that changed once is not used again, even if it is changed back */
+  zathura_file_identity_t identity = {0};
+  if (file_identity(&identity, document->file_path) == false ||
+      file_identity_equal(&document->identity, &identity) == false) {
+    atomic_store(&document->file_changed, true);
+    return false;
+  }
+
+  return true;
+}
+
 const char* zathura_document_get_password(zathura_document_t* document) {
   if (document == NULL) {
     return NULL;
@@ -261,7 +414,37 @@ zathura_page_t* zathura_document_get_page(zathura_document_t* document, unsigned
   }
 
   g_return_val_if_fail(index < document->number_of_pages, NULL);
-  return document->pages[index];
+
+  g_mutex_lock(&document->pages_mutex);
+  zathura_page_t* page = document->pages[index];
+  if (page == NULL) {
+    page = zathura_page_new_lazy(document, index, document->page_width_estimate, document->page_height_estimate);
+    document->pages[index] = page;
+  }
+  g_mutex_unlock(&document->pages_mutex);
+
+  return page;
+}
+
+zathura_page_t* zathura_document_peek_page(zathura_document_t* document, unsigned int index) {
+  if (document == NULL || document->pages == NULL) {
+    return NULL;
+  }
+
+  g_return_val_if_fail(index < document->number_of_pages, NULL);
+
+  g_mutex_lock(&document->pages_mutex);
+  zathura_page_t* page = document->pages[index];
+  g_mutex_unlock(&document->pages_mutex);
+
+  return page;
+}
+
+void zathura_document_get_page_size_estimate(zathura_document_t* document, double* width, double* height) {
+  g_return_if_fail(document != NULL && width != NULL && height != NULL);
+
+  *width  = document->page_width_estimate;
+  *height = document->page_height_estimate;
 }
 
 void* zathura_document_get_data(zathura_document_t* document) {
@@ -301,7 +484,7 @@ unsigned int zathura_document_get_current_page_number(zathura_document_t* docume
     return 0;
   }
 
-  return document->current_page_number;
+  return atomic_load(&document->current_page_number);
 }
 
 void zathura_document_set_current_page_number(zathura_document_t* document, unsigned int current_page) {
@@ -309,7 +492,7 @@ void zathura_document_set_current_page_number(zathura_document_t* document, unsi
     return;
   }
 
-  document->current_page_number = current_page;
+  atomic_store(&document->current_page_number, current_page);
 }
 
 double zathura_document_get_position_x(zathura_document_t* document) {
@@ -570,3 +753,19 @@ const zathura_plugin_t* zathura_document_get_plugin(zathura_document_t* document
 
   return document->plugin;
 }
+
+void zathura_document_set_renderer(zathura_document_t* document, ZathuraRenderer* renderer) {
+  g_return_if_fail(document != NULL);
+
+  if (renderer != NULL) {
+    g_object_ref(renderer);
+  }
+  g_clear_object(&document->renderer);
+  document->renderer = renderer;
+}
+
+ZathuraRenderer* zathura_document_get_renderer(zathura_document_t* document) {
+  g_return_val_if_fail(document != NULL, NULL);
+
+  return document->renderer;
+}
@@ -8,30 +8,154 @@
 
 #include "macros.h"
 
+/* size and modification time of the monitored file */
+typedef struct file_state_s {
+  goffset size;
+  gint64 mtime;
+  bool exists;
+} file_state_t;
+
 struct zathura_glibfilemonitor_s {
   ZathuraFileMonitor parent;
-  GFileMonitor* monitor; /**< File monitor */
-  GFile* file;           /**< File for file monitor */
+  GFileMonitor* monitor;           /**< File monitor */
+  GFileMonitor* directory_monitor; /**< Monitor of the parent directory */
+  GFile* file;                     /**< File for file monitor */
+  guint timeout;                   /**< Source of the pending reload */
+  file_state_t state;              /**< State of the file at the last event or check */
+  unsigned int events;             /**< Events since the last reload */
+  unsigned int suppressed;         /**< Events that did not cause a reload */
+  unsigned int reloads;            /**< Performed reloads */
 };
 
 G_DEFINE_TYPE(ZathuraGLibFileMonitor, zathura_glibfilemonitor, ZATHURA_TYPE_FILEMONITOR)
 
-static void file_changed(GFileMonitor* UNUSED(monitor), GFile* file, GFile* UNUSED(other_file), GFileMonitorEvent event,
+static file_state_t file_state(GFile* file) {
+  file_state_t state = {0};
+
+  GFileInfo* info = g_file_query_info(file, G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED
+                                            "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                                      G_FILE_QUERY_INFO_NONE, NULL, NULL);
+  if (info != NULL) {
+    state.size   = g_file_info_get_size(info);
+    state.mtime  = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+                  g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+    state.exists = true;
+    g_object_unref(info);
+  }
+
+  return state;
+}
+
+static bool file_state_equal(const file_state_t* a, const file_state_t* b) {
+  return a->exists == b->exists && a->size == b->size && a->mtime == b->mtime;
+}
+
+static void schedule_reload(ZathuraGLibFileMonitor* file_monitor);
+
+static gboolean reload_timeout(gpointer data) {
+  ZathuraGLibFileMonitor* file_monitor = data;
+  file_monitor->timeout                = 0;
+
+  /* a removed file is reloaded once it is created again */
+  const file_state_t state = file_state(file_monitor->file);
+  if (state.exists == false) {
+    girara_debug("file-monitor: file does not exist, waiting for it to be created");
+    file_monitor->state = state;
+    return G_SOURCE_REMOVE;
+  }
+
+  /* a file that is still being written is checked again later */
+  if (file_state_equal(&state, &file_monitor->state) == false) {
+    girara_debug("file-monitor: file not stable yet, postponing reload");
+    file_monitor->state = state;
+    schedule_reload(file_monitor);
+    return G_SOURCE_REMOVE;
+  }
+
+  file_monitor->suppressed += file_monitor->events - 1;
+  file_monitor->reloads++;
+  girara_debug("file-monitor: reloading after %u events (%u reloads performed, %u events suppressed)",
+               file_monitor->events, file_monitor->reloads, file_monitor->suppressed);
+  file_monitor->events = 0;
+
+  g_signal_emit_by_name(file_monitor, "reload-file");
+  return G_SOURCE_REMOVE;
+}
+
+static void schedule_reload(ZathuraGLibFileMonitor* file_monitor) {
+  if (file_monitor->timeout != 0) {
+    g_source_remove(file_monitor->timeout);
+  }
+
+  const unsigned int quiet_period = zathura_filemonitor_get_quiet_period(ZATHURA_FILEMONITOR(file_monitor));
+  file_monitor->timeout           = g_timeout_add(quiet_period, reload_timeout, file_monitor);
+}
+
+static void file_changed(GFileMonitor* monitor, GFile* file, GFile* other_file, GFileMonitorEvent event,
                          gpointer user_data) {
   ZathuraGLibFileMonitor* file_monitor = user_data;
 
+  /* the file monitor reports writes to the file as well, so the directory
+   * monitor is only used for files that are moved over the monitored one */
+  if (monitor == file_monitor->directory_monitor && event != G_FILE_MONITOR_EVENT_RENAMED &&
+      event != G_FILE_MONITOR_EVENT_MOVED_IN) {
+    return;
+  }
+
   switch (event) {
+  case G_FILE_MONITOR_EVENT_CHANGED:
   case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
-  case G_FILE_MONITOR_EVENT_CREATED: {
-    g_autofree char* uri = g_file_get_uri(file);
-    girara_debug("received file-monitor event for %s", uri);
-
-    g_signal_emit_by_name(file_monitor, "reload-file");
+  case G_FILE_MONITOR_EVENT_CREATED:
+  case G_FILE_MONITOR_EVENT_MOVED_IN:
+    if (g_file_equal(file, file_monitor->file) == FALSE) {
+      return;
+    }
+    break;
+  case G_FILE_MONITOR_EVENT_RENAMED:
+    /* editors save by renaming a temporary file over the monitored one */
+    if (other_file == NULL || g_file_equal(other_file, file_monitor->file) == FALSE) {
+      return;
+    }
     break;
-  }
   default:
     return;
   }
+
+  g_autofree char* uri = g_file_get_uri(file_monitor->file);
+  girara_debug("received file-monitor event %d for %s", event, uri);
+
+  /* every event restarts the quiet period */
+  file_monitor->events++;
+  file_monitor->state = file_state(file_monitor->file);
+  schedule_reload(file_monitor);
+}
+
+static GFileMonitor* monitor_new(ZathuraGLibFileMonitor* file_monitor, GFile* file, bool directory) {
+  GFileMonitor* monitor = directory == true
+                              ? g_file_monitor_directory(file, G_FILE_MONITOR_WATCH_MOVES, NULL, NULL)
+                              : g_file_monitor_file(file, G_FILE_MONITOR_WATCH_HARD_LINKS, NULL, NULL);
+  if (monitor == NULL) {
+    return NULL;
+  }
+
+  /* changes while the file is written have to arrive within the quiet period */
+  g_file_monitor_set_rate_limit(monitor, zathura_filemonitor_get_quiet_period(ZATHURA_FILEMONITOR(file_monitor)));
+  g_signal_connect_object(G_OBJECT(monitor), "changed", G_CALLBACK(file_changed), file_monitor, 0);
+
+  return monitor;
+}
+
+static void quiet_period_changed(GObject* object, GParamSpec* UNUSED(pspec), gpointer UNUSED(data)) {
+  ZathuraGLibFileMonitor* file_monitor = ZATHURA_GLIBFILEMONITOR(object);
+  const unsigned int quiet_period      = zathura_filemonitor_get_quiet_period(ZATHURA_FILEMONITOR(file_monitor));
+
+  /* a pending reload picks up the new period when it is rescheduled */
+  if (file_monitor->monitor != NULL) {
+    g_file_monitor_set_rate_limit(file_monitor->monitor, quiet_period);
+  }
+  if (file_monitor->directory_monitor != NULL) {
+    g_file_monitor_set_rate_limit(file_monitor->directory_monitor, quiet_period);
+  }
 }
 
 static void start(ZathuraFileMonitor* file_monitor) {
@@ -45,22 +169,34 @@ static void start(ZathuraFileMonitor* file_monitor) {
     return;
   }
 
-  glib_file_monitor->monitor =
-      g_file_monitor_file(glib_file_monitor->file, G_FILE_MONITOR_WATCH_HARD_LINKS, NULL, NULL);
-  if (glib_file_monitor->monitor != NULL) {
-    g_signal_connect_object(G_OBJECT(glib_file_monitor->monitor), "changed", G_CALLBACK(file_changed),
-                            glib_file_monitor, 0);
+  /* the file monitor notices changes through hard links, the directory monitor
+   * notices files that are renamed over the monitored one */
+  glib_file_monitor->monitor = monitor_new(glib_file_monitor, glib_file_monitor->file, false);
+
+  GFile* parent = g_file_get_parent(glib_file_monitor->file);
+  if (parent != NULL) {
+    glib_file_monitor->directory_monitor = monitor_new(glib_file_monitor, parent, true);
+    g_object_unref(parent);
   }
 }
 
 static void stop(ZathuraFileMonitor* file_monitor) {
   ZathuraGLibFileMonitor* glib_file_monitor = ZATHURA_GLIBFILEMONITOR(file_monitor);
 
+  if (glib_file_monitor->timeout != 0) {
+    g_source_remove(glib_file_monitor->timeout);
+    glib_file_monitor->timeout = 0;
+  }
+
   if (glib_file_monitor->monitor != NULL) {
     g_file_monitor_cancel(glib_file_monitor->monitor);
   }
+  if (glib_file_monitor->directory_monitor != NULL) {
+    g_file_monitor_cancel(glib_file_monitor->directory_monitor);
+  }
 
   g_clear_object(&glib_file_monitor->monitor);
+  g_clear_object(&glib_file_monitor->directory_monitor);
   g_clear_object(&glib_file_monitor->file);
 }
 
@@ -85,6 +221,13 @@ static void zathura_glibfilemonitor_class_init(ZathuraGLibFileMonitorClass* clas
 }
 
 static void zathura_glibfilemonitor_init(ZathuraGLibFileMonitor* glibfilemonitor) {
-  glibfilemonitor->monitor = NULL;
-  glibfilemonitor->file    = NULL;
+  glibfilemonitor->monitor           = NULL;
+  glibfilemonitor->directory_monitor = NULL;
+  glibfilemonitor->file              = NULL;
+  glibfilemonitor->timeout           = 0;
+  glibfilemonitor->events            = 0;
+  glibfilemonitor->suppressed        = 0;
+  glibfilemonitor->reloads           = 0;
+
+  g_signal_connect(glibfilemonitor, "notify::quiet-period", G_CALLBACK(quiet_period_changed), NULL);
 }
@@ -14,6 +14,7 @@
 
 typedef struct {
   char* file_path;
+  unsigned int quiet_period;
 } ZathuraFileMonitorPrivate;
 
 G_DEFINE_TYPE_WITH_CODE(ZathuraFileMonitor, zathura_filemonitor, G_TYPE_OBJECT, G_ADD_PRIVATE(ZathuraFileMonitor))
@@ -21,6 +22,7 @@ G_DEFINE_TYPE_WITH_CODE(ZathuraFileMonitor, zathura_filemonitor, G_TYPE_OBJECT,
 enum {
   PROP_0,
   PROP_FILE_PATH,
+  PROP_QUIET_PERIOD,
 };
 
 static void finalize(GObject* object) {
@@ -45,6 +47,9 @@ static void set_property(GObject* object, guint prop_id, const GValue* value, GP
     }
     priv->file_path = g_value_dup_string(value);
     break;
+  case PROP_QUIET_PERIOD:
+    priv->quiet_period = g_value_get_uint(value);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
   }
@@ -58,6 +63,9 @@ static void get_property(GObject* object, guint prop_id, GValue* value, GParamSp
   case PROP_FILE_PATH:
     g_value_set_string(value, priv->file_path);
     break;
+  case PROP_QUIET_PERIOD:
+    g_value_set_uint(value, priv->quiet_period);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
   }
@@ -78,6 +86,10 @@ static void zathura_filemonitor_class_init(ZathuraFileMonitorClass* class) {
       object_class, PROP_FILE_PATH,
       g_param_spec_string("file-path", "file-path", "file path to monitor", NULL,
                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property(
+      object_class, PROP_QUIET_PERIOD,
+      g_param_spec_uint("quiet-period", "quiet-period", "milliseconds without changes before a reload", 0, G_MAXUINT,
+                        ZATHURA_FILEMONITOR_DEFAULT_QUIET_PERIOD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   /* add signals */
   g_signal_new("reload-file", ZATHURA_TYPE_FILEMONITOR, G_SIGNAL_RUN_LAST, 0, NULL, NULL, g_cclosure_marshal_generic,
@@ -87,6 +99,7 @@ static void zathura_filemonitor_class_init(ZathuraFileMonitorClass* class) {
 static void zathura_filemonitor_init(ZathuraFileMonitor* file_monitor) {
   ZathuraFileMonitorPrivate* priv = zathura_filemonitor_get_instance_private(file_monitor);
   priv->file_path                 = NULL;
+  priv->quiet_period              = ZATHURA_FILEMONITOR_DEFAULT_QUIET_PERIOD;
 }
 
 const char* zathura_filemonitor_get_filepath(ZathuraFileMonitor* file_monitor) {
@@ -94,6 +107,11 @@ const char* zathura_filemonitor_get_filepath(ZathuraFileMonitor* file_monitor) {
   return priv->file_path;
 }
 
+unsigned int zathura_filemonitor_get_quiet_period(ZathuraFileMonitor* file_monitor) {
+  ZathuraFileMonitorPrivate* priv = zathura_filemonitor_get_instance_private(file_monitor);
+  return priv->quiet_period;
+}
+
 void zathura_filemonitor_start(ZathuraFileMonitor* file_monitor) {
   ZATHURA_FILEMONITOR_GET_CLASS(file_monitor)->start(file_monitor);
 }
@@ -16,13 +16,21 @@
 #define ZATHURA_FILEMONITOR_GET_CLASS(obj)                                                                             \
   (G_TYPE_INSTANCE_GET_CLASS((obj), ZATHURA_TYPE_FILEMONITOR, ZathuraFileMonitorClass))
 
+/**
+ * Default time in milliseconds the monitored file has to stay unchanged before
+ * it is reloaded
+ */
+#define ZATHURA_FILEMONITOR_DEFAULT_QUIET_PERIOD 200
+
 typedef struct zathura_filemonitor_s ZathuraFileMonitor;
 typedef struct zathura_filemonitor_class_s ZathuraFileMonitorClass;
 
 /**
  * Base class for all file monitors.
  *
- * The signal 'reload-file' is emitted if the monitored file changed.
+ * The signal 'reload-file' is emitted if the monitored file changed. Backends
+ * that receive bursts of changes wait until the file did not change for the
+ * time given by the 'quiet-period' property.
  */
 struct zathura_filemonitor_s {
   GObject parent;
@@ -67,6 +75,13 @@ ZathuraFileMonitor* zathura_filemonitor_new(const char* file_path, zathura_filem
  */
 const char* zathura_filemonitor_get_filepath(ZathuraFileMonitor* file_monitor);
 
+/**
+ * Get the time the monitored file has to stay unchanged before it is reloaded.
+ *
+ * @return quiet period in milliseconds
+ */
+unsigned int zathura_filemonitor_get_quiet_period(ZathuraFileMonitor* file_monitor);
+
 /**
  * Start file monitor.
  */
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "grid.h"
+
+#include <glib.h>
+
+void zathura_grid_lines_prefix_sum(zathura_grid_line_t* lines, unsigned int n, unsigned int first,
+                                   unsigned int padding) {
+  if (first >= n) {
+    return;
+  }
+
+  if (first == 0) {
+    lines[0].pos = 0;
+    first        = 1;
+  }
+  for (unsigned int i = first; i < n; i++) {
+    lines[i].pos = lines[i - 1].pos + lines[i - 1].size + padding;
+  }
+}
+
+unsigned int zathura_grid_lines_find(const zathura_grid_line_t* lines, unsigned int n, double pos) {
+  unsigned int lo = 0;
+  unsigned int hi = n;
+  while (lo < hi) {
+    const unsigned int mid = lo + (hi - lo) / 2;
+    if ((double)lines[mid].pos + lines[mid].size < pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return MIN(lo, n - 1);
+}
+
+void zathura_grid_page_to_cell(const zathura_grid_t* grid, unsigned int page_index, unsigned int* row,
+                               unsigned int* col) {
+  const unsigned int cell = page_index + grid->first_page_column - 1;
+
+  *row = cell / grid->ncol;
+  *col = cell % grid->ncol;
+  if (grid->right_to_left == true) {
+    *col = grid->ncol - 1 - *col;
+  }
+}
+
+unsigned int zathura_grid_position_to_page(const zathura_grid_t* grid, double x, double y) {
+  if (grid->nrow == 0 || grid->ncol == 0 || grid->npag == 0) {
+    return 0;
+  }
+
+  const unsigned int row = zathura_grid_lines_find(grid->rows, grid->nrow, y);
+  unsigned int col       = zathura_grid_lines_find(grid->cols, grid->ncol, x);
+  if (grid->right_to_left == true) {
+    col = grid->ncol - 1 - col;
+  }
+
+  const unsigned int cell = grid->ncol * row + col;
+  const unsigned int c0   = grid->first_page_column;
+  if (cell < c0 - 1) {
+    return 0;
+  }
+
+  return MIN(cell - (c0 - 1), grid->npag - 1);
+}
+
+bool zathura_grid_page_range(const zathura_grid_t* grid, double top, double bottom, unsigned int* first_page,
+                             unsigned int* last_page) {
+  if (grid->nrow == 0 || grid->ncol == 0 || grid->npag == 0 || bottom < top) {
+    return false;
+  }
+
+  const unsigned int c0        = grid->first_page_column;
+  const unsigned int first_row = zathura_grid_lines_find(grid->rows, grid->nrow, top);
+  const unsigned int last_row  = zathura_grid_lines_find(grid->rows, grid->nrow, bottom);
+
+  /* the first row starts with empty cells before the first page */
+  const unsigned int first_cell = first_row * grid->ncol;
+  const unsigned int last_cell  = (last_row + 1) * grid->ncol - 1;
+
+  *first_page = first_cell >= c0 - 1 ? first_cell - (c0 - 1) : 0;
+  *last_page  = MIN(last_cell - (c0 - 1), grid->npag - 1);
+
+  return *first_page <= *last_page;
+}
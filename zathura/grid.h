@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef GRID_H
+#define GRID_H
+
+#include <stdbool.h>
+
+/**
+ * A row or column of the page grid
+ */
+typedef struct zathura_grid_line_s {
+  unsigned int pos;  /**< Offset of the line in pixels */
+  unsigned int size; /**< Size of the line in pixels */
+} zathura_grid_line_t;
+
+/**
+ * Page grid as laid out by the document widget. Rows and columns store their
+ * offsets as prefix sums, so all lookups are at most logarithmic in the number
+ * of pages.
+ */
+typedef struct zathura_grid_s {
+  zathura_grid_line_t* rows;      /**< Rows from top to bottom */
+  zathura_grid_line_t* cols;      /**< Columns from left to right */
+  unsigned int nrow;              /**< Number of rows */
+  unsigned int ncol;              /**< Number of columns */
+  unsigned int npag;              /**< Number of pages */
+  unsigned int first_page_column; /**< Column of the first page (first column is 1) */
+  bool right_to_left;             /**< Pages are laid out from right to left */
+} zathura_grid_t;
+
+/**
+ * Computes the offsets of the lines from their sizes
+ *
+ * @param lines The lines
+ * @param n Number of lines
+ * @param first First line whose offset is computed, the offsets of the lines
+ *   before it are kept
+ * @param padding Padding between two lines
+ */
+void zathura_grid_lines_prefix_sum(zathura_grid_line_t* lines, unsigned int n, unsigned int first,
+                                   unsigned int padding);
+
+/**
+ * Finds the first line that ends at or after the given position. Positions
+ * after the last line map to the last line.
+ *
+ * @param lines The lines
+ * @param n Number of lines, must not be 0
+ * @param pos The position in pixels
+ * @return Index of the line
+ */
+unsigned int zathura_grid_lines_find(const zathura_grid_line_t* lines, unsigned int n, double pos);
+
+/**
+ * Returns the row and column of the cell of a page
+ *
+ * @param grid The grid
+ * @param page_index The page
+ * @param row Row of the cell
+ * @param col Column of the cell as displayed, i.e. right to left layouts are
+ *   taken into account
+ */
+void zathura_grid_page_to_cell(const zathura_grid_t* grid, unsigned int page_index, unsigned int* row,
+                               unsigned int* col);
+
+/**
+ * Returns the page at a position. Positions in padding or empty cells map to
+ * the closest page that follows them.
+ *
+ * @param grid The grid
+ * @param x Horizontal position in pixels
+ * @param y Vertical position in pixels
+ * @return The page index
+ */
+unsigned int zathura_grid_position_to_page(const zathura_grid_t* grid, double x, double y);
+
+/**
+ * Returns the pages in the rows intersecting a vertical range
+ *
+ * @param grid The grid
+ * @param top Top of the range in pixels
+ * @param bottom Bottom of the range in pixels
+ * @param first_page First page of the range
+ * @param last_page Last page of the range
+ * @return true if the range contains pages, false otherwise
+ */
+bool zathura_grid_page_range(const zathura_grid_t* grid, double top, double bottom, unsigned int* first_page,
+                             unsigned int* last_page);
+
+#endif // GRID_H
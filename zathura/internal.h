@@ -29,4 +29,127 @@ struct zathura_document_information_entry_s {
  */
 const zathura_plugin_t* zathura_document_get_plugin(zathura_document_t* document);
 
+/**
+ * Sets the renderer of the document. Pages that are initialized lazily take
+ * its lock if the plugin does not support concurrent rendering, so that the
+ * plugin is never called from two threads at once.
+ *
+ * @param document The document
+ * @param renderer The renderer or NULL, a reference is kept
+ */
+void zathura_document_set_renderer(zathura_document_t* document, ZathuraRenderer* renderer);
+
+/**
+ * Returns the renderer of the document.
+ *
+ * @param document The document
+ * @return The renderer or NULL if none was set
+ */
+ZathuraRenderer* zathura_document_get_renderer(zathura_document_t* document);
+
+/**
+ * Open the document with a known hash. The hash of documents that were copied
+ * to a temporary file is computed while copying, so the file does not need to
+ * be read again.
+ *
+ * @param zathura The zathura instance
+ * @param path Path to the document
+ * @param uri URI of the document or NULL
+ * @param password Password of the document or NULL
+ * @param hash_sha256 SHA256 hash of the file or NULL to hash the file
+ * @param renderer Renderer of the document that is shown or NULL. If the
+ *   plugin does not support concurrent rendering, the document is opened
+ *   while holding its lock and the renderer is set on the new document.
+ * @param error Optional error parameter
+ * @return The document object and NULL if an error occurs
+ */
+zathura_document_t* zathura_document_open_with_hash(zathura_t* zathura, const char* path, const char* uri,
+                                                    const char* password, const uint8_t* hash_sha256,
+                                                    ZathuraRenderer* renderer, zathura_error_t* error);
+
+/**
+ * Checks whether the file still is the version the document was opened from.
+ * Plugins read the file lazily, so information taken from the document only
+ * describes that version while this is the case. This function is
+ * thread-safe.
+ *
+ * @param document The document
+ * @return true if the file is unchanged, false if it changed or its identity
+ *    could not be determined
+ */
+bool zathura_document_file_unchanged(zathura_document_t* document);
+
+/**
+ * Returns the page at the given index if its page object was created. Unlike
+ * zathura_document_get_page, this function does not create page objects.
+ *
+ * @param document The document
+ * @param index The index of the page
+ * @return The page or NULL if it was not created yet
+ */
+zathura_page_t* zathura_document_peek_page(zathura_document_t* document, unsigned int index);
+
+/**
+ * Returns the size of pages whose page objects were not created yet.
+ *
+ * @param document The document
+ * @param width Estimated width of the pages
+ * @param height Estimated height of the pages
+ */
+void zathura_document_get_page_size_estimate(zathura_document_t* document, double* width, double* height);
+
+/**
+ * Creates a page object without initializing the plugin data of the page. The
+ * plugin data is initialized on first use or by zathura_page_initialize. Until
+ * then the size of the page is only an estimate.
+ *
+ * @param document The document
+ * @param index Page number
+ * @param width Estimated width of the page
+ * @param height Estimated height of the page
+ * @return Page object or NULL if an error occurred
+ */
+zathura_page_t* zathura_page_new_lazy(zathura_document_t* document, unsigned int index, double width, double height);
+
+/**
+ * Initializes the plugin data of the page if this has not been done yet. This
+ * function is thread-safe. If the plugin does not support concurrent
+ * rendering, the lock of the renderer of the document is held while the
+ * plugin initializes the page.
+ *
+ * @param page The page object
+ * @return ZATHURA_ERROR_OK when no error occurred, otherwise see
+ *    zathura_error_t
+ */
+zathura_error_t zathura_page_initialize(zathura_page_t* page);
+
+/**
+ * Checks if the plugin data of the page has been initialized.
+ *
+ * @param page The page object
+ * @return true if the page has been initialized
+ */
+bool zathura_page_is_initialized(zathura_page_t* page);
+
+/**
+ * Computes the fingerprint of the page if this has not been done yet. It is a
+ * hash of the size, the label, the text and the placement of the images of
+ * the page. No fingerprint is taken once the file of the document has changed.
+ * Calls into the plugin, so it has to be serialized with rendering for plugins
+ * that do not support concurrent rendering.
+ *
+ * @param page The page object
+ * @return true if the page has a fingerprint, false otherwise
+ */
+bool zathura_page_update_fingerprint(zathura_page_t* page);
+
+/**
+ * Returns the fingerprint of the page computed by
+ * zathura_page_update_fingerprint. This function is thread-safe.
+ *
+ * @param page The page object
+ * @return SHA256 hash of the page content or NULL if it was not computed yet
+ */
+const uint8_t* zathura_page_get_fingerprint(zathura_page_t* page);
+
 #endif // INTERNAL_H
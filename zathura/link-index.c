@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "link-index.h"
+
+#include <glib.h>
+#include <math.h>
+#include <string.h>
+
+#define LINK_INDEX_MAX_CELLS 64
+
+struct zathura_link_index_s {
+  zathura_rectangle_t* rectangles; /**< Link areas with x1 <= x2 and y1 <= y2 */
+  unsigned int* cells;             /**< Start of the links of each cell in links, ncol * nrow + 1 entries */
+  unsigned int* links;             /**< Links of all cells, ordered by cell and link */
+  unsigned int ncol;               /**< Number of columns */
+  unsigned int nrow;               /**< Number of rows */
+  double cell_width;               /**< Width of a cell */
+  double cell_height;              /**< Height of a cell */
+};
+
+/* points outside of the page are mapped to the closest cell */
+static unsigned int link_index_cell(double pos, double size, unsigned int n) {
+  if (size <= 0 || pos <= 0 || isnan(pos) != 0) {
+    return 0;
+  }
+
+  const double cell = floor(pos / size);
+  return cell >= n ? n - 1 : (unsigned int)cell;
+}
+
+static void link_index_cell_range(const zathura_link_index_t* index, const zathura_rectangle_t* rectangle,
+                                  unsigned int* col1, unsigned int* col2, unsigned int* row1, unsigned int* row2) {
+  *col1 = link_index_cell(rectangle->x1, index->cell_width, index->ncol);
+  *col2 = link_index_cell(rectangle->x2, index->cell_width, index->ncol);
+  *row1 = link_index_cell(rectangle->y1, index->cell_height, index->nrow);
+  *row2 = link_index_cell(rectangle->y2, index->cell_height, index->nrow);
+}
+
+zathura_link_index_t* zathura_link_index_new(const zathura_rectangle_t* rectangles, unsigned int n, double width,
+                                             double height) {
+  g_return_val_if_fail(rectangles != NULL || n == 0, NULL);
+
+  zathura_link_index_t* index = g_try_malloc0(sizeof(zathura_link_index_t));
+  if (index == NULL) {
+    return NULL;
+  }
+
+  /* about one link per cell for evenly distributed links */
+  const unsigned int cells = CLAMP((unsigned int)ceil(sqrt(n)), 1, LINK_INDEX_MAX_CELLS);
+  index->ncol              = cells;
+  index->nrow              = cells;
+  index->cell_width        = width / cells;
+  index->cell_height       = height / cells;
+  index->rectangles        = g_try_malloc_n(MAX(n, 1), sizeof(zathura_rectangle_t));
+  index->cells             = g_try_malloc0_n(cells * cells + 1, sizeof(unsigned int));
+  if (index->rectangles == NULL || index->cells == NULL) {
+    zathura_link_index_free(index);
+    return NULL;
+  }
+
+  /* count the links of each cell */
+  for (unsigned int idx = 0; idx < n; ++idx) {
+    zathura_rectangle_t* rectangle = &index->rectangles[idx];
+    rectangle->x1                  = MIN(rectangles[idx].x1, rectangles[idx].x2);
+    rectangle->x2                  = MAX(rectangles[idx].x1, rectangles[idx].x2);
+    rectangle->y1                  = MIN(rectangles[idx].y1, rectangles[idx].y2);
+    rectangle->y2                  = MAX(rectangles[idx].y1, rectangles[idx].y2);
+
+    unsigned int col1, col2, row1, row2;
+    link_index_cell_range(index, rectangle, &col1, &col2, &row1, &row2);
+    for (unsigned int row = row1; row <= row2; ++row) {
+      for (unsigned int col = col1; col <= col2; ++col) {
+        ++index->cells[row * index->ncol + col + 1];
+      }
+    }
+  }
+
+  for (unsigned int cell = 0; cell < cells * cells; ++cell) {
+    index->cells[cell + 1] += index->cells[cell];
+  }
+
+  index->links = g_try_malloc_n(MAX(index->cells[cells * cells], 1), sizeof(unsigned int));
+  if (index->links == NULL) {
+    zathura_link_index_free(index);
+    return NULL;
+  }
+
+  /* fill the cells in link order, so that the first hit in a cell is the first link */
+  g_autofree unsigned int* fill = g_try_malloc_n(cells * cells, sizeof(unsigned int));
+  if (fill == NULL) {
+    zathura_link_index_free(index);
+    return NULL;
+  }
+  memcpy(fill, index->cells, cells * cells * sizeof(unsigned int));
+
+  for (unsigned int idx = 0; idx < n; ++idx) {
+    unsigned int col1, col2, row1, row2;
+    link_index_cell_range(index, &index->rectangles[idx], &col1, &col2, &row1, &row2);
+    for (unsigned int row = row1; row <= row2; ++row) {
+      for (unsigned int col = col1; col <= col2; ++col) {
+        index->links[fill[row * index->ncol + col]++] = idx;
+      }
+    }
+  }
+
+  return index;
+}
+
+void zathura_link_index_free(zathura_link_index_t* index) {
+  if (index == NULL) {
+    return;
+  }
+
+  g_free(index->links);
+  g_free(index->cells);
+  g_free(index->rectangles);
+  g_free(index);
+}
+
+int zathura_link_index_find(const zathura_link_index_t* index, double x, double y) {
+  g_return_val_if_fail(index != NULL, -1);
+
+  const unsigned int col  = link_index_cell(x, index->cell_width, index->ncol);
+  const unsigned int row  = link_index_cell(y, index->cell_height, index->nrow);
+  const unsigned int cell = row * index->ncol + col;
+
+  for (unsigned int idx = index->cells[cell]; idx < index->cells[cell + 1]; ++idx) {
+    const unsigned int link              = index->links[idx];
+    const zathura_rectangle_t* rectangle = &index->rectangles[link];
+    if (rectangle->x1 <= x && rectangle->x2 >= x && rectangle->y1 <= y && rectangle->y2 >= y) {
+      return link;
+    }
+  }
+
+  return -1;
+}
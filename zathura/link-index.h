@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef LINK_INDEX_H
+#define LINK_INDEX_H
+
+#include "types.h"
+
+typedef struct zathura_link_index_s zathura_link_index_t;
+
+/**
+ * Creates a spatial index of the link areas of a page. The page is divided
+ * into a uniform grid of cells and every cell stores the links overlapping
+ * it, so that a hit-test only has to check the links of a single cell. The
+ * rectangles are expected in unscaled and unrotated page coordinates.
+ *
+ * @param rectangles The link areas
+ * @param n Number of link areas
+ * @param width Width of the page
+ * @param height Height of the page
+ * @return The link index or NULL if an error occurred
+ */
+zathura_link_index_t* zathura_link_index_new(const zathura_rectangle_t* rectangles, unsigned int n, double width,
+                                             double height);
+
+/**
+ * Frees the link index
+ *
+ * @param index The link index
+ */
+void zathura_link_index_free(zathura_link_index_t* index);
+
+/**
+ * Finds the first link area containing a point
+ *
+ * @param index The link index
+ * @param x x coordinate of the point in page coordinates
+ * @param y y coordinate of the point in page coordinates
+ * @return Index of the link area as passed to zathura_link_index_new or -1 if
+ *   no link area contains the point
+ */
+int zathura_link_index_find(const zathura_link_index_t* index, double x, double y);
+
+#endif // LINK_INDEX_H
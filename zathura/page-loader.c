@@ -0,0 +1,158 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "page-loader.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <girara/log.h>
+
+#include "document.h"
+#include "document-widget.h"
+#include "internal.h"
+#include "page.h"
+#include "zathura.h"
+
+/* number of pages that are loaded before the layout is refined */
+#define PAGE_LOADER_BATCH_SIZE 64
+
+struct zathura_page_loader_s {
+  zathura_t* zathura;           /**< Zathura session */
+  zathura_document_t* document; /**< Document whose pages are loaded */
+  GThread* thread;              /**< Worker thread */
+  atomic_bool cancelled;        /**< Stop loading pages */
+  GMutex mutex;                 /**< Protects publish_idle and first_changed */
+  guint publish_idle;           /**< Source of a pending layout update or 0 */
+  unsigned int first_changed;   /**< First page whose size changed since the last update */
+};
+
+static gboolean page_loader_publish_idle(gpointer data) {
+  zathura_page_loader_t* loader = data;
+
+  g_mutex_lock(&loader->mutex);
+  const unsigned int first_changed = loader->first_changed;
+  loader->publish_idle             = 0;
+  loader->first_changed            = G_MAXUINT;
+  g_mutex_unlock(&loader->mutex);
+
+  zathura_document_widget_queue_layout(ZATHURA_DOCUMENT_WIDGET(loader->zathura->ui.document_widget), first_changed);
+  return G_SOURCE_REMOVE;
+}
+
+static void page_loader_publish(zathura_page_loader_t* loader, unsigned int first_changed) {
+  g_mutex_lock(&loader->mutex);
+  loader->first_changed = MIN(loader->first_changed, first_changed);
+  if (loader->publish_idle == 0) {
+    loader->publish_idle = g_idle_add(page_loader_publish_idle, loader);
+  }
+  g_mutex_unlock(&loader->mutex);
+}
+
+/* returns true if the actual size of the page differs from its estimate */
+static bool page_loader_load(zathura_page_loader_t* loader, unsigned int index) {
+  zathura_page_t* page = zathura_document_get_page(loader->document, index);
+  if (page == NULL || zathura_page_is_initialized(page) == true) {
+    return false;
+  }
+
+  const double width  = zathura_page_get_width(page);
+  const double height = zathura_page_get_height(page);
+
+  /* serialized with rendering for plugins that are not thread-safe */
+  if (zathura_page_initialize(page) != ZATHURA_ERROR_OK) {
+    return false;
+  }
+
+  return fabs(zathura_page_get_width(page) - width) > DBL_EPSILON ||
+         fabs(zathura_page_get_height(page) - height) > DBL_EPSILON;
+}
+
+static gpointer page_loader_thread(gpointer data) {
+  zathura_page_loader_t* loader      = data;
+  const unsigned int number_of_pages = zathura_document_get_number_of_pages(loader->document);
+
+  unsigned int current       = zathura_document_get_current_page_number(loader->document);
+  unsigned int distance      = 0;
+  unsigned int batch         = 0;
+  unsigned int first_changed = G_MAXUINT;
+
+  /* load pages alternating after and before the current page */
+  while (atomic_load(&loader->cancelled) == false && (current + distance < number_of_pages || distance <= current)) {
+    /* start over from the current page if it changed, loaded pages are skipped */
+    const unsigned int current_page = zathura_document_get_current_page_number(loader->document);
+    if (current_page != current) {
+      current  = current_page;
+      distance = 0;
+    }
+
+    if (current + distance < number_of_pages) {
+      if (page_loader_load(loader, current + distance) == true) {
+        first_changed = MIN(first_changed, current + distance);
+      }
+      ++batch;
+    }
+    if (distance != 0 && distance <= current) {
+      if (page_loader_load(loader, current - distance) == true) {
+        first_changed = MIN(first_changed, current - distance);
+      }
+      ++batch;
+    }
+    ++distance;
+
+    if (batch >= PAGE_LOADER_BATCH_SIZE) {
+      if (first_changed != G_MAXUINT) {
+        page_loader_publish(loader, first_changed);
+      }
+      batch         = 0;
+      first_changed = G_MAXUINT;
+    }
+  }
+
+  if (first_changed != G_MAXUINT) {
+    page_loader_publish(loader, first_changed);
+  }
+
+  girara_debug("page loader finished");
+  return NULL;
+}
+
+zathura_page_loader_t* zathura_page_loader_new(zathura_t* zathura) {
+  g_return_val_if_fail(zathura != NULL && zathura->document != NULL && zathura->sync.render_thread != NULL, NULL);
+
+  zathura_page_loader_t* loader = g_try_malloc0(sizeof(zathura_page_loader_t));
+  if (loader == NULL) {
+    return NULL;
+  }
+
+  loader->zathura  = zathura;
+  loader->document = zathura->document;
+  atomic_init(&loader->cancelled, false);
+  g_mutex_init(&loader->mutex);
+  loader->first_changed = G_MAXUINT;
+
+  g_autoptr(GError) error = NULL;
+  loader->thread          = g_thread_try_new("page-loader", page_loader_thread, loader, &error);
+  if (loader->thread == NULL) {
+    girara_error("Failed to start page loader: %s", error->message);
+    zathura_page_loader_free(loader);
+    return NULL;
+  }
+
+  return loader;
+}
+
+void zathura_page_loader_free(zathura_page_loader_t* loader) {
+  if (loader == NULL) {
+    return;
+  }
+
+  atomic_store(&loader->cancelled, true);
+  if (loader->thread != NULL) {
+    g_thread_join(loader->thread);
+  }
+
+  /* the thread is gone, so no new updates can be scheduled */
+  g_clear_handle_id(&loader->publish_idle, g_source_remove);
+  g_mutex_clear(&loader->mutex);
+  g_free(loader);
+}
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef PAGE_LOADER_H
+#define PAGE_LOADER_H
+
+#include "types.h"
+
+typedef struct zathura_page_loader_s zathura_page_loader_t;
+
+/**
+ * Starts to initialize all pages of the open document on a worker thread, so
+ * that their sizes and labels are known. Pages close to the current page are
+ * initialized first. The layout of the document widget is updated in batches
+ * whenever the size of a page differed from its estimate.
+ *
+ * @param zathura The zathura session
+ * @return The page loader or NULL if an error occurred
+ */
+zathura_page_loader_t* zathura_page_loader_new(zathura_t* zathura);
+
+/**
+ * Stops the page loader and frees it. Blocks until the worker thread has
+ * finished initializing the current page.
+ *
+ * @param loader The page loader
+ */
+void zathura_page_loader_free(zathura_page_loader_t* loader);
+
+#endif // PAGE_LOADER_H
@@ -11,33 +11,54 @@
 #include <math.h>
 
 #include "links.h"
+#include "link-index.h"
 #include "page.h"
 #include "render.h"
 #include "utils.h"
 #include "shortcuts.h"
 #include "zathura.h"
 #include "document-widget.h"
+#include "adjustment.h"
+#include "internal.h"
+
+/* pages larger than this number of device pixels are rendered in tiles */
+#define TILE_THRESHOLD (4096 * 4096)
+/* cairo image surfaces cannot be larger than this in either dimension */
+#define TILE_MAX_DIMENSION 32767
+/* edge length of a tile in user pixels */
+#define TILE_SIZE 512
+/* number of tiles rendered ahead around the visible part of a page */
+#define TILE_MARGIN 1
+/* number of tiles kept per page in addition to the visible ones */
+#define TILE_CACHE_SIZE 64
 
 typedef struct zathura_page_widget_private_s {
   zathura_page_t* page;                 /**< Page object */
   zathura_t* zathura;                   /**< Zathura object */
   cairo_surface_t* surface;             /**< Cairo surface */
+  bool surface_is_preview;              /**< The surface is a low resolution preview */
   cairo_surface_t* thumbnail;           /**< Cairo surface */
   ZathuraRenderRequest* render_request; /* Request object */
   bool cached;                          /**< Cached state */
 
   struct {
-    girara_list_t* list; /**< List of links on the page */
-    gboolean retrieved;  /**< True if we already tried to retrieve the list of links */
-    gboolean draw;       /**< True if links should be drawn */
-    unsigned int offset; /**< Offset to the links */
-    unsigned int n;      /**< Number */
+    GHashTable* table;   /**< Tiles of the page by their index */
+    unsigned int width;  /**< Width of the page the tiles belong to */
+    unsigned int height; /**< Height of the page the tiles belong to */
+    guint64 generation;  /**< Number of tile draws, used for eviction */
+  } tiles;
+
+  struct {
+    girara_list_t* list;         /**< List of links on the page */
+    zathura_link_index_t* index; /**< Spatial index of the links in page coordinates */
+    gboolean retrieved;          /**< True if we already tried to retrieve the list of links */
+    gboolean draw;               /**< True if links should be drawn */
+    unsigned int offset;         /**< Offset to the links */
+    unsigned int n;              /**< Number */
   } links;
 
   struct {
-    girara_list_t* list; /**< A list if there are search results that should be drawn */
-    int current;         /**< The index of the current search result */
-    gboolean draw;       /**< Draw search results */
+    gboolean draw; /**< Draw search results */
   } search;
 
   struct {
@@ -76,7 +97,7 @@ static void zathura_page_widget_dispose(GObject* object);
 static void zathura_page_widget_set_property(GObject* object, guint prop_id, const GValue* value, GParamSpec* pspec);
 static void zathura_page_widget_get_property(GObject* object, guint prop_id, GValue* value, GParamSpec* pspec);
 static void redraw_rect(ZathuraPageWidget* widget, zathura_rectangle_t* rectangle);
-static void redraw_all_rects(ZathuraPageWidget* widget, girara_list_t* rectangles);
+static void page_widget_retrieve_links(ZathuraPageWidgetPrivate* priv);
 static void evaluate_link_at_mouse_position(ZathuraPageWidget* widget, int oldx, int oldy);
 static void zathura_page_widget_popup_menu(GtkWidget* widget, GdkEventButton* event);
 static gboolean cb_zathura_page_widget_button_press_event(GtkWidget* widget, GdkEventButton* button);
@@ -89,6 +110,8 @@ static void cb_menu_image_save(GtkMenuItem* item, ZathuraPageWidget* page);
 static void cb_update_surface(ZathuraRenderRequest* request, cairo_surface_t* surface, void* data);
 static void cb_cache_added(ZathuraRenderRequest* request, void* data);
 static void cb_cache_invalidated(ZathuraRenderRequest* request, void* data);
+static void cb_tile_update_surface(ZathuraRenderRequest* request, cairo_surface_t* surface, void* data);
+static void page_widget_check_size(ZathuraPageWidget* widget);
 static bool surface_small_enough(cairo_surface_t* surface, size_t max_size, cairo_surface_t* old);
 static cairo_surface_t* draw_thumbnail_image(cairo_surface_t* surface, size_t max_size);
 
@@ -99,9 +122,6 @@ enum properties_e {
   PROP_DRAW_LINKS,
   PROP_LINKS_OFFSET,
   PROP_LINKS_NUMBER,
-  PROP_SEARCH_RESULTS,
-  PROP_SEARCH_RESULTS_LENGTH,
-  PROP_SEARCH_RESULTS_CURRENT,
   PROP_DRAW_SEARCH_RESULTS,
   PROP_LAST_VIEW,
   PROP_DRAW_SIGNATURES,
@@ -153,17 +173,6 @@ static void zathura_page_widget_class_init(ZathuraPageWidgetClass* class) {
   g_object_class_install_property(object_class, PROP_LINKS_NUMBER,
                                   g_param_spec_int("number-of-links", "number-of-links", "Number of links", 0, INT_MAX,
                                                    0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
-  g_object_class_install_property(object_class, PROP_SEARCH_RESULTS,
-                                  g_param_spec_pointer("search-results", "search-results",
-                                                       "Set to the list of search results",
-                                                       G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
-  g_object_class_install_property(object_class, PROP_SEARCH_RESULTS_CURRENT,
-                                  g_param_spec_int("search-current", "search-current", "The current search result", -1,
-                                                   INT_MAX, 0,
-                                                   G_PARAM_WRITABLE | G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
-  g_object_class_install_property(object_class, PROP_SEARCH_RESULTS_LENGTH,
-                                  g_param_spec_int("search-length", "search-length", "The number of search results", -1,
-                                                   INT_MAX, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property(object_class, PROP_DRAW_SEARCH_RESULTS,
                                   g_param_spec_boolean("draw-search-results", "draw-search-results",
                                                        "Set to true if search results should be drawn", FALSE,
@@ -195,19 +204,24 @@ static void zathura_page_widget_init(ZathuraPageWidget* widget) {
   priv->page                     = NULL;
   priv->zathura                  = NULL;
   priv->surface                  = NULL;
+  priv->surface_is_preview       = false;
   priv->thumbnail                = NULL;
   priv->render_request           = NULL;
   priv->cached                   = false;
 
+  priv->tiles.table      = NULL;
+  priv->tiles.width      = 0;
+  priv->tiles.height     = 0;
+  priv->tiles.generation = 0;
+
   priv->links.list      = NULL;
+  priv->links.index     = NULL;
   priv->links.retrieved = false;
   priv->links.draw      = false;
   priv->links.offset    = 0;
   priv->links.n         = 0;
 
-  priv->search.list    = NULL;
-  priv->search.current = INT_MAX;
-  priv->search.draw    = false;
+  priv->search.draw = false;
 
   priv->selection.list = NULL;
   priv->selection.draw = false;
@@ -259,6 +273,11 @@ static void zathura_page_widget_dispose(GObject* object) {
   ZathuraPageWidget* widget      = ZATHURA_PAGE_WIDGET(object);
   ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
 
+  g_clear_pointer(&priv->tiles.table, g_hash_table_unref);
+  if (priv->render_request != NULL) {
+    /* released widgets do not need their pending render jobs anymore */
+    zathura_render_request_abort(priv->render_request);
+  }
   g_clear_object(&priv->render_request);
 
   G_OBJECT_CLASS(zathura_page_widget_parent_class)->dispose(object);
@@ -270,8 +289,8 @@ static void zathura_page_widget_finalize(GObject* object) {
 
   cairo_surface_destroy(priv->surface);
   cairo_surface_destroy(priv->thumbnail);
-  girara_list_free(priv->search.list);
   girara_list_free(priv->links.list);
+  zathura_link_index_free(priv->links.index);
   girara_list_free(priv->signatures.list);
 
   G_OBJECT_CLASS(zathura_page_widget_parent_class)->finalize(object);
@@ -351,6 +370,17 @@ static cairo_text_extents_t get_text_extents(const char* string, zathura_t* zath
   return text;
 }
 
+static bool page_widget_have_search_results(ZathuraPageWidgetPrivate* priv) {
+  zathura_search_results_t* results = priv->zathura->global.search_results;
+  if (results == NULL || zathura_page_get_document(priv->page) != priv->zathura->document) {
+    return false;
+  }
+
+  unsigned int length = 0;
+  zathura_search_results_get_page(results, zathura_page_get_index(priv->page), &length);
+  return length != 0;
+}
+
 static void zathura_page_widget_set_property(GObject* object, guint prop_id, const GValue* value, GParamSpec* pspec) {
   ZathuraPageWidget* pageview    = ZATHURA_PAGE_WIDGET(object);
   ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(pageview);
@@ -365,10 +395,8 @@ static void zathura_page_widget_set_property(GObject* object, guint prop_id, con
   case PROP_DRAW_LINKS:
     priv->links.draw = g_value_get_boolean(value);
     /* get links */
-    if (priv->links.draw == TRUE && priv->links.retrieved == FALSE) {
-      priv->links.list      = zathura_page_links_get(priv->page, NULL);
-      priv->links.retrieved = TRUE;
-      priv->links.n         = (priv->links.list == NULL) ? 0 : girara_list_size(priv->links.list);
+    if (priv->links.draw == TRUE) {
+      page_widget_retrieve_links(priv);
     }
 
     if (priv->links.retrieved == TRUE && priv->links.list != NULL) {
@@ -393,38 +421,6 @@ static void zathura_page_widget_set_property(GObject* object, guint prop_id, con
   case PROP_LINKS_OFFSET:
     priv->links.offset = g_value_get_int(value);
     break;
-  case PROP_SEARCH_RESULTS:
-    if (priv->search.list != NULL && priv->search.draw) {
-      redraw_all_rects(pageview, priv->search.list);
-    }
-    girara_list_free(priv->search.list);
-    priv->search.list = g_value_get_pointer(value);
-    if (priv->search.list != NULL && priv->search.draw) {
-      priv->links.draw = FALSE;
-      redraw_all_rects(pageview, priv->search.list);
-    }
-    priv->search.current = -1;
-    break;
-  case PROP_SEARCH_RESULTS_CURRENT: {
-    g_return_if_fail(priv->search.list != NULL);
-    if (priv->search.current >= 0 && priv->search.current < (signed)girara_list_size(priv->search.list)) {
-      zathura_rectangle_t* rect     = girara_list_nth(priv->search.list, priv->search.current);
-      zathura_rectangle_t rectangle = recalc_rectangle(priv->page, *rect);
-      redraw_rect(pageview, &rectangle);
-    }
-    int val = g_value_get_int(value);
-    if (val < 0) {
-      priv->search.current = girara_list_size(priv->search.list);
-    } else {
-      priv->search.current = val;
-      if (priv->search.draw == TRUE && val >= 0 && val < (signed)girara_list_size(priv->search.list)) {
-        zathura_rectangle_t* rect     = girara_list_nth(priv->search.list, priv->search.current);
-        zathura_rectangle_t rectangle = recalc_rectangle(priv->page, *rect);
-        redraw_rect(pageview, &rectangle);
-      }
-    }
-    break;
-  }
   case PROP_DRAW_SEARCH_RESULTS:
     priv->search.draw = g_value_get_boolean(value);
 
@@ -435,7 +431,7 @@ static void zathura_page_widget_set_property(GObject* object, guint prop_id, con
      * redrawn without highlighting.
      */
 
-    if (priv->search.list != NULL && zathura_page_get_visibility(priv->page)) {
+    if (page_widget_have_search_results(priv) == true && zathura_page_get_visibility(priv->page)) {
       gtk_widget_queue_draw(GTK_WIDGET(object));
     }
     break;
@@ -472,15 +468,6 @@ static void zathura_page_widget_get_property(GObject* object, guint prop_id, GVa
   case PROP_LINKS_NUMBER:
     g_value_set_int(value, priv->links.n);
     break;
-  case PROP_SEARCH_RESULTS_LENGTH:
-    g_value_set_int(value, priv->search.list == NULL ? 0 : girara_list_size(priv->search.list));
-    break;
-  case PROP_SEARCH_RESULTS_CURRENT:
-    g_value_set_int(value, priv->search.list == NULL ? -1 : priv->search.current);
-    break;
-  case PROP_SEARCH_RESULTS:
-    g_value_set_pointer(value, priv->search.list);
-    break;
   case PROP_DRAW_SEARCH_RESULTS:
     g_value_set_boolean(value, priv->search.draw);
     break;
@@ -503,23 +490,286 @@ static zathura_device_factors_t get_safe_device_factors(cairo_surface_t* surface
   return factors;
 }
 
+static void get_render_loading_colors(ZathuraPageWidgetPrivate* priv, GdkRGBA* color_fg, GdkRGBA* color_bg) {
+  *color_fg = priv->zathura->ui.colors.render_loading_fg;
+  *color_bg = priv->zathura->ui.colors.render_loading_bg;
+  if (zathura_renderer_recolor_enabled(priv->zathura->sync.render_thread) == true) {
+    zathura_renderer_get_recolor_colors(priv->zathura->sync.render_thread, color_bg, color_fg);
+  }
+}
+
+static void paint_thumbnail(cairo_t* cairo, cairo_surface_t* thumbnail, unsigned int pwidth, unsigned int pheight) {
+  const unsigned int height = cairo_image_surface_get_height(thumbnail);
+  const unsigned int width  = cairo_image_surface_get_width(thumbnail);
+
+  cairo_save(cairo);
+  cairo_scale(cairo, pwidth / (double)width, pheight / (double)height);
+  cairo_set_source_surface(cairo, thumbnail, 0, 0);
+  cairo_pattern_set_extend(cairo_get_source(cairo), CAIRO_EXTEND_PAD);
+  if (pwidth < width || pheight < height) {
+    /* pixman bilinear downscaling is slow */
+    cairo_pattern_set_filter(cairo_get_source(cairo), CAIRO_FILTER_FAST);
+  }
+  cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
+  cairo_paint(cairo);
+  cairo_restore(cairo);
+}
+
+/* tiles */
+
+typedef struct page_widget_tile_s {
+  ZathuraPageWidget* widget;     /**< Page widget owning the tile */
+  ZathuraRenderer* renderer;     /**< Renderer accounting the memory of the tile */
+  ZathuraRenderRequest* request; /**< Render request of the tile */
+  cairo_surface_t* surface;      /**< Rendered tile or NULL */
+  unsigned int x;                /**< x coordinate in user pixels */
+  unsigned int y;                /**< y coordinate in user pixels */
+  guint64 last_used;             /**< Generation of the last draw using the tile */
+} page_widget_tile_t;
+
+static size_t surface_size(cairo_surface_t* surface) {
+  return (size_t)cairo_image_surface_get_stride(surface) * cairo_image_surface_get_height(surface);
+}
+
+static void page_widget_tile_free(void* data) {
+  page_widget_tile_t* tile = data;
+
+  /* the renderer might still hold a job for the request */
+  g_signal_handlers_disconnect_by_data(tile->request, tile);
+  zathura_render_request_abort(tile->request);
+  g_object_unref(tile->request);
+  if (tile->surface != NULL) {
+    zathura_renderer_tile_cache_update_size(tile->renderer, 0, surface_size(tile->surface));
+    cairo_surface_destroy(tile->surface);
+  }
+  g_object_unref(tile->renderer);
+  g_free(tile);
+}
+
+static void cb_tile_update_surface(ZathuraRenderRequest* UNUSED(request), cairo_surface_t* surface, void* data) {
+  page_widget_tile_t* tile = data;
+
+  size_t removed = 0;
+  if (tile->surface != NULL) {
+    removed = surface_size(tile->surface);
+    cairo_surface_destroy(tile->surface);
+  }
+  tile->surface = cairo_surface_reference(surface);
+  /* tiles exceeding the memory limit are evicted on the next draw */
+  zathura_renderer_tile_cache_update_size(tile->renderer, surface_size(surface), removed);
+  page_widget_check_size(tile->widget);
+  gtk_widget_queue_draw(GTK_WIDGET(tile->widget));
+}
+
+/**
+ * Checks whether the page is too large to be rendered at once. The unrotated
+ * size of the page in user pixels is returned.
+ */
+static bool page_widget_use_tiles(ZathuraPageWidgetPrivate* priv, unsigned int* width, unsigned int* height) {
+  zathura_document_t* document = zathura_page_get_document(priv->page);
+  page_calc_height_width(document, priv->page, height, width, false);
+
+  const zathura_device_factors_t device = zathura_document_get_device_factors(document);
+  const double device_width             = *width * device.x;
+  const double device_height            = *height * device.y;
+  return device_width * device_height > TILE_THRESHOLD || device_width > TILE_MAX_DIMENSION ||
+         device_height > TILE_MAX_DIMENSION;
+}
+
+static void page_widget_clear_tiles(ZathuraPageWidgetPrivate* priv) {
+  if (priv->tiles.table != NULL) {
+    g_hash_table_remove_all(priv->tiles.table);
+  }
+}
+
+static bool page_widget_have_tiles(ZathuraPageWidgetPrivate* priv) {
+  if (priv->tiles.table == NULL) {
+    return false;
+  }
+
+  GHashTableIter iter;
+  void* value = NULL;
+  g_hash_table_iter_init(&iter, priv->tiles.table);
+  while (g_hash_table_iter_next(&iter, NULL, &value) == TRUE) {
+    const page_widget_tile_t* tile = value;
+    if (tile->surface != NULL) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static page_widget_tile_t* page_widget_get_tile(ZathuraPageWidget* widget, unsigned int column, unsigned int row,
+                                                unsigned int columns) {
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+  if (priv->tiles.table == NULL) {
+    priv->tiles.table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, page_widget_tile_free);
+  }
+
+  void* key                = GUINT_TO_POINTER(row * columns + column);
+  page_widget_tile_t* tile = g_hash_table_lookup(priv->tiles.table, key);
+  if (tile != NULL) {
+    return tile;
+  }
+
+  tile = g_try_malloc0(sizeof(page_widget_tile_t));
+  if (tile == NULL) {
+    return NULL;
+  }
+
+  tile->widget  = widget;
+  tile->x       = column * TILE_SIZE;
+  tile->y       = row * TILE_SIZE;
+  tile->request = zathura_render_request_new(priv->zathura->sync.render_thread, priv->page);
+  if (tile->request == NULL) {
+    g_free(tile);
+    return NULL;
+  }
+  tile->renderer = g_object_ref(priv->zathura->sync.render_thread);
+
+  zathura_render_request_set_tile(tile->request, tile->x, tile->y, TILE_SIZE, TILE_SIZE);
+  g_signal_connect(tile->request, "completed", G_CALLBACK(cb_tile_update_surface), tile);
+  g_hash_table_insert(priv->tiles.table, key, tile);
+
+  return tile;
+}
+
+static void page_widget_evict_tiles(ZathuraPageWidgetPrivate* priv, guint64 generation) {
+  /* tiles count towards the memory limit of the page cache */
+  ZathuraRenderer* renderer = priv->zathura->sync.render_thread;
+  while (g_hash_table_size(priv->tiles.table) > TILE_CACHE_SIZE ||
+         (g_hash_table_size(priv->tiles.table) > 0 && zathura_renderer_cache_memory_exceeded(renderer) == true)) {
+    /* find the least recently used tile that is not part of the current draw */
+    GHashTableIter iter;
+    void* key                  = NULL;
+    void* value                = NULL;
+    void* oldest_key           = NULL;
+    page_widget_tile_t* oldest = NULL;
+
+    g_hash_table_iter_init(&iter, priv->tiles.table);
+    while (g_hash_table_iter_next(&iter, &key, &value) == TRUE) {
+      page_widget_tile_t* tile = value;
+      if (tile->last_used < generation && (oldest == NULL || tile->last_used < oldest->last_used)) {
+        oldest     = tile;
+        oldest_key = key;
+      }
+    }
+
+    if (oldest == NULL) {
+      break;
+    }
+    g_hash_table_remove(priv->tiles.table, oldest_key);
+  }
+}
+
+/**
+ * Draws the tiles covering the clip region of cairo and requests the missing
+ * ones, including a margin around the clip region. cairo is expected to be
+ * transformed to the unrotated page.
+ */
+static void page_widget_draw_tiles(ZathuraPageWidget* widget, cairo_t* cairo, unsigned int width,
+                                   unsigned int height) {
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+
+  /* tiles rendered for another zoom level do not fit anymore */
+  if (priv->tiles.width != width || priv->tiles.height != height) {
+    page_widget_clear_tiles(priv);
+    priv->tiles.width  = width;
+    priv->tiles.height = height;
+  }
+
+  double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  cairo_clip_extents(cairo, &x1, &y1, &x2, &y2);
+
+  const unsigned int columns      = (width + TILE_SIZE - 1) / TILE_SIZE;
+  const unsigned int rows         = (height + TILE_SIZE - 1) / TILE_SIZE;
+  const unsigned int column_start = MAX(floor(x1 / TILE_SIZE) - TILE_MARGIN, 0);
+  const unsigned int column_end   = MIN(ceil(x2 / TILE_SIZE) + TILE_MARGIN, columns);
+  const unsigned int row_start    = MAX(floor(y1 / TILE_SIZE) - TILE_MARGIN, 0);
+  const unsigned int row_end      = MIN(ceil(y2 / TILE_SIZE) + TILE_MARGIN, rows);
+
+  const guint64 generation = ++priv->tiles.generation;
+  const gint64 now         = g_get_real_time();
+
+  for (unsigned int row = row_start; row < row_end; ++row) {
+    for (unsigned int column = column_start; column < column_end; ++column) {
+      page_widget_tile_t* tile = page_widget_get_tile(widget, column, row, columns);
+      if (tile == NULL) {
+        continue;
+      }
+      tile->last_used = generation;
+
+      const bool visible = tile->x < x2 && tile->x + TILE_SIZE > x1 && tile->y < y2 && tile->y + TILE_SIZE > y1;
+      if (tile->surface != NULL) {
+        if (visible == true) {
+          cairo_set_source_surface(cairo, tile->surface, tile->x, tile->y);
+          cairo_rectangle(cairo, tile->x, tile->y, TILE_SIZE, TILE_SIZE);
+          cairo_fill(cairo);
+        }
+      } else {
+        /* render the visible tiles before the ones in the margin */
+        zathura_render_request(tile->request, visible == true ? now : now + G_USEC_PER_SEC);
+      }
+    }
+  }
+
+  page_widget_evict_tiles(priv, generation);
+}
+
+/**
+ * Updates the layout if the estimated size of the page was off. Pages are
+ * initialized by the page loader or by the render thread, never while drawing,
+ * so the page is drawn with the estimate until then and this is checked again
+ * once it was rendered.
+ */
+static void page_widget_check_size(ZathuraPageWidget* widget) {
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+  if (zathura_page_is_initialized(priv->page) == false || zathura_page_initialize(priv->page) != ZATHURA_ERROR_OK) {
+    return;
+  }
+
+  unsigned int page_height = 0;
+  unsigned int page_width  = 0;
+  page_calc_height_width(zathura_page_get_document(priv->page), priv->page, &page_height, &page_width, true);
+
+  int width  = 0;
+  int height = 0;
+  gtk_widget_get_size_request(GTK_WIDGET(widget), &width, &height);
+  if (width != (int)page_width || height != (int)page_height) {
+    girara_debug("size estimate of page %u was off, updating layout", zathura_page_get_index(priv->page) + 1);
+    zathura_document_widget_queue_layout(ZATHURA_DOCUMENT_WIDGET(priv->zathura->ui.document_widget),
+                                         zathura_page_get_index(priv->page));
+  }
+}
+
 static gboolean zathura_page_widget_draw(GtkWidget* widget, cairo_t* cairo) {
   ZathuraPageWidget* page        = ZATHURA_PAGE_WIDGET(widget);
   ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(page);
   zathura_t* zathura             = priv->zathura;
 
+  page_widget_check_size(page);
+
   zathura_document_t* document   = zathura_page_get_document(priv->page);
   const unsigned int page_height = gtk_widget_get_allocated_height(widget);
   const unsigned int page_width  = gtk_widget_get_allocated_width(widget);
 
-  bool surface_exists = priv->surface != NULL || priv->thumbnail != NULL;
+  /* large pages are drawn from tiles on top of the thumbnail */
+  unsigned int tiled_width  = 0;
+  unsigned int tiled_height = 0;
+  const bool tiled          = page_widget_use_tiles(priv, &tiled_width, &tiled_height);
+
+  bool surface_exists = tiled == true || priv->surface != NULL || priv->thumbnail != NULL;
 
   if (zathura->predecessor_document != NULL && zathura->predecessor_pages != NULL && !surface_exists) {
     unsigned int page_index = zathura_page_get_index(priv->page);
 
-    if (page_index < zathura_document_get_number_of_pages(priv->zathura->predecessor_document)) {
+    /* only pages that had a widget when the document was closed can be used */
+    if (page_index < zathura_document_get_number_of_pages(priv->zathura->predecessor_document) &&
+        priv->zathura->predecessor_pages[page_index] != NULL) {
       /* render real page */
       zathura_render_request(priv->render_request, g_get_real_time());
+      zathura_renderer_page_cache_count(zathura->sync.render_thread, false);
 
       girara_debug("using predecessor page for idx %d", page_index);
       document = priv->zathura->predecessor_document;
@@ -549,37 +799,52 @@ static gboolean zathura_page_widget_draw(GtkWidget* widget, cairo_t* cairo) {
       cairo_rotate(cairo, rotation * G_PI / 180.0);
     }
 
-    if (priv->surface != NULL) {
+    unsigned int pheight = (rotation % 180 ? page_width : page_height);
+    unsigned int pwidth  = (rotation % 180 ? page_height : page_width);
+
+    if (tiled == true) {
+      if (priv->thumbnail != NULL) {
+        /* note: this always returns 1 and 1 if Cairo too old for device scale API */
+        zathura_device_factors_t device = get_safe_device_factors(priv->thumbnail);
+        paint_thumbnail(cairo, priv->thumbnail, pwidth * device.x, pheight * device.y);
+      } else {
+        GdkRGBA color_fg;
+        GdkRGBA color_bg;
+        get_render_loading_colors(priv, &color_fg, &color_bg);
+        cairo_set_source_rgba(cairo, color_bg.red, color_bg.green, color_bg.blue, color_bg.alpha);
+        cairo_paint(cairo);
+      }
+
+      page_widget_draw_tiles(page, cairo, tiled_width, tiled_height);
+      cairo_restore(cairo);
+    } else if (priv->surface != NULL) {
       cairo_set_source_surface(cairo, priv->surface, 0, 0);
       cairo_paint(cairo);
       cairo_restore(cairo);
+      /* the full resolution pass might have been aborted */
+      if (page == ZATHURA_PAGE_WIDGET(widget)) {
+        zathura_renderer_page_cache_count(zathura->sync.render_thread, priv->surface_is_preview == false);
+      }
+      if (priv->surface_is_preview == true && page == ZATHURA_PAGE_WIDGET(widget)) {
+        zathura_render_request(priv->render_request, g_get_real_time());
+      }
     } else {
       girara_debug("drawing thumbnail for page %d", zathura_page_get_index(priv->page));
 
-      const unsigned int height = cairo_image_surface_get_height(priv->thumbnail);
-      const unsigned int width  = cairo_image_surface_get_width(priv->thumbnail);
-      unsigned int pheight      = (rotation % 180 ? page_width : page_height);
-      unsigned int pwidth       = (rotation % 180 ? page_height : page_width);
-
       /* note: this always returns 1 and 1 if Cairo too old for device scale API */
       zathura_device_factors_t device = get_safe_device_factors(priv->thumbnail);
       pwidth *= device.x;
       pheight *= device.y;
 
-      cairo_scale(cairo, pwidth / (double)width, pheight / (double)height);
-      cairo_set_source_surface(cairo, priv->thumbnail, 0, 0);
-      cairo_pattern_set_extend(cairo_get_source(cairo), CAIRO_EXTEND_PAD);
-      if (pwidth < width || pheight < height) {
-        /* pixman bilinear downscaling is slow */
-        cairo_pattern_set_filter(cairo_get_source(cairo), CAIRO_FILTER_FAST);
-      }
-      cairo_set_operator(cairo, CAIRO_OPERATOR_SOURCE);
-      cairo_paint(cairo);
+      paint_thumbnail(cairo, priv->thumbnail, pwidth, pheight);
       cairo_restore(cairo);
       /* All but the last jobs requested here are aborted during zooming.
        * Processing and aborting smaller jobs first improves responsiveness. */
       const gint64 penalty = (gint64)pwidth * (gint64)pheight;
       zathura_render_request(priv->render_request, g_get_real_time() + penalty);
+      if (page == ZATHURA_PAGE_WIDGET(widget)) {
+        zathura_renderer_page_cache_count(zathura->sync.render_thread, false);
+      }
       return FALSE;
     }
 
@@ -675,14 +940,26 @@ static gboolean zathura_page_widget_draw(GtkWidget* widget, cairo_t* cairo) {
       g_object_unref(layout);
     }
 
-    /* draw search results */
-    if (priv->search.list != NULL && priv->search.draw == true) {
-      for (size_t idx = 0; idx != girara_list_size(priv->search.list); ++idx) {
-        zathura_rectangle_t* rect     = girara_list_nth(priv->search.list, idx);
-        zathura_rectangle_t rectangle = recalc_rectangle(priv->page, *rect);
+    /* draw search results, they belong to the open document */
+    const unsigned int page_index      = zathura_page_get_index(priv->page);
+    unsigned int number_of_results     = 0;
+    const zathura_rectangle_t* results = NULL;
+    if (priv->search.draw == true && zathura->global.search_results != NULL && document == zathura->document) {
+      results = zathura_search_results_get_page(zathura->global.search_results, page_index, &number_of_results);
+    }
+    if (number_of_results != 0) {
+      unsigned int current_page  = 0;
+      unsigned int current_index = 0;
+      if (zathura_search_results_get_current(zathura->global.search_results, &current_page, &current_index) == false ||
+          current_page != page_index) {
+        current_index = number_of_results;
+      }
+
+      for (unsigned int idx = 0; idx != number_of_results; ++idx) {
+        zathura_rectangle_t rectangle = recalc_rectangle(priv->page, results[idx]);
 
         /* draw position */
-        if ((int)idx == priv->search.current) {
+        if (idx == current_index) {
           const GdkRGBA color = zathura->ui.colors.highlight_color_active;
           cairo_set_source_rgba(cairo, color.red, color.green, color.blue, color.alpha);
         } else {
@@ -714,11 +991,9 @@ static gboolean zathura_page_widget_draw(GtkWidget* widget, cairo_t* cairo) {
   } else {
     girara_debug("rendering loading screen, flicker might be happening");
 
-    GdkRGBA color_fg = priv->zathura->ui.colors.render_loading_fg;
-    GdkRGBA color_bg = priv->zathura->ui.colors.render_loading_bg;
-    if (zathura_renderer_recolor_enabled(priv->zathura->sync.render_thread) == true) {
-      zathura_renderer_get_recolor_colors(priv->zathura->sync.render_thread, &color_bg, &color_fg);
-    }
+    GdkRGBA color_fg;
+    GdkRGBA color_bg;
+    get_render_loading_colors(priv, &color_fg, &color_bg);
 
     /* set background color and draw */
     cairo_set_source_rgba(cairo, color_bg.red, color_bg.green, color_bg.blue, color_bg.alpha);
@@ -743,8 +1018,17 @@ static gboolean zathura_page_widget_draw(GtkWidget* widget, cairo_t* cairo) {
       cairo_show_text(cairo, text);
     }
 
-    /* render real page */
-    zathura_render_request(priv->render_request, g_get_real_time());
+    /* render real page, showing a quick preview first since there is nothing else to show */
+    bool render_preview = true;
+    girara_setting_get(priv->zathura->ui.session, "render-preview", &render_preview);
+    if (render_preview == true) {
+      zathura_render_request_with_preview(priv->render_request, g_get_real_time());
+    } else {
+      zathura_render_request(priv->render_request, g_get_real_time());
+    }
+    if (page == ZATHURA_PAGE_WIDGET(widget)) {
+      zathura_renderer_page_cache_count(zathura->sync.render_thread, false);
+    }
   }
   return FALSE;
 }
@@ -834,6 +1118,7 @@ void zathura_page_widget_update_surface(ZathuraPageWidget* widget, cairo_surface
     cairo_surface_destroy(priv->surface);
     priv->surface = NULL;
   }
+  priv->surface_is_preview = zathura_render_surface_is_preview(surface);
   if (surface != NULL) {
     priv->surface = cairo_surface_reference(surface);
 
@@ -858,6 +1143,8 @@ void zathura_page_widget_update_surface(ZathuraPageWidget* widget, cairo_surface
 static void cb_update_surface(ZathuraRenderRequest* UNUSED(request), cairo_surface_t* surface, void* data) {
   ZathuraPageWidget* widget = data;
   g_return_if_fail(ZATHURA_IS_PAGE_WIDGET(widget));
+  /* the render thread initialized the page */
+  page_widget_check_size(widget);
   zathura_page_widget_update_surface(widget, surface, false);
 }
 
@@ -880,6 +1167,9 @@ static void cb_cache_invalidated(ZathuraRenderRequest* UNUSED(request), void* da
      * the surface. */
     zathura_page_widget_update_surface(widget, NULL, false);
   }
+  if (zathura_page_get_visibility(priv->page) == false) {
+    page_widget_clear_tiles(priv);
+  }
   priv->cached = false;
 }
 
@@ -890,35 +1180,75 @@ static void redraw_rect(ZathuraPageWidget* widget, zathura_rectangle_t* rectangl
   gtk_widget_queue_draw_area(GTK_WIDGET(widget), rectangle->x1, rectangle->y1, width, height);
 }
 
-static void redraw_all_rects(ZathuraPageWidget* widget, girara_list_t* rectangles) {
-  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+static void page_widget_retrieve_links(ZathuraPageWidgetPrivate* priv) {
+  if (priv->links.retrieved == TRUE) {
+    return;
+  }
+
+  priv->links.list      = zathura_page_links_get(priv->page, NULL);
+  priv->links.retrieved = TRUE;
+  priv->links.n         = (priv->links.list == NULL) ? 0 : girara_list_size(priv->links.list);
+  if (priv->links.n == 0) {
+    return;
+  }
 
-  for (size_t idx = 0; idx != girara_list_size(rectangles); ++idx) {
-    zathura_rectangle_t* rect     = girara_list_nth(rectangles, idx);
-    zathura_rectangle_t rectangle = recalc_rectangle(priv->page, *rect);
-    redraw_rect(widget, &rectangle);
+  /* the index is built once in page coordinates, so it stays valid when zooming or rotating */
+  g_autofree zathura_rectangle_t* rectangles = g_new(zathura_rectangle_t, priv->links.n);
+  for (unsigned int idx = 0; idx != priv->links.n; ++idx) {
+    zathura_link_t* link = girara_list_nth(priv->links.list, idx);
+    if (link != NULL) {
+      rectangles[idx] = zathura_link_get_position(link);
+    } else {
+      /* never contains a point */
+      rectangles[idx] = (zathura_rectangle_t){NAN, NAN, NAN, NAN};
+    }
   }
+
+  priv->links.index = zathura_link_index_new(rectangles, priv->links.n, zathura_page_get_width(priv->page),
+                                             zathura_page_get_height(priv->page));
+}
+
+static zathura_link_t* page_widget_link_at(ZathuraPageWidgetPrivate* priv, double x, double y) {
+  page_widget_retrieve_links(priv);
+  if (priv->links.index == NULL) {
+    return NULL;
+  }
+
+  /* transform the point to page coordinates, i.e. undo recalc_rectangle */
+  zathura_document_t* document = zathura_page_get_document(priv->page);
+  const double scale           = zathura_document_get_scale(document);
+  const double width           = zathura_page_get_width(priv->page);
+  const double height          = zathura_page_get_height(priv->page);
+  x /= scale;
+  y /= scale;
+
+  double page_x = x;
+  double page_y = y;
+  switch (zathura_document_get_rotation(document)) {
+  case 90:
+    page_x = y;
+    page_y = height - x;
+    break;
+  case 180:
+    page_x = width - x;
+    page_y = height - y;
+    break;
+  case 270:
+    page_x = width - y;
+    page_y = x;
+    break;
+  }
+
+  const int idx = zathura_link_index_find(priv->links.index, page_x, page_y);
+  return idx >= 0 ? girara_list_nth(priv->links.list, idx) : NULL;
 }
 
 static void evaluate_link_at_mouse_position(ZathuraPageWidget* page, int oldx, int oldy) {
   ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(page);
   /* simple single click */
-  /* get links */
-  if (priv->links.retrieved == false) {
-    priv->links.list      = zathura_page_links_get(priv->page, NULL);
-    priv->links.retrieved = true;
-    priv->links.n         = (priv->links.list == NULL) ? 0 : girara_list_size(priv->links.list);
-  }
-
-  if (priv->links.list != NULL && priv->links.n > 0) {
-    for (size_t idx = 0; idx != girara_list_size(priv->links.list); ++idx) {
-      zathura_link_t* link           = girara_list_nth(priv->links.list, idx);
-      const zathura_rectangle_t rect = recalc_rectangle(priv->page, zathura_link_get_position(link));
-      if (rect.x1 <= oldx && rect.x2 >= oldx && rect.y1 <= oldy && rect.y2 >= oldy) {
-        zathura_link_evaluate(priv->zathura, link);
-        break;
-      }
-    }
+  zathura_link_t* link = page_widget_link_at(priv, oldx, oldy);
+  if (link != NULL) {
+    zathura_link_evaluate(priv->zathura, link);
   }
 }
 
@@ -1142,31 +1472,14 @@ static gboolean cb_zathura_page_widget_motion_notify(GtkWidget* widget, GdkEvent
       }
     }
   } else {
-    if (priv->links.retrieved == false) {
-      priv->links.list      = zathura_page_links_get(priv->page, NULL);
-      priv->links.retrieved = true;
-      priv->links.n         = (priv->links.list == NULL) ? 0 : girara_list_size(priv->links.list);
-    }
-
-    if (priv->links.list != NULL && priv->links.n > 0) {
-      bool over_link = false;
-      for (size_t idx = 0; idx != girara_list_size(priv->links.list); ++idx) {
-        zathura_link_t* link     = girara_list_nth(priv->links.list, idx);
-        zathura_rectangle_t rect = recalc_rectangle(priv->page, zathura_link_get_position(link));
-        if (rect.x1 <= event->x && rect.x2 >= event->x && rect.y1 <= event->y && rect.y2 >= event->y) {
-          over_link = true;
-          break;
-        }
-      }
-
-      if (priv->mouse.over_link != over_link) {
-        if (over_link == true) {
-          g_signal_emit(page, signals[ENTER_LINK], 0);
-        } else {
-          g_signal_emit(page, signals[LEAVE_LINK], 0);
-        }
-        priv->mouse.over_link = over_link;
+    const bool over_link = page_widget_link_at(priv, event->x, event->y) != NULL;
+    if (priv->links.index != NULL && priv->mouse.over_link != over_link) {
+      if (over_link == true) {
+        g_signal_emit(page, signals[ENTER_LINK], 0);
+      } else {
+        g_signal_emit(page, signals[LEAVE_LINK], 0);
       }
+      priv->mouse.over_link = over_link;
     }
   }
 
@@ -1311,15 +1624,91 @@ void zathura_page_widget_update_view_time(ZathuraPageWidget* widget) {
   if (zathura_page_get_visibility(priv->page) == true) {
     zathura_render_request_update_view_time(priv->render_request);
   }
-  if (priv->surface == NULL) {
+  page_widget_check_size(widget);
+
+  /* tiles are only requested once they are drawn */
+  unsigned int width  = 0;
+  unsigned int height = 0;
+  if ((priv->surface == NULL || priv->surface_is_preview == true) &&
+      page_widget_use_tiles(priv, &width, &height) == false) {
     zathura_render_request(priv->render_request, g_get_real_time());
   }
 }
 
+void zathura_page_widget_prefetch(ZathuraPageWidget* widget, gint64 last_view_time) {
+  g_return_if_fail(ZATHURA_IS_PAGE_WIDGET(widget));
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+
+  if (priv->surface != NULL && priv->surface_is_preview == false) {
+    return;
+  }
+  page_widget_check_size(widget);
+
+  /* tiles are only requested once they are drawn */
+  unsigned int width  = 0;
+  unsigned int height = 0;
+  if (page_widget_use_tiles(priv, &width, &height) == true) {
+    return;
+  }
+
+  zathura_render_request_prefetch(priv->render_request, last_view_time);
+  zathura_renderer_page_cache_add(priv->zathura->sync.render_thread, zathura_page_get_index(priv->page));
+}
+
+bool zathura_page_widget_reuse_surface(ZathuraPageWidget* widget, ZathuraPageWidget* predecessor) {
+  g_return_val_if_fail(ZATHURA_IS_PAGE_WIDGET(widget) && ZATHURA_IS_PAGE_WIDGET(predecessor), false);
+  ZathuraPageWidgetPrivate* priv             = zathura_page_widget_get_instance_private(widget);
+  ZathuraPageWidgetPrivate* predecessor_priv = zathura_page_widget_get_instance_private(predecessor);
+
+  if (priv->surface != NULL || predecessor_priv->surface == NULL) {
+    return false;
+  }
+  page_widget_check_size(widget);
+
+  unsigned int width  = 0;
+  unsigned int height = 0;
+  if (page_widget_use_tiles(priv, &width, &height) == true) {
+    return false;
+  }
+
+  /* previews and pages rendered at another zoom level are rendered again */
+  zathura_document_t* document = zathura_page_get_document(priv->page);
+  page_calc_height_width(document, priv->page, &height, &width, false);
+
+  const zathura_device_factors_t device = zathura_document_get_device_factors(document);
+  if (cairo_image_surface_get_width(predecessor_priv->surface) != (int)(width * device.x) ||
+      cairo_image_surface_get_height(predecessor_priv->surface) != (int)(height * device.y)) {
+    return false;
+  }
+
+  girara_debug("reusing rendered page %u", zathura_page_get_index(priv->page) + 1);
+  zathura_render_request_reuse_surface(priv->render_request, predecessor_priv->surface);
+  return true;
+}
+
 bool zathura_page_widget_have_surface(ZathuraPageWidget* widget) {
   g_return_val_if_fail(ZATHURA_IS_PAGE_WIDGET(widget), false);
   ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
-  return priv->surface != NULL;
+  return priv->surface != NULL || page_widget_have_tiles(priv) == true;
+}
+
+void zathura_page_widget_update_search_results(ZathuraPageWidget* widget) {
+  g_return_if_fail(ZATHURA_IS_PAGE_WIDGET(widget));
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+
+  if (priv->search.draw == TRUE && page_widget_have_search_results(priv) == true) {
+    priv->links.draw = FALSE;
+  }
+  gtk_widget_queue_draw(GTK_WIDGET(widget));
+}
+
+bool zathura_page_widget_can_release(ZathuraPageWidget* widget) {
+  g_return_val_if_fail(ZATHURA_IS_PAGE_WIDGET(widget), false);
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+
+  /* cached surfaces, selections and highlights would be lost */
+  return priv->cached == false && priv->selection.list == NULL && priv->highlighter.draw == FALSE &&
+         priv->images.current == NULL;
 }
 
 void zathura_page_widget_abort_render_request(ZathuraPageWidget* widget) {
@@ -1334,6 +1723,10 @@ void zathura_page_widget_abort_render_request(ZathuraPageWidget* widget) {
   if (zathura_page_widget_have_surface(widget) == true && priv->cached == false) {
     zathura_page_widget_update_surface(widget, NULL, false);
   }
+  /* tiles are not part of the page cache, so pending ones are dropped as well */
+  if (priv->cached == false) {
+    page_widget_clear_tiles(priv);
+  }
 }
 
 zathura_page_t* zathura_page_widget_get_page(ZathuraPageWidget* widget) {
@@ -1343,12 +1736,75 @@ zathura_page_t* zathura_page_widget_get_page(ZathuraPageWidget* widget) {
   return priv->page;
 }
 
+void zathura_page_widget_set_page(ZathuraPageWidget* widget, zathura_page_t* page) {
+  g_return_if_fail(ZATHURA_IS_PAGE_WIDGET(widget) && page != NULL);
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+  if (priv->page == page) {
+    return;
+  }
+
+  /* the render request belongs to the page, so the pending jobs of the old one are dropped */
+  g_signal_handlers_disconnect_by_data(priv->render_request, widget);
+  zathura_render_request_abort(priv->render_request);
+  g_object_unref(priv->render_request);
+
+  priv->page           = page;
+  priv->render_request = zathura_render_request_new(priv->zathura->sync.render_thread, page);
+  g_signal_connect_object(priv->render_request, "completed", G_CALLBACK(cb_update_surface), widget, 0);
+  g_signal_connect_object(priv->render_request, "cache-added", G_CALLBACK(cb_cache_added), widget, 0);
+  g_signal_connect_object(priv->render_request, "cache-invalidated", G_CALLBACK(cb_cache_invalidated), widget, 0);
+
+  /* everything retrieved from the old page is dropped */
+  g_clear_pointer(&priv->surface, cairo_surface_destroy);
+  g_clear_pointer(&priv->thumbnail, cairo_surface_destroy);
+  priv->surface_is_preview = false;
+  priv->cached             = false;
+
+  page_widget_clear_tiles(priv);
+  priv->tiles.width  = 0;
+  priv->tiles.height = 0;
+
+  g_clear_pointer(&priv->links.list, girara_list_free);
+  g_clear_pointer(&priv->links.index, zathura_link_index_free);
+  priv->links.retrieved = false;
+  priv->links.draw      = false;
+  priv->links.offset    = 0;
+  priv->links.n         = 0;
+
+  g_clear_pointer(&priv->selection.list, girara_list_free);
+  priv->selection.draw = false;
+
+  g_clear_pointer(&priv->images.list, girara_list_free);
+  priv->images.retrieved = false;
+  priv->images.current   = NULL;
+
+  priv->mouse.selection.x1 = -1;
+  priv->mouse.selection.y1 = -1;
+  priv->mouse.selection.x2 = -1;
+  priv->mouse.selection.y2 = -1;
+  priv->mouse.over_link    = false;
+
+  priv->highlighter.bounds.x1 = -1;
+  priv->highlighter.bounds.y1 = -1;
+  priv->highlighter.bounds.x2 = -1;
+  priv->highlighter.bounds.y2 = -1;
+  priv->highlighter.draw      = false;
+
+  g_clear_pointer(&priv->signatures.list, girara_list_free);
+  priv->signatures.retrieved = false;
+
+  gtk_widget_queue_draw(GTK_WIDGET(widget));
+}
+
 void zathura_page_widget_set_size_request(ZathuraPageWidget* widget, int width, int height) {
   g_return_if_fail(widget != NULL);
   gtk_widget_set_size_request(GTK_WIDGET(widget), width, height);
 
   zathura_page_widget_abort_render_request(widget);
   zathura_page_widget_update_surface(widget, NULL, true);
+
+  ZathuraPageWidgetPrivate* priv = zathura_page_widget_get_instance_private(widget);
+  page_widget_clear_tiles(priv);
 }
 
 void zathura_page_widget_clear_thumbnail(ZathuraPageWidget* widget) {
@@ -69,6 +69,28 @@ zathura_link_t* zathura_page_widget_link_get(ZathuraPageWidget* widget, unsigned
  * @param widget the widget
  */
 void zathura_page_widget_update_view_time(ZathuraPageWidget* widget);
+/**
+ * Render the page ahead of time, i.e. before it becomes visible. The page is
+ * added to the page cache, so that the rendered page is kept until it is
+ * evicted.
+ *
+ * @param widget the widget
+ * @param last_view_time the view time of the page in the page cache, it should
+ *   be older than the one of the visible pages; more recent times are rendered
+ *   first
+ */
+void zathura_page_widget_prefetch(ZathuraPageWidget* widget, gint64 last_view_time);
+/**
+ * Take over the rendered page of the widget that showed the page before the
+ * document was reloaded. This only happens if the rendered page has the
+ * current size; the caller has to make sure that the content of the page did
+ * not change.
+ *
+ * @param widget the widget
+ * @param predecessor the widget of the page before the reload
+ * @return true if the rendered page was taken over, false otherwise
+ */
+bool zathura_page_widget_reuse_surface(ZathuraPageWidget* widget, ZathuraPageWidget* predecessor);
 /**
  * Check if we have a surface.
  *
@@ -76,6 +98,21 @@ void zathura_page_widget_update_view_time(ZathuraPageWidget* widget);
  * @returns true if the widget has a surface, false otherwise
  */
 bool zathura_page_widget_have_surface(ZathuraPageWidget* widget);
+/**
+ * Redraw the search results of the page after the search results of the
+ * document changed.
+ *
+ * @param widget the widget
+ */
+void zathura_page_widget_update_search_results(ZathuraPageWidget* widget);
+/**
+ * Check if the widget can be released without losing state. This is the case
+ * if the page is not in the page cache and no selection is attached to it.
+ *
+ * @param widget the widget
+ * @returns true if the widget can be released, false otherwise
+ */
+bool zathura_page_widget_can_release(ZathuraPageWidget* widget);
 /**
  * Abort outstanding render requests
  *
@@ -90,6 +127,15 @@ void zathura_page_widget_abort_render_request(ZathuraPageWidget* widget);
  */
 zathura_page_t* zathura_page_widget_get_page(ZathuraPageWidget* widget);
 
+/**
+ * Bind the widget to another page. Everything the widget retrieved from or
+ * rendered for the previous page is dropped.
+ *
+ * @param widget the widget
+ * @param page the page to be displayed
+ */
+void zathura_page_widget_set_page(ZathuraPageWidget* widget, zathura_page_t* page);
+
 /**
  * Set size request for the page widget
  *
@@ -3,6 +3,8 @@
 #include "page.h"
 
 #include <math.h>
+#include <stdatomic.h>
+#include <string.h>
 #include <girara-gtk/session.h>
 #include <girara/utils.h>
 #include <glib/gi18n.h>
@@ -11,20 +13,28 @@
 #include "plugin.h"
 #include "utils.h"
 #include "internal.h"
+#include "render.h"
 #include "types.h"
 
 struct zathura_page_s {
   zathura_document_t* document; /**< Parent document */
   void* data;                   /**< Custom data */
   char* label;                  /**< Page label */
-  double height;                /**< Page height */
-  double width;                 /**< Page width */
+  _Atomic double height;        /**< Page height, set by the plugin when the page is initialized */
+  _Atomic double width;         /**< Page width, set by the plugin when the page is initialized */
   double zoom;                  /**< Page zoom */
   unsigned int index;           /**< Page number */
   bool visible;                 /**< Page is visible */
   bool label_is_number;         /**< Page label is the same as the page number */
+  atomic_bool initialized;      /**< Plugin data has been initialized */
+  zathura_error_t init_error;   /**< Result of the initialization */
+  uint8_t fingerprint[32];      /**< SHA256 hash of the page content */
+  atomic_bool has_fingerprint;  /**< The fingerprint has been computed */
 };
 
+/* serializes the lazy initialization of pages and their fingerprints */
+static GMutex page_init_mutex;
+
 zathura_page_t* zathura_page_new(zathura_document_t* document, unsigned int index, zathura_error_t* error) {
   if (document == NULL) {
     if (error != NULL) {
@@ -34,7 +44,7 @@ zathura_page_t* zathura_page_new(zathura_document_t* document, unsigned int inde
   }
 
   /* init page */
-  zathura_page_t* page = g_try_malloc0(sizeof(zathura_page_t));
+  zathura_page_t* page = zathura_page_new_lazy(document, index, 0, 0);
   if (page == NULL) {
     if (error != NULL) {
       *error = ZATHURA_ERROR_OUT_OF_MEMORY;
@@ -42,49 +52,106 @@ zathura_page_t* zathura_page_new(zathura_document_t* document, unsigned int inde
     return NULL;
   }
 
+  /* init plugin */
+  const zathura_error_t ret = zathura_page_initialize(page);
+  if (ret != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = ret;
+    }
+    zathura_page_free(page);
+    return NULL;
+  }
+
+  return page;
+}
+
+zathura_page_t* zathura_page_new_lazy(zathura_document_t* document, unsigned int index, double width, double height) {
+  if (document == NULL) {
+    return NULL;
+  }
+
+  zathura_page_t* page = g_try_malloc0(sizeof(zathura_page_t));
+  if (page == NULL) {
+    return NULL;
+  }
+
   page->index           = index;
   page->visible         = false;
   page->document        = document;
   page->label_is_number = false;
   page->zoom            = 1.0;
+  page->init_error      = ZATHURA_ERROR_OK;
+  atomic_init(&page->width, width);
+  atomic_init(&page->height, height);
+  atomic_init(&page->initialized, false);
 
-  /* init plugin */
-  const zathura_plugin_t* plugin              = zathura_document_get_plugin(document);
+  return page;
+}
+
+static zathura_error_t page_initialize_plugin(zathura_page_t* page) {
+  const zathura_plugin_t* plugin              = zathura_document_get_plugin(page->document);
   const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(plugin);
 
   zathura_error_t ret = functions->page_init(page);
   if (ret != ZATHURA_ERROR_OK) {
-    if (error != NULL) {
-      *error = ret;
-    }
-    goto error_free;
+    return ret;
   }
 
   /* get label if there is one */
   if (functions->page_get_label != NULL) {
     ret = functions->page_get_label(page, page->data, &page->label);
     if (ret != ZATHURA_ERROR_OK) {
-      if (error != NULL) {
-        *error = ret;
-      }
-      goto error_free;
+      return ret;
     }
 
     if (page->label != NULL) {
       char page_number_string[G_ASCII_DTOSTR_BUF_SIZE];
-      g_ascii_dtostr(page_number_string, G_ASCII_DTOSTR_BUF_SIZE, index + 1);
+      g_ascii_dtostr(page_number_string, G_ASCII_DTOSTR_BUF_SIZE, page->index + 1);
       page->label_is_number = g_strcmp0(page->label, page_number_string) == 0;
     }
   }
 
-  return page;
+  return ZATHURA_ERROR_OK;
+}
 
-error_free:
-  if (page != NULL) {
-    zathura_page_free(page);
+zathura_error_t zathura_page_initialize(zathura_page_t* page) {
+  if (page == NULL || page->document == NULL) {
+    return ZATHURA_ERROR_INVALID_ARGUMENTS;
+  }
+
+  if (atomic_load(&page->initialized) == true) {
+    return page->init_error;
+  }
+
+  /* plugins that are not thread-safe have to be serialized with rendering */
+  ZathuraRenderer* renderer      = zathura_document_get_renderer(page->document);
+  const zathura_plugin_t* plugin = zathura_document_get_plugin(page->document);
+  const bool lock                = renderer != NULL && zathura_plugin_supports_concurrent_render(plugin) == false;
+  if (lock == true) {
+    zathura_renderer_lock(renderer);
+  }
+  g_mutex_lock(&page_init_mutex);
+  if (atomic_load(&page->initialized) == false) {
+    page->init_error = page_initialize_plugin(page);
+    if (page->init_error != ZATHURA_ERROR_OK) {
+      girara_error("Failed to initialize page %u", page->index + 1);
+    }
+    atomic_store(&page->initialized, true);
+  }
+  g_mutex_unlock(&page_init_mutex);
+  if (lock == true) {
+    zathura_renderer_unlock(renderer);
   }
 
-  return NULL;
+  return page->init_error;
+}
+
+bool zathura_page_is_initialized(zathura_page_t* page) {
+  if (page == NULL) {
+    return false;
+  }
+
+  return atomic_load(&page->initialized);
 }
 
 zathura_error_t zathura_page_free(zathura_page_t* page) {
@@ -97,10 +164,14 @@ zathura_error_t zathura_page_free(zathura_page_t* page) {
     return ZATHURA_ERROR_INVALID_ARGUMENTS;
   }
 
-  const zathura_plugin_t* plugin              = zathura_document_get_plugin(page->document);
-  const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(plugin);
+  /* lazily created pages might have never been initialized by the plugin */
+  zathura_error_t error = ZATHURA_ERROR_OK;
+  if (atomic_load(&page->initialized) == true) {
+    const zathura_plugin_t* plugin              = zathura_document_get_plugin(page->document);
+    const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(plugin);
 
-  zathura_error_t error = functions->page_clear(page, page->data);
+    error = functions->page_clear(page, page->data);
+  }
 
   g_free(page->label);
   g_free(page);
@@ -129,7 +200,7 @@ double zathura_page_get_width(zathura_page_t* page) {
     return -1;
   }
 
-  return page->width;
+  return atomic_load(&page->width);
 }
 
 void zathura_page_set_width(zathura_page_t* page, double width) {
@@ -142,7 +213,7 @@ void zathura_page_set_width(zathura_page_t* page, double width) {
     return;
   }
 
-  page->width = width;
+  atomic_store(&page->width, width);
 }
 
 double zathura_page_get_height(zathura_page_t* page) {
@@ -150,7 +221,7 @@ double zathura_page_get_height(zathura_page_t* page) {
     return -1;
   }
 
-  return page->height;
+  return atomic_load(&page->height);
 }
 
 void zathura_page_set_height(zathura_page_t* page, double height) {
@@ -163,7 +234,7 @@ void zathura_page_set_height(zathura_page_t* page, double height) {
     return;
   }
 
-  page->height = height;
+  atomic_store(&page->height, height);
 }
 
 double zathura_page_get_zoom(zathura_page_t* page) {
@@ -231,6 +302,14 @@ girara_list_t* zathura_page_search_text(zathura_page_t* page, const char* text,
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_search_text(page, page->data, text, error);
 }
 
@@ -251,6 +330,14 @@ girara_list_t* zathura_page_links_get(zathura_page_t* page, zathura_error_t* err
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_links_get(page, page->data, error);
 }
 
@@ -275,6 +362,14 @@ girara_list_t* zathura_page_form_fields_get(zathura_page_t* page, zathura_error_
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_form_fields_get(page, page->data, error);
 }
 
@@ -299,6 +394,14 @@ girara_list_t* zathura_page_images_get(zathura_page_t* page, zathura_error_t* er
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_images_get(page, page->data, error);
 }
 
@@ -319,6 +422,14 @@ cairo_surface_t* zathura_page_image_get_cairo(zathura_page_t* page, zathura_imag
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error != NULL) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_image_get_cairo(page, page->data, image, error);
 }
 
@@ -339,6 +450,14 @@ char* zathura_page_get_text(zathura_page_t* page, zathura_rectangle_t rectangle,
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_get_text(page, page->data, rectangle, error);
 }
 
@@ -359,6 +478,14 @@ girara_list_t* zathura_page_get_selection(zathura_page_t* page, zathura_rectangl
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return functions->page_get_selection(page, page->data, rectangle, error);
 }
 
@@ -367,6 +494,11 @@ zathura_error_t zathura_page_render(zathura_page_t* page, cairo_t* cairo, bool p
     return ZATHURA_ERROR_INVALID_ARGUMENTS;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    return init_error;
+  }
+
   const zathura_plugin_t* plugin              = zathura_document_get_plugin(page->document);
   const zathura_plugin_functions_t* functions = zathura_plugin_get_functions(plugin);
 
@@ -381,11 +513,19 @@ const char* zathura_page_get_label(zathura_page_t* page, zathura_error_t* error)
     return NULL;
   }
 
+  const zathura_error_t init_error = zathura_page_initialize(page);
+  if (init_error != ZATHURA_ERROR_OK) {
+    if (error) {
+      *error = init_error;
+    }
+    return NULL;
+  }
+
   return page->label;
 }
 
 bool zathura_page_label_is_number(zathura_page_t* page) {
-  if (page == NULL) {
+  if (page == NULL || zathura_page_initialize(page) != ZATHURA_ERROR_OK) {
     return false;
   }
 
@@ -409,7 +549,14 @@ girara_list_t* zathura_page_get_signatures(zathura_page_t* page, zathura_error_t
     return NULL;
   }
 
-  zathura_error_t e  = ZATHURA_ERROR_OK;
+  zathura_error_t e = zathura_page_initialize(page);
+  if (e != ZATHURA_ERROR_OK) {
+    if (error) {
+      *error = e;
+    }
+    return NULL;
+  }
+
   girara_list_t* ret = functions->page_get_signatures(page, page->data, &e);
   if (e != ZATHURA_ERROR_OK) {
     if (error) {
@@ -421,3 +568,77 @@ girara_list_t* zathura_page_get_signatures(zathura_page_t* page, zathura_error_t
 
   return ret;
 }
+
+static void checksum_update_double(GChecksum* checksum, double value) {
+  g_checksum_update(checksum, (const guchar*)&value, sizeof(value));
+}
+
+bool zathura_page_update_fingerprint(zathura_page_t* page) {
+  if (page == NULL || zathura_page_initialize(page) != ZATHURA_ERROR_OK) {
+    return false;
+  }
+
+  if (atomic_load(&page->has_fingerprint) == true) {
+    return true;
+  }
+
+  /* the plugin reads the file lazily, so the content of a changed file would be
+   * attributed to this version of the page */
+  if (zathura_document_file_unchanged(page->document) == false) {
+    return false;
+  }
+
+  /* the plugin API does not expose the content streams, so the size, the label,
+   * the text and the placement of the images stand in for them. Plugins report
+   * errors for pages without text or images, so errors count as no content. */
+  const double width            = zathura_page_get_width(page);
+  const double height           = zathura_page_get_height(page);
+  zathura_rectangle_t rectangle = {0, 0, width, height};
+  g_autofree char* text         = zathura_page_get_text(page, rectangle, NULL);
+  girara_list_t* images         = zathura_page_images_get(page, NULL);
+
+  GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  checksum_update_double(checksum, width);
+  checksum_update_double(checksum, height);
+  /* the terminating zeros separate the strings */
+  g_checksum_update(checksum, (const guchar*)(page->label != NULL ? page->label : ""),
+                    page->label != NULL ? strlen(page->label) + 1 : 1);
+  g_checksum_update(checksum, (const guchar*)(text != NULL ? text : ""), text != NULL ? strlen(text) + 1 : 1);
+  for (size_t idx = 0; images != NULL && idx != girara_list_size(images); ++idx) {
+    const zathura_image_t* image = girara_list_nth(images, idx);
+    checksum_update_double(checksum, image->position.x1);
+    checksum_update_double(checksum, image->position.y1);
+    checksum_update_double(checksum, image->position.x2);
+    checksum_update_double(checksum, image->position.y2);
+  }
+  if (images != NULL) {
+    girara_list_free(images);
+  }
+
+  uint8_t fingerprint[sizeof(page->fingerprint)];
+  gsize length = sizeof(fingerprint);
+  g_checksum_get_digest(checksum, fingerprint, &length);
+  g_checksum_free(checksum);
+
+  if (zathura_document_file_unchanged(page->document) == false) {
+    return false;
+  }
+
+  /* the fingerprint never changes once it is set, so readers only need the flag */
+  g_mutex_lock(&page_init_mutex);
+  if (atomic_load(&page->has_fingerprint) == false) {
+    memcpy(page->fingerprint, fingerprint, sizeof(fingerprint));
+    atomic_store(&page->has_fingerprint, true);
+  }
+  g_mutex_unlock(&page_init_mutex);
+
+  return true;
+}
+
+const uint8_t* zathura_page_get_fingerprint(zathura_page_t* page) {
+  if (page == NULL || atomic_load(&page->has_fingerprint) == false) {
+    return NULL;
+  }
+
+  return page->fingerprint;
+}
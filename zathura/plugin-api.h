@@ -222,12 +222,21 @@ typedef struct zathura_plugin_version_s {
   unsigned int rev;   /**< Revision */
 } zathura_plugin_version_t;
 
+/**
+ * Plugin capability flags
+ */
+typedef enum zathura_plugin_flags_e {
+  ZATHURA_PLUGIN_FLAG_NONE              = 0,      /**< No special capabilities */
+  ZATHURA_PLUGIN_FLAG_CONCURRENT_RENDER = 1 << 0, /**< page_render_cairo is thread-safe */
+} zathura_plugin_flags_t;
+
 typedef struct zathura_plugin_definition_s {
   const char* name;
   const zathura_plugin_version_t version;
   zathura_plugin_functions_t functions;
   const size_t mime_types_size;
   const char** mime_types;
+  const unsigned int flags;
 } zathura_plugin_definition_t;
 
 #define JOIN(x, y) JOIN2(x, y)
@@ -246,6 +255,26 @@ typedef struct zathura_plugin_definition_s {
  * @param mimetypes a char array of mime types supported by the plugin
  */
 #define ZATHURA_PLUGIN_REGISTER_WITH_FUNCTIONS(plugin_name, major, minor, rev, plugin_functions, mimetypes)            \
+  ZATHURA_PLUGIN_REGISTER_WITH_FLAGS(plugin_name, major, minor, rev, plugin_functions, mimetypes,                      \
+                                     ZATHURA_PLUGIN_FLAG_NONE)
+
+/**
+ * Register a plugin with capability flags.
+ *
+ * Plugins whose page_render_cairo implementation can safely be called from
+ * multiple threads at the same time should pass
+ * ZATHURA_PLUGIN_FLAG_CONCURRENT_RENDER. Rendering of these plugins is then
+ * not serialized by the renderer lock.
+ *
+ * @param plugin_name the name of the plugin
+ * @param major the plugin's major version
+ * @param minor the plugin's minor version
+ * @param rev the plugin's revision
+ * @param plugin_functions function to register the plugin's document functions
+ * @param mimetypes a char array of mime types supported by the plugin
+ * @param plugin_flags bitwise or of zathura_plugin_flags_t values
+ */
+#define ZATHURA_PLUGIN_REGISTER_WITH_FLAGS(plugin_name, major, minor, rev, plugin_functions, mimetypes, plugin_flags)  \
   static const char* zathura_plugin_mime_types[] = mimetypes;                                                          \
                                                                                                                        \
   ZATHURA_PLUGIN_API const zathura_plugin_definition_t ZATHURA_PLUGIN_DEFINITION_SYMBOL = {                            \
@@ -254,6 +283,7 @@ typedef struct zathura_plugin_definition_s {
       .functions       = plugin_functions,                                                                             \
       .mime_types_size = sizeof(zathura_plugin_mime_types) / sizeof(zathura_plugin_mime_types[0]),                     \
       .mime_types      = zathura_plugin_mime_types,                                                                    \
+      .flags           = plugin_flags,                                                                                 \
   };
 
 #define ZATHURA_PLUGIN_MIMETYPES(...) __VA_ARGS__
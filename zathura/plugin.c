@@ -371,3 +371,11 @@ zathura_plugin_version_t zathura_plugin_get_version(const zathura_plugin_t* plug
   zathura_plugin_version_t version = {0, 0, 0};
   return version;
 }
+
+bool zathura_plugin_supports_concurrent_render(const zathura_plugin_t* plugin) {
+  if (plugin != NULL && plugin->definition != NULL) {
+    return (plugin->definition->flags & ZATHURA_PLUGIN_FLAG_CONCURRENT_RENDER) != 0;
+  }
+
+  return false;
+}
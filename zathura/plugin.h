@@ -101,4 +101,12 @@ const char* zathura_plugin_get_path(const zathura_plugin_t* plugin);
  */
 zathura_plugin_version_t zathura_plugin_get_version(const zathura_plugin_t* plugin);
 
+/**
+ * Returns whether the plugin can render different pages concurrently
+ *
+ * @param plugin The plugin
+ * @return true if the plugin declared ZATHURA_PLUGIN_FLAG_CONCURRENT_RENDER
+ */
+bool zathura_plugin_supports_concurrent_render(const zathura_plugin_t* plugin);
+
 #endif // PLUGIN_H
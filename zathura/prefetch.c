@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "prefetch.h"
+
+#include <glib.h>
+#include <math.h>
+
+/* pause in microseconds after which scrolling starts anew */
+#define PREFETCH_IDLE_TIME 250000
+/* weight of the latest movement in the smoothed velocity */
+#define PREFETCH_SMOOTHING 0.5
+/* time in seconds the prefetched part should last at the current velocity */
+#define PREFETCH_HORIZON 1.0
+
+void zathura_prefetch_reset(zathura_prefetch_t* prefetch) {
+  g_return_if_fail(prefetch != NULL);
+
+  prefetch->velocity = 0;
+  prefetch->valid    = false;
+}
+
+void zathura_prefetch_update(zathura_prefetch_t* prefetch, double position, double extent, int64_t time) {
+  g_return_if_fail(prefetch != NULL);
+
+  if (prefetch->valid == false || prefetch->extent != extent || time <= prefetch->time) {
+    prefetch->velocity = 0;
+  } else {
+    const int64_t elapsed = time - prefetch->time;
+    const double velocity = (position - prefetch->position) * G_USEC_PER_SEC / elapsed;
+    if (elapsed > PREFETCH_IDLE_TIME) {
+      prefetch->velocity = velocity;
+    } else {
+      prefetch->velocity = PREFETCH_SMOOTHING * velocity + (1 - PREFETCH_SMOOTHING) * prefetch->velocity;
+    }
+  }
+
+  prefetch->position = position;
+  prefetch->extent   = extent;
+  prefetch->time     = time;
+  prefetch->valid    = true;
+}
+
+bool zathura_prefetch_get_range(const zathura_prefetch_t* prefetch, double view_start, double view_size,
+                                unsigned int max_screens, double* start, double* end) {
+  g_return_val_if_fail(prefetch != NULL && start != NULL && end != NULL, false);
+
+  if (prefetch->valid == false || prefetch->velocity == 0 || max_screens == 0 || view_size <= 0) {
+    return false;
+  }
+
+  const double distance = fabs(prefetch->velocity) * PREFETCH_HORIZON;
+  const double screens  = CLAMP(ceil(distance / view_size), 1, max_screens);
+  if (prefetch->velocity > 0) {
+    *start = view_start + view_size;
+    *end   = *start + screens * view_size;
+  } else {
+    *end   = view_start;
+    *start = *end - screens * view_size;
+  }
+
+  return true;
+}
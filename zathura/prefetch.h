@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef PREFETCH_H
+#define PREFETCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Tracks the scroll velocity along one axis of the document to predict which
+ * part of the document is viewed next.
+ */
+typedef struct zathura_prefetch_s {
+  double position; /**< Last position in pixels */
+  double extent;   /**< Size of the document in pixels at the last position */
+  int64_t time;    /**< Time of the last position in microseconds */
+  double velocity; /**< Smoothed velocity in pixels per second */
+  bool valid;      /**< A position was recorded */
+} zathura_prefetch_t;
+
+/**
+ * Forgets the recorded positions
+ *
+ * @param prefetch The tracker
+ */
+void zathura_prefetch_reset(zathura_prefetch_t* prefetch);
+
+/**
+ * Records a new position. A changed document size, e.g. after zooming,
+ * restarts the tracking, since positions before and after are not comparable.
+ *
+ * @param prefetch The tracker
+ * @param position The position in pixels
+ * @param extent Size of the document in pixels
+ * @param time Monotonic time in microseconds
+ */
+void zathura_prefetch_update(zathura_prefetch_t* prefetch, double position, double extent, int64_t time);
+
+/**
+ * Computes the part of the document that should be rendered ahead of the
+ * viewport. It lies in the direction of travel and covers more screens the
+ * faster the document is scrolled.
+ *
+ * @param prefetch The tracker
+ * @param view_start Start of the viewport in pixels
+ * @param view_size Size of the viewport in pixels
+ * @param max_screens Maximum number of screens to prefetch
+ * @param start Start of the part in pixels
+ * @param end End of the part in pixels
+ * @return true if the document is being scrolled, false otherwise
+ */
+bool zathura_prefetch_get_range(const zathura_prefetch_t* prefetch, double view_start, double view_size,
+                                unsigned int max_screens, double* start, double* end);
+
+#endif // PREFETCH_H
@@ -0,0 +1,381 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "recolor.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <glib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ZATHURA_RECOLOR_X86
+#include <immintrin.h>
+#endif
+
+/* Lightness is computed in fixed point with these weights. They sum to 256,
+ * hence the maximal lightness is 255 * 256 and fits into 16 bits. */
+#define LUT_WEIGHT_RED 77
+#define LUT_WEIGHT_GREEN 151
+#define LUT_WEIGHT_BLUE 28
+#define LUT_SIZE (1 << 16)
+
+typedef void (*recolor_span_func_t)(const zathura_recolor_t* recolor, unsigned char* data, unsigned int width);
+
+struct zathura_recolor_s {
+  GdkRGBA light;         /**< Light color */
+  GdkRGBA dark;          /**< Dark color */
+  bool hue;              /**< Keep hue */
+  bool adjust_lightness; /**< Adjust lightness */
+  bool fast_formula;     /**< Colors are opaque and either grey or hue is ignored */
+
+  /* precomputed values for the reference formulas */
+  double l1;
+  double l2;
+  double negalph1;
+  double negalph2;
+  double rgb_diff[3];
+  double h1[3];
+  double h2[3];
+
+  uint32_t* lut; /**< Recolored pixel for each fixed point lightness, NULL if not applicable */
+
+  zathura_recolor_implementation_t implementation;
+  recolor_span_func_t span;
+};
+
+/* Returns the maximum possible saturation for given h and l.
+   Assumes that l is in the interval l1, l2 and corrects the value to
+   force u=0 on l1 and l2 */
+static double colorumax(const double h[3], double l, double l1, double l2) {
+  if (fabs(h[0]) <= DBL_EPSILON && fabs(h[1]) <= DBL_EPSILON && fabs(h[2]) <= DBL_EPSILON) {
+    return 0;
+  }
+
+  const double lv = (l - l1) / (l2 - l1); /* Remap l to the whole interval [0,1] */
+  double u        = DBL_MAX;
+  double v        = DBL_MAX;
+  for (unsigned int k = 0; k < 3; ++k) {
+    if (h[k] > DBL_EPSILON) {
+      u = fmin(fabs((1 - l) / h[k]), u);
+      v = fmin(fabs((1 - lv) / h[k]), v);
+    } else if (h[k] < -DBL_EPSILON) {
+      u = fmin(fabs(l / h[k]), u);
+      v = fmin(fabs(lv / h[k]), v);
+    }
+  }
+
+  /* rescale v according to the length of the interval [l1, l2] */
+  v = fabs(l2 - l1) * v;
+
+  /* forces the returned value to be 0 on l1 and l2, trying not to distort colors too much */
+  return fmin(u, v);
+}
+
+/* RGB weights for computing lightness. Must sum to one */
+static const double weights[] = {0.30, 0.59, 0.11};
+
+/* reference implementation */
+
+static void recolor_span_reference(const zathura_recolor_t* recolor, unsigned char* data, unsigned int width) {
+  const GdkRGBA rgb1 = recolor->dark;
+  const GdkRGBA rgb2 = recolor->light;
+
+  const double l1 = recolor->l1;
+  const double l2 = recolor->l2;
+
+  for (unsigned int x = 0; x < width; x++, data += 4) {
+    /* Careful. data color components blue, green, red. */
+    const double rgb[3] = {data[2] / 255., data[1] / 255., data[0] / 255.};
+
+    /* compute h, s, l data   */
+    double l = weights[0] * rgb[0] + weights[1] * rgb[1] + weights[2] * rgb[2];
+
+    if (recolor->hue == true) {
+      /* adjusting lightness keeping hue of current color. white and black
+       * go to grays of same ligtness as light and dark colors. */
+      const double h[3] = {rgb[0] - l, rgb[1] - l, rgb[2] - l};
+
+      /* u is the maximum possible saturation for given h and l. s is a
+       * rescaled saturation between 0 and 1 */
+      const double u = colorumax(h, l, 0, 1);
+      const double s = fabs(u) > DBL_EPSILON ? 1.0 / u : 0.0;
+
+      /* adjust according to quartic curve, then average with original weighed
+       * by half saturation. */
+      if (recolor->adjust_lightness) {
+        /* l = l * s/2 + l^4 * (1 - s/2) */
+        double adj = l * l * l * l;
+        l          = (l - adj) * (s * 0.5) + adj;
+      }
+
+      /* Interpolates lightness between light and dark colors. white goes to
+       * light, and black goes to dark. */
+      l = l * (l2 - l1) + l1;
+
+      const double su = s * colorumax(h, l, l1, l2);
+
+      if (recolor->fast_formula == true) {
+        data[3] = 255;
+        data[2] = (unsigned char)round(255. * (l + su * h[0]));
+        data[1] = (unsigned char)round(255. * (l + su * h[1]));
+        data[0] = (unsigned char)round(255. * (l + su * h[2]));
+      } else {
+        /* Mix lightcolor, darkcolor and the original color, according to the
+         * minimal and maximal channel of the original color */
+        const double tr1 = (1. - fmax(fmax(rgb[0], rgb[1]), rgb[2]));
+        const double tr2 = fmin(fmin(rgb[0], rgb[1]), rgb[2]);
+        data[3]          = (unsigned char)round(255. * (1. - tr1 * recolor->negalph1 - tr2 * recolor->negalph2));
+        data[2]          = (unsigned char)round(
+            255. * fmin(1, fmax(0, tr1 * recolor->h1[0] + tr2 * recolor->h2[0] + (l + su * h[0]))));
+        data[1] = (unsigned char)round(
+            255. * fmin(1, fmax(0, tr1 * recolor->h1[1] + tr2 * recolor->h2[1] + (l + su * h[1]))));
+        data[0] = (unsigned char)round(
+            255. * fmin(1, fmax(0, tr1 * recolor->h1[2] + tr2 * recolor->h2[2] + (l + su * h[2]))));
+      }
+    } else {
+      if (recolor->adjust_lightness) {
+        l = l * l;
+      }
+
+      /* linear interpolation between dark and light with color ligtness as
+       * a parameter */
+      if (recolor->fast_formula == true) {
+        data[3] = 255;
+        data[2] = (unsigned char)round(255. * (l * recolor->rgb_diff[0] + rgb1.red));
+        data[1] = (unsigned char)round(255. * (l * recolor->rgb_diff[1] + rgb1.green));
+        data[0] = (unsigned char)round(255. * (l * recolor->rgb_diff[2] + rgb1.blue));
+      } else {
+        const double f1 = 1. - (1. - fmax(fmax(rgb[0], rgb[1]), rgb[2])) * recolor->negalph1;
+        const double f2 = fmin(fmin(rgb[0], rgb[1]), rgb[2]) * recolor->negalph2;
+        data[3]         = (unsigned char)round(255. * (f1 - f2));
+        data[2]         = (unsigned char)round(255. * (l * recolor->rgb_diff[0] - f2 * rgb2.red + f1 * rgb1.red));
+        data[1] = (unsigned char)round(255. * (l * recolor->rgb_diff[1] - f2 * rgb2.green + f1 * rgb1.green));
+        data[0] = (unsigned char)round(255. * (l * recolor->rgb_diff[2] - f2 * rgb2.blue + f1 * rgb1.blue));
+      }
+    }
+  }
+}
+
+/* lookup table implementations */
+
+static inline unsigned int lut_index(const unsigned char* data) {
+  return LUT_WEIGHT_BLUE * data[0] + LUT_WEIGHT_GREEN * data[1] + LUT_WEIGHT_RED * data[2];
+}
+
+static void recolor_span_lut(const zathura_recolor_t* recolor, unsigned char* data, unsigned int width) {
+  const uint32_t* lut = recolor->lut;
+
+  for (unsigned int x = 0; x < width; x++, data += 4) {
+    memcpy(data, &lut[lut_index(data)], sizeof(uint32_t));
+  }
+}
+
+#ifdef ZATHURA_RECOLOR_X86
+__attribute__((target("sse2"))) static void recolor_span_lut_sse2(const zathura_recolor_t* recolor,
+                                                                   unsigned char* data, unsigned int width) {
+  const uint32_t* lut   = recolor->lut;
+  const __m128i zero    = _mm_setzero_si128();
+  const __m128i weights = _mm_setr_epi16(LUT_WEIGHT_BLUE, LUT_WEIGHT_GREEN, LUT_WEIGHT_RED, 0, LUT_WEIGHT_BLUE,
+                                         LUT_WEIGHT_GREEN, LUT_WEIGHT_RED, 0);
+
+  unsigned int x = 0;
+  for (; x + 4 <= width; x += 4, data += 16) {
+    const __m128i pixels = _mm_loadu_si128((const __m128i*)data);
+
+    /* pixels 0, 1 and 2, 3 widened to 16 bit; each madd lane holds either b*wb + g*wg or r*wr */
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+
+    /* add neighbouring lanes and gather the sums of all four pixels */
+    const __m128i sum_lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+    const __m128i sum_hi = _mm_add_epi32(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+    const __m128i index  = _mm_castps_si128(
+        _mm_shuffle_ps(_mm_castsi128_ps(sum_lo), _mm_castsi128_ps(sum_hi), _MM_SHUFFLE(2, 0, 2, 0)));
+
+    uint32_t idx[4];
+    _mm_storeu_si128((__m128i*)idx, index);
+    const __m128i result = _mm_setr_epi32(lut[idx[0]], lut[idx[1]], lut[idx[2]], lut[idx[3]]);
+    _mm_storeu_si128((__m128i*)data, result);
+  }
+
+  recolor_span_lut(recolor, data, width - x);
+}
+
+__attribute__((target("avx2"))) static void recolor_span_lut_avx2(const zathura_recolor_t* recolor,
+                                                                   unsigned char* data, unsigned int width) {
+  const int* lut        = (const int*)recolor->lut;
+  const __m256i zero    = _mm256_setzero_si256();
+  const __m256i weights = _mm256_setr_epi16(LUT_WEIGHT_BLUE, LUT_WEIGHT_GREEN, LUT_WEIGHT_RED, 0, LUT_WEIGHT_BLUE,
+                                            LUT_WEIGHT_GREEN, LUT_WEIGHT_RED, 0, LUT_WEIGHT_BLUE, LUT_WEIGHT_GREEN,
+                                            LUT_WEIGHT_RED, 0, LUT_WEIGHT_BLUE, LUT_WEIGHT_GREEN, LUT_WEIGHT_RED, 0);
+
+  unsigned int x = 0;
+  for (; x + 8 <= width; x += 8, data += 32) {
+    const __m256i pixels = _mm256_loadu_si256((const __m256i*)data);
+
+    /* per 128 bit lane: pixels 0, 1 (resp. 4, 5) and 2, 3 (resp. 6, 7) */
+    const __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), weights);
+    const __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), weights);
+
+    /* horizontal add restores the pixel order within each lane */
+    const __m256i index  = _mm256_hadd_epi32(lo, hi);
+    const __m256i result = _mm256_i32gather_epi32(lut, index, sizeof(uint32_t));
+    _mm256_storeu_si256((__m256i*)data, result);
+  }
+
+  recolor_span_lut(recolor, data, width - x);
+}
+#endif
+
+static bool implementation_supported(zathura_recolor_implementation_t implementation) {
+  switch (implementation) {
+  case ZATHURA_RECOLOR_REFERENCE:
+  case ZATHURA_RECOLOR_LUT:
+    return true;
+#ifdef ZATHURA_RECOLOR_X86
+  case ZATHURA_RECOLOR_LUT_SSE2:
+    return __builtin_cpu_supports("sse2");
+  case ZATHURA_RECOLOR_LUT_AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+static bool build_lut(zathura_recolor_t* recolor) {
+  recolor->lut = g_try_malloc(LUT_SIZE * sizeof(uint32_t));
+  if (recolor->lut == NULL) {
+    return false;
+  }
+
+  const GdkRGBA rgb1 = recolor->dark;
+  for (unsigned int idx = 0; idx < LUT_SIZE; ++idx) {
+    double l = MIN(idx, 255 * 256) / (255. * 256.);
+    if (recolor->adjust_lightness) {
+      l = l * l;
+    }
+
+    const unsigned char pixel[4] = {
+        (unsigned char)round(255. * (l * recolor->rgb_diff[2] + rgb1.blue)),
+        (unsigned char)round(255. * (l * recolor->rgb_diff[1] + rgb1.green)),
+        (unsigned char)round(255. * (l * recolor->rgb_diff[0] + rgb1.red)),
+        255,
+    };
+    memcpy(&recolor->lut[idx], pixel, sizeof(uint32_t));
+  }
+
+  return true;
+}
+
+zathura_recolor_t* zathura_recolor_new(const GdkRGBA* light, const GdkRGBA* dark, bool hue, bool adjust_lightness) {
+  g_return_val_if_fail(light != NULL && dark != NULL, NULL);
+
+  zathura_recolor_t* recolor = g_try_malloc0(sizeof(zathura_recolor_t));
+  if (recolor == NULL) {
+    return NULL;
+  }
+
+  const GdkRGBA rgb1        = *dark;
+  const GdkRGBA rgb2        = *light;
+  recolor->dark             = rgb1;
+  recolor->light            = rgb2;
+  recolor->hue              = hue;
+  recolor->adjust_lightness = adjust_lightness;
+
+  /* Decide if we can use the older, faster formulas */
+  recolor->fast_formula =
+      (!hue || (fabs(rgb1.red - rgb1.blue) < DBL_EPSILON && fabs(rgb1.red - rgb1.green) < DBL_EPSILON &&
+                fabs(rgb2.red - rgb2.blue) < DBL_EPSILON && fabs(rgb2.red - rgb2.green) < DBL_EPSILON)) &&
+      (rgb1.alpha >= 1. - DBL_EPSILON && rgb2.alpha >= 1. - DBL_EPSILON);
+
+  recolor->l1       = weights[0] * rgb1.red + weights[1] * rgb1.green + weights[2] * rgb1.blue;
+  recolor->l2       = weights[0] * rgb2.red + weights[1] * rgb2.green + weights[2] * rgb2.blue;
+  recolor->negalph1 = 1. - rgb1.alpha;
+  recolor->negalph2 = 1. - rgb2.alpha;
+
+  recolor->rgb_diff[0] = rgb2.red - rgb1.red;
+  recolor->rgb_diff[1] = rgb2.green - rgb1.green;
+  recolor->rgb_diff[2] = rgb2.blue - rgb1.blue;
+
+  recolor->h1[0] = rgb1.red * rgb1.alpha - recolor->l1;
+  recolor->h1[1] = rgb1.green * rgb1.alpha - recolor->l1;
+  recolor->h1[2] = rgb1.blue * rgb1.alpha - recolor->l1;
+
+  recolor->h2[0] = rgb2.red * rgb2.alpha - recolor->l2;
+  recolor->h2[1] = rgb2.green * rgb2.alpha - recolor->l2;
+  recolor->h2[2] = rgb2.blue * rgb2.alpha - recolor->l2;
+
+  /* Without hue the fast formula only depends on the lightness of a pixel */
+  if (hue == false && recolor->fast_formula == true && build_lut(recolor) == false) {
+    g_free(recolor);
+    return NULL;
+  }
+
+  const zathura_recolor_implementation_t candidates[] = {
+      ZATHURA_RECOLOR_LUT_AVX2,
+      ZATHURA_RECOLOR_LUT_SSE2,
+      ZATHURA_RECOLOR_LUT,
+      ZATHURA_RECOLOR_REFERENCE,
+  };
+  for (size_t idx = 0; idx < G_N_ELEMENTS(candidates); ++idx) {
+    if (zathura_recolor_set_implementation(recolor, candidates[idx]) == true) {
+      break;
+    }
+  }
+
+  return recolor;
+}
+
+void zathura_recolor_free(zathura_recolor_t* recolor) {
+  if (recolor == NULL) {
+    return;
+  }
+
+  g_free(recolor->lut);
+  g_free(recolor);
+}
+
+zathura_recolor_implementation_t zathura_recolor_get_implementation(const zathura_recolor_t* recolor) {
+  g_return_val_if_fail(recolor != NULL, ZATHURA_RECOLOR_REFERENCE);
+
+  return recolor->implementation;
+}
+
+bool zathura_recolor_set_implementation(zathura_recolor_t* recolor, zathura_recolor_implementation_t implementation) {
+  g_return_val_if_fail(recolor != NULL, false);
+
+  if (implementation != ZATHURA_RECOLOR_REFERENCE && recolor->lut == NULL) {
+    return false;
+  }
+  if (implementation_supported(implementation) == false) {
+    return false;
+  }
+
+  switch (implementation) {
+  case ZATHURA_RECOLOR_LUT:
+    recolor->span = recolor_span_lut;
+    break;
+#ifdef ZATHURA_RECOLOR_X86
+  case ZATHURA_RECOLOR_LUT_SSE2:
+    recolor->span = recolor_span_lut_sse2;
+    break;
+  case ZATHURA_RECOLOR_LUT_AVX2:
+    recolor->span = recolor_span_lut_avx2;
+    break;
+#endif
+  default:
+    recolor->span = recolor_span_reference;
+    break;
+  }
+
+  recolor->implementation = implementation;
+  return true;
+}
+
+void zathura_recolor_span(const zathura_recolor_t* recolor, unsigned char* data, unsigned int width) {
+  g_return_if_fail(recolor != NULL && data != NULL);
+
+  recolor->span(recolor, data, width);
+}
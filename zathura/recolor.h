@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef RECOLOR_H
+#define RECOLOR_H
+
+#include <stdbool.h>
+#include <gdk/gdk.h>
+
+typedef struct zathura_recolor_s zathura_recolor_t;
+
+/**
+ * Recolor implementations
+ */
+typedef enum zathura_recolor_implementation_e {
+  ZATHURA_RECOLOR_REFERENCE, /**< Per-pixel floating point formulas */
+  ZATHURA_RECOLOR_LUT,       /**< Lightness lookup table */
+  ZATHURA_RECOLOR_LUT_SSE2,  /**< Lightness lookup table, lightness computed with SSE2 */
+  ZATHURA_RECOLOR_LUT_AVX2,  /**< Lightness lookup table, lightness computed and looked up with AVX2 */
+} zathura_recolor_implementation_t;
+
+/**
+ * Creates a new recolor context. Lookup tables are precomputed and the fastest
+ * implementation supported by the CPU is selected.
+ *
+ * @param light The light color
+ * @param dark The dark color
+ * @param hue Keep the hue of the original colors
+ * @param adjust_lightness Adjust the lightness of the original colors
+ * @return The recolor context or NULL if an error occurred
+ */
+zathura_recolor_t* zathura_recolor_new(const GdkRGBA* light, const GdkRGBA* dark, bool hue, bool adjust_lightness);
+
+/**
+ * Frees the recolor context
+ *
+ * @param recolor The recolor context
+ */
+void zathura_recolor_free(zathura_recolor_t* recolor);
+
+/**
+ * Returns the implementation used by the recolor context
+ *
+ * @param recolor The recolor context
+ * @return The used implementation
+ */
+zathura_recolor_implementation_t zathura_recolor_get_implementation(const zathura_recolor_t* recolor);
+
+/**
+ * Selects the implementation used by the recolor context. This is mainly
+ * useful for testing and benchmarking.
+ *
+ * @param recolor The recolor context
+ * @param implementation The implementation
+ * @return true if the implementation is supported for the colors and the CPU,
+ *   false otherwise
+ */
+bool zathura_recolor_set_implementation(zathura_recolor_t* recolor, zathura_recolor_implementation_t implementation);
+
+/**
+ * Recolors a span of pixels. The pixels are expected to be in the format of
+ * CAIRO_FORMAT_ARGB32.
+ *
+ * @param recolor The recolor context
+ * @param data Pointer to the first pixel
+ * @param width Number of pixels
+ */
+void zathura_recolor_span(const zathura_recolor_t* recolor, unsigned char* data, unsigned int width);
+
+#endif // RECOLOR_H
@@ -12,25 +12,49 @@
 #include "zathura.h"
 #include "document.h"
 #include "document-widget.h"
+#include "internal.h"
 #include "page.h"
 #include "page-widget.h"
+#include "recolor.h"
 #include "utils.h"
 
+/* recolor context of one generation of the recolor settings, shared read-only
+ * by the render threads and the recolor pool */
+typedef struct recolor_context_s {
+  zathura_recolor_t* recolor; /**< Lookup tables */
+  guint generation;           /**< Generation of the settings it was built for */
+} recolor_context_t;
+
 /* private data for ZathuraRenderer */
 typedef struct private_s {
-  GThreadPool* pool;       /**< Pool of threads */
+  GThreadPool* pool;         /**< Pool of threads */
+  GThreadPool* recolor_pool; /**< Pool of threads helping with recoloring */
   girara_list_t* requests; /**< Render requests */
-  GMutex mutex;            /**< Render lock */
+  GRecMutex mutex;         /**< Render lock, also taken when pages are initialized */
 
   /**
    * Page cache
    */
   struct {
-    int* cache;
-    size_t size;
-    size_t num_cached_pages;
+    GHashTable* entries;  /**< Map of page index to page_cache_entry_t */
+    GPtrArray* heap;      /**< Binary min-heap of entries ordered by last view time */
+    size_t max_pages;     /**< Maximum number of cached pages */
+    size_t max_bytes;     /**< Maximum size of cached surfaces in bytes, 0 for no limit */
+    size_t bytes;         /**< Current size of cached surfaces in bytes */
+    size_t tile_bytes;    /**< Current size of tiles kept by page widgets in bytes */
+    size_t hits;          /**< Number of cache hits */
+    size_t misses;        /**< Number of cache misses */
+    size_t evictions;     /**< Number of evicted pages */
   } page_cache;
 
+  /**
+   * Render job statistics
+   */
+  struct {
+    atomic_size_t executed;  /**< Number of executed render jobs */
+    atomic_size_t coalesced; /**< Number of render requests served by existing jobs */
+  } jobs;
+
   /**
    * Recolor information
    */
@@ -41,8 +65,13 @@ typedef struct private_s {
     bool hue;
     bool reverse_video;
     bool adjust_lightness;
+    guint generation;           /**< Changed with every recolor setting */
+    recolor_context_t* context; /**< Reference counted context of the latest generation */
+    GMutex mutex;               /**< Protects the context */
   } recolor;
 
+  atomic_bool fingerprint; /**< Fingerprint rendered pages for incremental reloads */
+
   atomic_bool about_to_close; /**< Render thread is to be freed */
 } ZathuraRendererPrivate;
 
@@ -54,6 +83,18 @@ typedef struct request_private_s {
   girara_list_t* active_jobs;
   GMutex jobs_mutex;
   bool render_plain;
+  atomic_bool fingerprint_queued; /**< A fingerprint job for the page is queued */
+
+  /**
+   * Part of the page in user pixels that is rendered if enabled
+   */
+  struct {
+    bool enabled;
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+  } tile;
 } ZathuraRenderRequestPrivate;
 
 /* define the two types */
@@ -68,17 +109,47 @@ static void render_request_dispose(GObject* object);
 static void render_request_finalize(GObject* object);
 
 static void render_job(void* data, void* user_data);
+static void recolor_job(void* data, void* user_data);
+static void recolor_context_release(recolor_context_t* context);
 static gint render_thread_sort(gconstpointer a, gconstpointer b, gpointer data);
-static ssize_t page_cache_lru_invalidate(ZathuraRenderer* renderer);
-static void page_cache_invalidate_all(ZathuraRenderer* renderer);
-static bool page_cache_is_full(ZathuraRenderer* renderer, bool* result);
+static void page_cache_update_view_time(ZathuraRenderer* renderer, ZathuraRenderRequest* request);
+static void page_cache_update_size(ZathuraRenderer* renderer, ZathuraRenderRequest* request,
+                                   cairo_surface_t* surface);
+static void page_cache_remove_request(ZathuraRenderer* renderer, ZathuraRenderRequest* request);
+
+/* state a rendered page depends on */
+typedef struct render_key_s {
+  double scale;
+  unsigned int rotation;
+  guint recolor; /**< Recolor generation */
+} render_key_t;
 
 /* job description for render thread */
 typedef struct render_job_s {
   ZathuraRenderRequest* request;
   atomic_bool aborted;
+  bool preview;     /**< Render a low resolution preview before the page */
+  bool running;     /**< The job was taken from the queue, protected by the jobs mutex of the request */
+  render_key_t key; /**< State the running job renders, protected by the jobs mutex of the request */
+  bool fingerprint; /**< Fingerprint the page instead of rendering it */
+  bool prefetch;    /**< The page is not visible yet, protected by the jobs mutex of the request */
 } render_job_t;
 
+/* scale of the preview pass relative to the full resolution */
+#define RENDER_PREVIEW_SCALE 0.5
+
+/* marks surfaces of the preview pass */
+static cairo_user_data_key_t preview_surface_key;
+
+/* entry of the page cache */
+typedef struct page_cache_entry_s {
+  unsigned int page_index;       /**< Index of the cached page */
+  ZathuraRenderRequest* request; /**< Request that is notified about cache changes */
+  gint64 last_view_time;         /**< Eviction priority */
+  size_t size;                   /**< Size of the rendered surface in bytes */
+  guint heap_index;              /**< Position of the entry in the heap */
+} page_cache_entry_t;
+
 /* init, new and free for ZathuraRenderer */
 
 static void zathura_renderer_class_init(ZathuraRendererClass* class) {
@@ -92,47 +163,52 @@ static void zathura_renderer_init(ZathuraRenderer* renderer) {
   priv->pool                   = g_thread_pool_new(render_job, renderer, 1, TRUE, NULL);
   priv->about_to_close         = false;
   g_thread_pool_set_sort_function(priv->pool, render_thread_sort, NULL);
-  g_mutex_init(&priv->mutex);
+  g_rec_mutex_init(&priv->mutex);
+
+  /* the render thread itself recolors as well, hence one thread less */
+  const guint num_processors = g_get_num_processors();
+  priv->recolor_pool         = NULL;
+  if (num_processors > 1) {
+    priv->recolor_pool = g_thread_pool_new(recolor_job, renderer, num_processors - 1, FALSE, NULL);
+  }
 
   /* recolor */
   priv->recolor.enabled          = false;
   priv->recolor.hue              = true;
   priv->recolor.reverse_video    = false;
   priv->recolor.adjust_lightness = false;
+  priv->recolor.context          = NULL;
+  g_mutex_init(&priv->recolor.mutex);
+  atomic_init(&priv->fingerprint, false);
 
   /* page cache */
-  priv->page_cache.size             = 0;
-  priv->page_cache.cache            = NULL;
-  priv->page_cache.num_cached_pages = 0;
+  priv->page_cache.entries   = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+  priv->page_cache.heap      = g_ptr_array_new();
+  priv->page_cache.max_pages = 0;
+  priv->page_cache.max_bytes = 0;
+  priv->page_cache.bytes     = 0;
+  priv->page_cache.hits      = 0;
+  priv->page_cache.misses    = 0;
+  priv->page_cache.evictions = 0;
+
+  /* render job statistics */
+  atomic_init(&priv->jobs.executed, 0);
+  atomic_init(&priv->jobs.coalesced, 0);
 
   zathura_renderer_set_recolor_colors_str(renderer, "#000000", "#FFFFFF");
 
   priv->requests = girara_list_new();
 }
 
-static bool page_cache_init(ZathuraRenderer* renderer, size_t cache_size) {
-  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-
-  priv->page_cache.size  = cache_size;
-  priv->page_cache.cache = g_try_malloc0(cache_size * sizeof(int));
-  if (priv->page_cache.cache == NULL) {
-    return false;
-  }
-
-  page_cache_invalidate_all(renderer);
-  return true;
-}
-
-ZathuraRenderer* zathura_renderer_new(size_t cache_size) {
+ZathuraRenderer* zathura_renderer_new(size_t cache_size, size_t cache_memory) {
   g_return_val_if_fail(cache_size > 0, NULL);
 
   GObject* obj         = g_object_new(ZATHURA_TYPE_RENDERER, NULL);
   ZathuraRenderer* ret = ZATHURA_RENDERER(obj);
 
-  if (page_cache_init(ret, cache_size) == false) {
-    g_object_unref(obj);
-    return NULL;
-  }
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(ret);
+  priv->page_cache.max_pages   = cache_size;
+  priv->page_cache.max_bytes   = cache_memory;
 
   return ret;
 }
@@ -146,9 +222,15 @@ static void renderer_finalize(GObject* object) {
     girara_debug("Waiting for thread pool to finish.");
     g_thread_pool_free(priv->pool, TRUE, TRUE);
   }
-  g_mutex_clear(&(priv->mutex));
+  if (priv->recolor_pool != NULL) {
+    g_thread_pool_free(priv->recolor_pool, TRUE, TRUE);
+  }
+  g_rec_mutex_clear(&(priv->mutex));
+  g_clear_pointer(&priv->recolor.context, recolor_context_release);
+  g_mutex_clear(&priv->recolor.mutex);
 
-  g_free(priv->page_cache.cache);
+  g_ptr_array_free(priv->page_cache.heap, TRUE);
+  g_hash_table_destroy(priv->page_cache.entries);
   girara_list_free(priv->requests);
 }
 
@@ -157,6 +239,7 @@ static void renderer_finalize(GObject* object) {
 static void renderer_unregister_request(ZathuraRenderer* renderer, ZathuraRenderRequest* request) {
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
   girara_list_remove(priv->requests, request);
+  page_cache_remove_request(renderer, request);
 }
 
 static void renderer_register_request(ZathuraRenderer* renderer, ZathuraRenderRequest* request) {
@@ -217,6 +300,8 @@ ZathuraRenderRequest* zathura_render_request_new(ZathuraRenderer* renderer, zath
   priv->active_jobs = girara_list_new();
   g_mutex_init(&priv->jobs_mutex);
   priv->render_plain = false;
+  priv->tile.enabled = false;
+  atomic_init(&priv->fingerprint_queued, false);
 
   /* register the request with the renderer */
   renderer_register_request(renderer, request);
@@ -265,6 +350,7 @@ void zathura_renderer_enable_recolor(ZathuraRenderer* renderer, bool enable) {
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
   priv->recolor.enabled        = enable;
+  ++priv->recolor.generation;
 }
 
 bool zathura_renderer_recolor_hue_enabled(ZathuraRenderer* renderer) {
@@ -279,6 +365,7 @@ void zathura_renderer_enable_recolor_hue(ZathuraRenderer* renderer, bool enable)
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
   priv->recolor.hue            = enable;
+  ++priv->recolor.generation;
 }
 
 bool zathura_renderer_recolor_reverse_video_enabled(ZathuraRenderer* renderer) {
@@ -293,6 +380,7 @@ void zathura_renderer_enable_recolor_reverse_video(ZathuraRenderer* renderer, bo
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
   priv->recolor.reverse_video  = enable;
+  ++priv->recolor.generation;
 }
 
 bool zathura_renderer_recolor_adjust_lightness_enabled(ZathuraRenderer* renderer) {
@@ -307,6 +395,7 @@ void zathura_renderer_enable_recolor_adjust_lightness(ZathuraRenderer* renderer,
 
   ZathuraRendererPrivate* priv   = zathura_renderer_get_instance_private(renderer);
   priv->recolor.adjust_lightness = enable;
+  ++priv->recolor.generation;
 }
 
 void zathura_renderer_set_recolor_colors(ZathuraRenderer* renderer, const GdkRGBA* light, const GdkRGBA* dark) {
@@ -319,6 +408,7 @@ void zathura_renderer_set_recolor_colors(ZathuraRenderer* renderer, const GdkRGB
   if (dark != NULL) {
     priv->recolor.dark = *dark;
   }
+  ++priv->recolor.generation;
 }
 
 void zathura_renderer_set_recolor_colors_str(ZathuraRenderer* renderer, const char* light, const char* dark) {
@@ -350,18 +440,39 @@ void zathura_renderer_get_recolor_colors(ZathuraRenderer* renderer, GdkRGBA* lig
   }
 }
 
+void zathura_renderer_enable_fingerprints(ZathuraRenderer* renderer, bool enable) {
+  g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
+
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  atomic_store(&priv->fingerprint, enable);
+}
+
 void zathura_renderer_lock(ZathuraRenderer* renderer) {
   g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  g_mutex_lock(&priv->mutex);
+  g_rec_mutex_lock(&priv->mutex);
 }
 
 void zathura_renderer_unlock(ZathuraRenderer* renderer) {
   g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  g_mutex_unlock(&priv->mutex);
+  g_rec_mutex_unlock(&priv->mutex);
+}
+
+void zathura_renderer_set_render_threads(ZathuraRenderer* renderer, unsigned int threads) {
+  g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
+  g_return_if_fail(threads > 0);
+
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  g_autoptr(GError) error      = NULL;
+  if (g_thread_pool_set_max_threads(priv->pool, threads, &error) == FALSE) {
+    girara_warning("Failed to set number of render threads to %u: %s", threads, error->message);
+    return;
+  }
+
+  girara_debug("Using %u render threads", threads);
 }
 
 void zathura_renderer_stop(ZathuraRenderer* renderer) {
@@ -373,43 +484,88 @@ void zathura_renderer_stop(ZathuraRenderer* renderer) {
 
 /* ZathuraRenderRequest methods */
 
-void zathura_render_request(ZathuraRenderRequest* request, gint64 last_view_time) {
-  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
+static render_key_t render_key_get(ZathuraRenderer* renderer, zathura_page_t* page) {
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  zathura_document_t* document = zathura_page_get_document(page);
 
+  return (render_key_t){
+      .scale    = zathura_document_get_scale(document),
+      .rotation = zathura_document_get_rotation(document),
+      .recolor  = priv->recolor.generation,
+  };
+}
+
+static bool render_key_equal(const render_key_t* a, const render_key_t* b) {
+  return a->scale == b->scale && a->rotation == b->rotation && a->recolor == b->recolor;
+}
+
+static void render_request_push(ZathuraRenderRequest* request, gint64 last_view_time, bool preview, bool prefetch) {
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(request_priv->renderer);
+  const render_key_t key                    = render_key_get(request_priv->renderer, request_priv->page);
   g_mutex_lock(&request_priv->jobs_mutex);
 
-  bool unfinished_jobs = false;
-  /* check if there are any active jobs left */
+  request_priv->last_view_time = last_view_time;
+  page_cache_update_view_time(request_priv->renderer, request);
+
+  /* Attach to an existing job instead of adding a new one. A queued job renders
+   * the state at the time it runs, so it supersedes any older request, even an
+   * aborted one. A running job is only kept if it renders the current state. */
+  bool attached = false;
   for (size_t idx = 0; idx != girara_list_size(request_priv->active_jobs); ++idx) {
     render_job_t* job = girara_list_nth(request_priv->active_jobs, idx);
-    if (job->aborted == false) {
-      unfinished_jobs = true;
-      break;
+    if (attached == false && (job->running == false || render_key_equal(&job->key, &key) == true)) {
+      job->aborted  = false;
+      job->prefetch = job->prefetch && prefetch;
+      attached      = true;
+    } else {
+      job->aborted = true;
     }
   }
 
-  /* only add a new job if there are no active ones left */
-  if (unfinished_jobs == false) {
-    request_priv->last_view_time = last_view_time;
+  if (attached == true) {
+    atomic_fetch_add(&priv->jobs.coalesced, 1);
+    g_mutex_unlock(&request_priv->jobs_mutex);
+    return;
+  }
 
-    render_job_t* job = g_try_malloc0(sizeof(render_job_t));
-    if (job == NULL) {
-      g_mutex_unlock(&request_priv->jobs_mutex);
-      return;
-    }
+  render_job_t* job = g_try_malloc0(sizeof(render_job_t));
+  if (job == NULL) {
+    g_mutex_unlock(&request_priv->jobs_mutex);
+    return;
+  }
 
-    job->request = g_object_ref(request);
-    job->aborted = false;
-    girara_list_append(request_priv->active_jobs, job);
+  job->request = g_object_ref(request);
+  job->aborted = false;
+  job->preview  = preview && request_priv->render_plain == false && request_priv->tile.enabled == false;
+  job->running  = false;
+  job->prefetch = prefetch;
+  girara_list_append(request_priv->active_jobs, job);
 
-    ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(request_priv->renderer);
-    g_thread_pool_push(priv->pool, job, NULL);
-  }
+  g_thread_pool_push(priv->pool, job, NULL);
 
   g_mutex_unlock(&request_priv->jobs_mutex);
 }
 
+void zathura_render_request(ZathuraRenderRequest* request, gint64 last_view_time) {
+  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
+  render_request_push(request, last_view_time, false, false);
+}
+
+void zathura_render_request_with_preview(ZathuraRenderRequest* request, gint64 last_view_time) {
+  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
+  render_request_push(request, last_view_time, true, false);
+}
+
+void zathura_render_request_prefetch(ZathuraRenderRequest* request, gint64 last_view_time) {
+  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
+  render_request_push(request, last_view_time, false, true);
+}
+
+bool zathura_render_surface_is_preview(cairo_surface_t* surface) {
+  return surface != NULL && cairo_surface_get_user_data(surface, &preview_surface_key) != NULL;
+}
+
 void zathura_render_request_abort(ZathuraRenderRequest* request) {
   g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
 
@@ -422,15 +578,32 @@ void zathura_render_request_abort(ZathuraRenderRequest* request) {
   g_mutex_unlock(&request_priv->jobs_mutex);
 }
 
+void zathura_render_request_reuse_surface(ZathuraRenderRequest* request, cairo_surface_t* surface) {
+  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request) && surface != NULL);
+
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+  g_signal_emit(request, request_signals[REQUEST_COMPLETED], 0, surface);
+  if (request_priv->tile.enabled == false) {
+    zathura_renderer_page_cache_add(request_priv->renderer, zathura_page_get_index(request_priv->page));
+    page_cache_update_size(request_priv->renderer, request, surface);
+  }
+}
+
 void zathura_render_request_update_view_time(ZathuraRenderRequest* request) {
   g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
 
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
   request_priv->last_view_time              = g_get_real_time();
+  page_cache_update_view_time(request_priv->renderer, request);
 }
 
 /* render job */
 
+static void job_free(render_job_t* job) {
+  g_object_unref(job->request);
+  g_free(job);
+}
+
 static void remove_job_and_free(render_job_t* job) {
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(job->request);
 
@@ -438,8 +611,28 @@ static void remove_job_and_free(render_job_t* job) {
   girara_list_remove(request_priv->active_jobs, job);
   g_mutex_unlock(&request_priv->jobs_mutex);
 
-  g_object_unref(job->request);
-  g_free(job);
+  job_free(job);
+}
+
+/* called from the render thread after the job was found to be aborted */
+static void abandon_job(ZathuraRenderer* renderer, render_job_t* job) {
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(job->request);
+
+  g_mutex_lock(&request_priv->jobs_mutex);
+  /* a new request might have attached to the job in the meantime */
+  const bool revived = priv->about_to_close == false && job->aborted == false;
+  if (revived == true) {
+    job->running = false;
+    g_thread_pool_push(priv->pool, job, NULL);
+  } else {
+    girara_list_remove(request_priv->active_jobs, job);
+  }
+  g_mutex_unlock(&request_priv->jobs_mutex);
+
+  if (revived == false) {
+    job_free(job);
+  }
 }
 
 typedef struct emit_completed_signal_s {
@@ -453,15 +646,31 @@ static gboolean emit_completed_signal(void* data) {
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(job->request);
   ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(request_priv->renderer);
 
+  bool requeue = false;
   if (priv->about_to_close == false && job->aborted == false) {
     /* emit the signal */
     girara_debug("Emitting signal for page %d", zathura_page_get_index(request_priv->page) + 1);
     g_signal_emit(job->request, request_signals[REQUEST_COMPLETED], 0, ecs->surface);
+    if (job->preview == true) {
+      job->preview = false;
+      requeue      = true;
+    } else {
+      page_cache_update_size(request_priv->renderer, job->request, ecs->surface);
+    }
   } else {
     girara_debug("Rendering of page %d aborted", zathura_page_get_index(request_priv->page) + 1);
   }
-  /* mark the request as done */
-  remove_job_and_free(job);
+
+  if (requeue == true) {
+    /* the preview is on screen, now render the page in full resolution */
+    g_mutex_lock(&request_priv->jobs_mutex);
+    job->running = false;
+    g_thread_pool_push(priv->pool, job, NULL);
+    g_mutex_unlock(&request_priv->jobs_mutex);
+  } else {
+    /* mark the request as done */
+    remove_job_and_free(job);
+  }
 
   /* clean up the data */
   cairo_surface_destroy(ecs->surface);
@@ -470,232 +679,229 @@ static gboolean emit_completed_signal(void* data) {
   return FALSE;
 }
 
-static bool pixel_inside_rectangles(girara_list_t* rectangles, unsigned int x, unsigned int y) {
-  for (size_t idx = 0; idx != girara_list_size(rectangles); ++idx) {
-    zathura_rectangle_t* rect_it = girara_list_nth(rectangles, idx);
-    if (rect_it->x1 <= x && rect_it->x2 >= x && rect_it->y1 <= y && rect_it->y2 >= y) {
-      return true;
-    }
-  }
+/* span of pixels in a row that belong to an image */
+typedef struct image_span_s {
+  unsigned int start; /**< First pixel of the span */
+  unsigned int end;   /**< One past the last pixel of the span */
+} image_span_t;
 
-  return false;
-}
-
-/* Returns the maximum possible saturation for given h and l.
-   Assumes that l is in the interval l1, l2 and corrects the value to
-   force u=0 on l1 and l2 */
-static double colorumax(const double h[3], double l, double l1, double l2) {
-  if (fabs(h[0]) <= DBL_EPSILON && fabs(h[1]) <= DBL_EPSILON && fabs(h[2]) <= DBL_EPSILON) {
-    return 0;
-  }
+/* images rasterized to sorted, disjoint spans per row */
+typedef struct image_mask_s {
+  unsigned int* row_offsets; /**< Spans of row y are spans[row_offsets[y]] up to spans[row_offsets[y + 1]] */
+  image_span_t* spans;
+} image_mask_t;
 
-  const double lv = (l - l1) / (l2 - l1); /* Remap l to the whole interval [0,1] */
-  double u        = DBL_MAX;
-  double v        = DBL_MAX;
-  for (unsigned int k = 0; k < 3; ++k) {
-    if (h[k] > DBL_EPSILON) {
-      u = fmin(fabs((1 - l) / h[k]), u);
-      v = fmin(fabs((1 - lv) / h[k]), v);
-    } else if (h[k] < -DBL_EPSILON) {
-      u = fmin(fabs(l / h[k]), u);
-      v = fmin(fabs(lv / h[k]), v);
-    }
-  }
+static int compare_image_spans(const void* a, const void* b) {
+  const image_span_t* span_a = a;
+  const image_span_t* span_b = b;
 
-  /* rescale v according to the length of the interval [l1, l2] */
-  v = fabs(l2 - l1) * v;
-
-  /* forces the returned value to be 0 on l1 and l2, trying not to distort colors too much */
-  return fmin(u, v);
+  return span_a->start < span_b->start ? -1 : (span_a->start > span_b->start ? 1 : 0);
 }
 
-/* RGB weights for computing lightness. Must sum to one */
-static const double weights[] = {0.30, 0.59, 0.11};
-
-static void recolor_slow(ZathuraRendererPrivate* priv, unsigned int page_width, unsigned int page_height,
-                         cairo_surface_t* surface, girara_list_t* rectangles, bool found_images) {
-  const GdkRGBA rgb1 = priv->recolor.dark;
-  const GdkRGBA rgb2 = priv->recolor.light;
-
-  const double l1       = weights[0] * rgb1.red + weights[1] * rgb1.green + weights[2] * rgb1.blue;
-  const double l2       = weights[0] * rgb2.red + weights[1] * rgb2.green + weights[2] * rgb2.blue;
-  const double negalph1 = 1. - rgb1.alpha;
-  const double negalph2 = 1. - rgb2.alpha;
-
-  const double rgb_diff[] = {rgb2.red - rgb1.red, rgb2.green - rgb1.green, rgb2.blue - rgb1.blue};
+static void image_mask_free(image_mask_t* mask) {
+  if (mask == NULL) {
+    return;
+  }
 
-  const double h1[3] = {
-      rgb1.red * rgb1.alpha - l1,
-      rgb1.green * rgb1.alpha - l1,
-      rgb1.blue * rgb1.alpha - l1,
-  };
+  g_free(mask->row_offsets);
+  g_free(mask->spans);
+  g_free(mask);
+}
 
-  const double h2[3] = {
-      rgb2.red * rgb2.alpha - l2,
-      rgb2.green * rgb2.alpha - l2,
-      rgb2.blue * rgb2.alpha - l2,
-  };
+/* Clip a rectangle to the pixels [x_start, x_end) x [y_start, y_end) it contains */
+static bool image_rectangle_clip(const zathura_rectangle_t* rect, unsigned int width, unsigned int height,
+                                 unsigned int* x_start, unsigned int* x_end, unsigned int* y_start,
+                                 unsigned int* y_end) {
+  const double x1 = ceil(fmax(rect->x1, 0));
+  const double x2 = floor(fmin(rect->x2, width - 1.0));
+  const double y1 = ceil(fmax(rect->y1, 0));
+  const double y2 = floor(fmin(rect->y2, height - 1.0));
+  if (x1 > x2 || y1 > y2) {
+    return false;
+  }
 
-  bool adjust_lightness = priv->recolor.adjust_lightness;
+  *x_start = x1;
+  *x_end   = x2 + 1;
+  *y_start = y1;
+  *y_end   = y2 + 1;
+  return true;
+}
 
-  const int rowstride  = cairo_image_surface_get_stride(surface);
-  unsigned char* image = cairo_image_surface_get_data(surface);
+static image_mask_t* image_mask_new(const zathura_rectangle_t* rectangles, size_t num_rectangles, unsigned int width,
+                                    unsigned int height) {
+  image_mask_t* mask = g_try_malloc0(sizeof(image_mask_t));
+  if (mask == NULL) {
+    return NULL;
+  }
 
-  for (unsigned int y = 0; y < page_height; y++) {
-    unsigned char* data = image + y * rowstride;
+  mask->row_offsets = g_try_malloc0_n(height + 1, sizeof(unsigned int));
+  if (mask->row_offsets == NULL) {
+    image_mask_free(mask);
+    return NULL;
+  }
 
-    for (unsigned int x = 0; x < page_width; x++, data += 4) {
-      /* Check if the pixel belongs to an image when in reverse video mode*/
-      if (priv->recolor.reverse_video == true && found_images == true) {
-        const bool inside_image = pixel_inside_rectangles(rectangles, x, y);
-        /* If it's inside and image don't recolor */
-        if (inside_image == true) {
-          /* It is not guaranteed that the pixel is already opaque. */
-          data[3] = 255;
-          continue;
-        }
+  /* count the spans of each row */
+  unsigned int x_start, x_end, y_start, y_end;
+  for (size_t idx = 0; idx != num_rectangles; ++idx) {
+    if (image_rectangle_clip(&rectangles[idx], width, height, &x_start, &x_end, &y_start, &y_end) == true) {
+      for (unsigned int y = y_start; y < y_end; ++y) {
+        ++mask->row_offsets[y + 1];
       }
+    }
+  }
+  for (unsigned int y = 0; y < height; ++y) {
+    mask->row_offsets[y + 1] += mask->row_offsets[y];
+  }
 
-      /* Careful. data color components blue, green, red. */
-      const double rgb[3] = {data[2] / 255., data[1] / 255., data[0] / 255.};
-
-      /* compute h, s, l data   */
-      double l = weights[0] * rgb[0] + weights[1] * rgb[1] + weights[2] * rgb[2];
-
-      if (priv->recolor.hue == true) {
-        /* adjusting lightness keeping hue of current color. white and black
-         * go to grays of same ligtness as light and dark colors. */
-        const double h[3] = {rgb[0] - l, rgb[1] - l, rgb[2] - l};
-
-        /* u is the maximum possible saturation for given h and l. s is a
-         * rescaled saturation between 0 and 1 */
-        const double u = colorumax(h, l, 0, 1);
-        const double s = fabs(u) > DBL_EPSILON ? 1.0 / u : 0.0;
-
-        /* adjust according to quartic curve, then average with original weighed
-         * by half saturation. */
-        if (adjust_lightness) {
-          /* l = l * s/2 + l^4 * (1 - s/2) */
-          double adj = l * l * l * l;
-          l          = (l - adj) * (s * 0.5) + adj;
-        }
-
-        /* Interpolates lightness between light and dark colors. white goes to
-         * light, and black goes to dark. */
-        l = l * (l2 - l1) + l1;
+  const unsigned int num_spans  = mask->row_offsets[height];
+  mask->spans                   = g_try_malloc_n(MAX(num_spans, 1), sizeof(image_span_t));
+  g_autofree unsigned int* fill = g_try_malloc_n(height + 1, sizeof(unsigned int));
+  if (mask->spans == NULL || fill == NULL) {
+    image_mask_free(mask);
+    return NULL;
+  }
 
-        const double su = s * colorumax(h, l, l1, l2);
+  /* rasterize the rectangles */
+  memcpy(fill, mask->row_offsets, (height + 1) * sizeof(unsigned int));
+  for (size_t idx = 0; idx != num_rectangles; ++idx) {
+    if (image_rectangle_clip(&rectangles[idx], width, height, &x_start, &x_end, &y_start, &y_end) == true) {
+      for (unsigned int y = y_start; y < y_end; ++y) {
+        mask->spans[fill[y]++] = (image_span_t){.start = x_start, .end = x_end};
+      }
+    }
+  }
 
-        /* Mix lightcolor, darkcolor and the original color, according to the
-         * minimal and maximal channel of the original color */
-        const double tr1 = (1. - fmax(fmax(rgb[0], rgb[1]), rgb[2]));
-        const double tr2 = fmin(fmin(rgb[0], rgb[1]), rgb[2]);
-        data[3]          = (unsigned char)round(255. * (1. - tr1 * negalph1 - tr2 * negalph2));
-        data[2]          = (unsigned char)round(255. * fmin(1, fmax(0, tr1 * h1[0] + tr2 * h2[0] + (l + su * h[0]))));
-        data[1]          = (unsigned char)round(255. * fmin(1, fmax(0, tr1 * h1[1] + tr2 * h2[1] + (l + su * h[1]))));
-        data[0]          = (unsigned char)round(255. * fmin(1, fmax(0, tr1 * h1[2] + tr2 * h2[2] + (l + su * h[2]))));
+  /* sort and merge the spans of each row, compacting them in place */
+  unsigned int begin = 0;
+  unsigned int count = 0;
+  for (unsigned int y = 0; y < height; ++y) {
+    const unsigned int end = mask->row_offsets[y + 1];
+    qsort(mask->spans + begin, end - begin, sizeof(image_span_t), compare_image_spans);
+
+    mask->row_offsets[y] = count;
+    for (unsigned int idx = begin; idx < end; ++idx) {
+      if (count > mask->row_offsets[y] && mask->spans[idx].start <= mask->spans[count - 1].end) {
+        mask->spans[count - 1].end = MAX(mask->spans[count - 1].end, mask->spans[idx].end);
       } else {
-        if (adjust_lightness) {
-          l = l * l;
-        }
-
-        /* linear interpolation between dark and light with color ligtness as
-         * a parameter */
-        const double f1 = 1. - (1. - fmax(fmax(rgb[0], rgb[1]), rgb[2])) * negalph1;
-        const double f2 = fmin(fmin(rgb[0], rgb[1]), rgb[2]) * negalph2;
-        data[3]         = (unsigned char)round(255. * (f1 - f2));
-        data[2]         = (unsigned char)round(255. * (l * rgb_diff[0] - f2 * rgb2.red + f1 * rgb1.red));
-        data[1]         = (unsigned char)round(255. * (l * rgb_diff[1] - f2 * rgb2.green + f1 * rgb1.green));
-        data[0]         = (unsigned char)round(255. * (l * rgb_diff[2] - f2 * rgb2.blue + f1 * rgb1.blue));
+        mask->spans[count++] = mask->spans[idx];
       }
     }
+    begin = end;
   }
-}
-
-static void recolor_fast(ZathuraRendererPrivate* priv, unsigned int page_width, unsigned int page_height,
-                         cairo_surface_t* surface, girara_list_t* rectangles, bool found_images) {
-  const GdkRGBA rgb1 = priv->recolor.dark;
-  const GdkRGBA rgb2 = priv->recolor.light;
+  mask->row_offsets[height] = count;
 
-  const double l1 = weights[0] * rgb1.red + weights[1] * rgb1.green + weights[2] * rgb1.blue;
-  const double l2 = weights[0] * rgb2.red + weights[1] * rgb2.green + weights[2] * rgb2.blue;
-
-  const double rgb_diff[] = {rgb2.red - rgb1.red, rgb2.green - rgb1.green, rgb2.blue - rgb1.blue};
+  return mask;
+}
 
-  bool adjust_lightness = priv->recolor.adjust_lightness;
+/* Number of rows recolored at once by one thread */
+#define RECOLOR_BAND_HEIGHT 64
 
-  const int rowstride  = cairo_image_surface_get_stride(surface);
-  unsigned char* image = cairo_image_surface_get_data(surface);
+/* recolor work shared between the render thread and the recolor pool */
+typedef struct recolor_bands_s {
+  ZathuraRendererPrivate* priv;
+  render_job_t* job;
+  const zathura_recolor_t* context;
+  const image_mask_t* images; /**< Image pixels to skip, or NULL */
+  unsigned char* image;
+  int rowstride;
+  unsigned int width;
+  unsigned int height;
+  unsigned int num_bands;
+  atomic_uint next_band; /**< Next band to be recolored */
+  GMutex mutex;
+  GCond cond;
+  unsigned int pending_helpers; /**< Helpers pushed to the recolor pool that did not finish yet */
+} recolor_bands_t;
+
+static void recolor_rows(recolor_bands_t* bands, unsigned int y_start, unsigned int y_end) {
+  const unsigned int page_width = bands->width;
+
+  for (unsigned int y = y_start; y < y_end; y++) {
+    unsigned char* data = bands->image + y * bands->rowstride;
+
+    if (bands->images == NULL) {
+      zathura_recolor_span(bands->context, data, page_width);
+      continue;
+    }
 
-  for (unsigned int y = 0; y < page_height; y++) {
-    unsigned char* data = image + y * rowstride;
+    /* recolor the spans between images */
+    const image_span_t* span = bands->images->spans + bands->images->row_offsets[y];
+    const image_span_t* last = bands->images->spans + bands->images->row_offsets[y + 1];
+    unsigned int x           = 0;
+    for (; span != last; ++span) {
+      zathura_recolor_span(bands->context, data + 4 * x, span->start - x);
 
-    for (unsigned int x = 0; x < page_width; x++, data += 4) {
-      /* Check if the pixel belongs to an image when in reverse video mode*/
-      if (priv->recolor.reverse_video == true && found_images == true) {
-        const bool inside_image = pixel_inside_rectangles(rectangles, x, y);
-        /* If it's inside and image don't recolor */
-        if (inside_image == true) {
-          /* It is not guaranteed that the pixel is already opaque. */
-          data[3] = 255;
-          continue;
-        }
+      /* Inside an image don't recolor, but it is not guaranteed that the pixel is already opaque. */
+      for (x = span->start; x < span->end; ++x) {
+        data[4 * x + 3] = 255;
       }
+    }
+    zathura_recolor_span(bands->context, data + 4 * x, page_width - x);
+  }
+}
 
-      /* Careful. data color components blue, green, red. */
-      const double rgb[3] = {data[2] / 255., data[1] / 255., data[0] / 255.};
-
-      /* compute h, s, l data   */
-      double l = weights[0] * rgb[0] + weights[1] * rgb[1] + weights[2] * rgb[2];
+/* Recolor bands until all are taken or the job is aborted */
+static void recolor_bands(recolor_bands_t* bands) {
+  while (bands->priv->about_to_close == false && bands->job->aborted == false) {
+    const unsigned int band = atomic_fetch_add(&bands->next_band, 1);
+    if (band >= bands->num_bands) {
+      break;
+    }
 
-      if (priv->recolor.hue == true) {
-        /* adjusting lightness keeping hue of current color. white and black
-         * go to grays of same ligtness as light and dark colors. */
-        const double h[3] = {rgb[0] - l, rgb[1] - l, rgb[2] - l};
+    const unsigned int y_start = band * RECOLOR_BAND_HEIGHT;
+    recolor_rows(bands, y_start, MIN(y_start + RECOLOR_BAND_HEIGHT, bands->height));
+  }
+}
 
-        /* u is the maximum possible saturation for given h and l. s is a
-         * rescaled saturation between 0 and 1 */
-        const double u = colorumax(h, l, 0, 1);
-        const double s = fabs(u) > DBL_EPSILON ? 1.0 / u : 0.0;
+static void recolor_job(void* data, void* UNUSED(user_data)) {
+  recolor_bands_t* bands = data;
+  recolor_bands(bands);
 
-        /* adjust according to quartic curve, then average with original weighed
-         * by half saturation. */
-        if (adjust_lightness) {
-          /* l = l * s/2 + l^4 * (1 - s/2) */
-          double adj = l * l * l * l;
-          l          = (l - adj) * (s * 0.5) + adj;
-        }
-
-        /* Interpolates lightness between light and dark colors. white goes to
-         * light, and black goes to dark. */
-        l = l * (l2 - l1) + l1;
+  g_mutex_lock(&bands->mutex);
+  if (--bands->pending_helpers == 0) {
+    g_cond_signal(&bands->cond);
+  }
+  g_mutex_unlock(&bands->mutex);
+}
 
-        const double su = s * colorumax(h, l, l1, l2);
+static void recolor_context_clear(void* data) {
+  recolor_context_t* context = data;
+  zathura_recolor_free(context->recolor);
+}
 
-        /* Mix lightcolor, darkcolor and the original color, according to the
-         * minimal and maximal channel of the original color */
-        data[3] = 255;
-        data[2] = (unsigned char)round(255. * (l + su * h[0]));
-        data[1] = (unsigned char)round(255. * (l + su * h[1]));
-        data[0] = (unsigned char)round(255. * (l + su * h[2]));
-      } else {
-        if (adjust_lightness) {
-          l = l * l;
-        }
+static void recolor_context_release(recolor_context_t* context) {
+  g_rc_box_release_full(context, recolor_context_clear);
+}
 
-        /* linear interpolation between dark and light with color ligtness as
-         * a parameter */
-        data[3] = 255;
-        data[2] = (unsigned char)round(255. * (l * rgb_diff[0] + rgb1.red));
-        data[1] = (unsigned char)round(255. * (l * rgb_diff[1] + rgb1.green));
-        data[0] = (unsigned char)round(255. * (l * rgb_diff[2] + rgb1.blue));
-      }
+/* returns a reference to the context of the current recolor settings, the
+ * lookup tables are only rebuilt when the settings have changed */
+static recolor_context_t* recolor_context_acquire(ZathuraRendererPrivate* priv) {
+  g_mutex_lock(&priv->recolor.mutex);
+
+  const guint generation = priv->recolor.generation;
+  if (priv->recolor.context == NULL || priv->recolor.context->generation != generation) {
+    g_clear_pointer(&priv->recolor.context, recolor_context_release);
+
+    zathura_recolor_t* recolor = zathura_recolor_new(&priv->recolor.light, &priv->recolor.dark, priv->recolor.hue,
+                                                     priv->recolor.adjust_lightness);
+    if (recolor != NULL) {
+      priv->recolor.context             = g_rc_box_new0(recolor_context_t);
+      priv->recolor.context->recolor    = recolor;
+      priv->recolor.context->generation = generation;
     }
   }
+
+  recolor_context_t* context = priv->recolor.context != NULL ? g_rc_box_acquire(priv->recolor.context) : NULL;
+  g_mutex_unlock(&priv->recolor.mutex);
+
+  return context;
 }
 
-static void recolor(ZathuraRendererPrivate* priv, zathura_page_t* page, unsigned int page_width,
-                    unsigned int page_height, cairo_surface_t* surface, zathura_device_factors_t device_factors) {
+static bool recolor(ZathuraRenderer* renderer, render_job_t* job, zathura_page_t* page, unsigned int page_width,
+                    unsigned int page_height, double offset_x, double offset_y, cairo_surface_t* surface,
+                    zathura_device_factors_t device_factors) {
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+
   /* uses a representation of a rgb color as follows:
      - a lightness scalar (between 0,1), which is a weighted average of r, g, b,
      - a hue vector, which indicates a radian direction from the grey axis,
@@ -704,63 +910,103 @@ static void recolor(ZathuraRendererPrivate* priv, zathura_page_t* page, unsigned
        in the boundary of the rgb cube.
   */
 
-  /* TODO: split handling of image handling off
-   * Ideally we would create a mask surface for the location of the images and
-   * we would blit the recolored and unmodified surfaces together to get the
-   * same effect.
-   */
+  recolor_context_t* context = recolor_context_acquire(priv);
+  if (context == NULL) {
+    girara_warning("Failed to set up recoloring.");
+    return true;
+  }
 
   cairo_surface_flush(surface);
 
-  const GdkRGBA rgb1 = priv->recolor.dark;
-  const GdkRGBA rgb2 = priv->recolor.light;
-
-  /* Decide if we can use the older, faster formulas */
-  const bool fast_formula =
-      (!priv->recolor.hue || (fabs(rgb1.red - rgb1.blue) < DBL_EPSILON && fabs(rgb1.red - rgb1.green) < DBL_EPSILON &&
-                              fabs(rgb2.red - rgb2.blue) < DBL_EPSILON && fabs(rgb2.red - rgb2.green) < DBL_EPSILON)) &&
-      (rgb1.alpha >= 1. - DBL_EPSILON && rgb2.alpha >= 1. - DBL_EPSILON);
-
-  g_autoptr(girara_list_t) rectangles = NULL;
-  bool found_images                   = false;
-
-  /* If in reverse video mode retrieve images */
+  /* If in reverse video mode retrieve images and rasterize them once, so that
+   * skipping them does not depend on the number of images */
+  image_mask_t* images_mask = NULL;
   if (priv->recolor.reverse_video == true) {
+    /* plugins that are not thread-safe have to be serialized */
+    zathura_document_t* document = zathura_page_get_document(page);
+    const bool concurrent        = zathura_plugin_supports_concurrent_render(zathura_document_get_plugin(document));
+
+    if (concurrent == false) {
+      zathura_renderer_lock(renderer);
+    }
     g_autoptr(girara_list_t) images = zathura_page_images_get(page, NULL);
-    found_images                    = (images != NULL);
+    if (concurrent == false) {
+      zathura_renderer_unlock(renderer);
+    }
+    const size_t num_images = images != NULL ? girara_list_size(images) : 0;
+
+    if (num_images != 0) {
+      g_autofree zathura_rectangle_t* rectangles = g_try_malloc_n(num_images, sizeof(zathura_rectangle_t));
+      if (rectangles != NULL) {
+        /* Get images bounding boxes */
+        for (size_t idx = 0; idx != num_images; ++idx) {
+          zathura_image_t* image_it = girara_list_nth(images, idx);
+          zathura_rectangle_t* rect = &rectangles[idx];
+          *rect                     = recalc_rectangle(page, image_it->position);
+          /* Move rectangle into the rendered part of the page and scale its coordinates by device factors to match
+           * surface pixel coordinates */
+          rect->x1 = (rect->x1 - offset_x) * device_factors.x;
+          rect->x2 = (rect->x2 - offset_x) * device_factors.x;
+          rect->y1 = (rect->y1 - offset_y) * device_factors.y;
+          rect->y2 = (rect->y2 - offset_y) * device_factors.y;
+        }
 
-    rectangles = girara_list_new_with_free(g_free);
-    if (rectangles == NULL) {
-      found_images = false;
-      girara_warning("Failed to retrieve images.");
+        images_mask = image_mask_new(rectangles, num_images, page_width, page_height);
+      }
+
+      if (images_mask == NULL) {
+        girara_warning("Failed to retrieve images.");
+      }
     }
+  }
 
-    if (found_images == true) {
-      /* Get images bounding boxes */
-      for (size_t idx = 0; idx != girara_list_size(images); ++idx) {
-        zathura_image_t* image_it = girara_list_nth(images, idx);
-        zathura_rectangle_t* rect = g_try_malloc(sizeof(zathura_rectangle_t));
-        if (rect == NULL) {
-          break;
-        }
-        *rect = recalc_rectangle(page, image_it->position);
-        /* Scale rectangle coordinates by device factors to match surface pixel coordinates */
-        rect->x1 *= device_factors.x;
-        rect->x2 *= device_factors.x;
-        rect->y1 *= device_factors.y;
-        rect->y2 *= device_factors.y;
-        girara_list_append(rectangles, rect);
+  recolor_bands_t bands = {
+      .priv       = priv,
+      .job        = job,
+      .context    = context->recolor,
+      .images     = images_mask,
+      .image      = cairo_image_surface_get_data(surface),
+      .rowstride  = cairo_image_surface_get_stride(surface),
+      .width      = page_width,
+      .height     = page_height,
+      .num_bands  = (page_height + RECOLOR_BAND_HEIGHT - 1) / RECOLOR_BAND_HEIGHT,
+  };
+  atomic_init(&bands.next_band, 0);
+  g_mutex_init(&bands.mutex);
+  g_cond_init(&bands.cond);
+  bands.pending_helpers = 0;
+
+  /* let the recolor pool help with the bands, but do our share as well */
+  if (priv->recolor_pool != NULL && bands.num_bands > 1) {
+    const unsigned int max_helpers = g_thread_pool_get_max_threads(priv->recolor_pool);
+    const unsigned int helpers     = MIN(bands.num_bands - 1, max_helpers);
+
+    g_mutex_lock(&bands.mutex);
+    for (unsigned int i = 0; i < helpers; ++i) {
+      if (g_thread_pool_push(priv->recolor_pool, &bands, NULL) == TRUE) {
+        ++bands.pending_helpers;
       }
     }
+    g_mutex_unlock(&bands.mutex);
   }
 
-  if (fast_formula == true) {
-    recolor_fast(priv, page_width, page_height, surface, rectangles, found_images);
-  } else {
-    recolor_slow(priv, page_width, page_height, surface, rectangles, found_images);
+  recolor_bands(&bands);
+
+  /* wait for the helpers since they refer to bands */
+  g_mutex_lock(&bands.mutex);
+  while (bands.pending_helpers != 0) {
+    g_cond_wait(&bands.cond, &bands.mutex);
   }
+  g_mutex_unlock(&bands.mutex);
+
+  g_mutex_clear(&bands.mutex);
+  g_cond_clear(&bands.cond);
 
   cairo_surface_mark_dirty(surface);
+  image_mask_free(images_mask);
+  recolor_context_release(context);
+
+  return atomic_load(&bands.next_band) >= bands.num_bands;
 }
 
 static bool invoke_completed_signal(render_job_t* job, cairo_surface_t* surface) {
@@ -777,8 +1023,54 @@ static bool invoke_completed_signal(render_job_t* job, cairo_surface_t* surface)
   return true;
 }
 
+/* Fingerprints are taken right after the first render, while the file most
+ * likely still is the version that was opened. Taking them when the document
+ * is reloaded would read the replaced file. */
+static void fingerprint_push(ZathuraRenderer* renderer, ZathuraRenderRequest* request) {
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+
+  if (atomic_load(&priv->fingerprint) == false || zathura_page_get_fingerprint(request_priv->page) != NULL ||
+      atomic_exchange(&request_priv->fingerprint_queued, true) == true) {
+    return;
+  }
+
+  render_job_t* job = g_try_malloc0(sizeof(render_job_t));
+  if (job == NULL) {
+    atomic_store(&request_priv->fingerprint_queued, false);
+    return;
+  }
+
+  job->request     = g_object_ref(request);
+  job->aborted     = false;
+  job->fingerprint = true;
+  g_thread_pool_push(priv->pool, job, NULL);
+}
+
+static void fingerprint_job(render_job_t* job, ZathuraRenderer* renderer) {
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(job->request);
+  zathura_page_t* page                      = request_priv->page;
+
+  if (priv->about_to_close == false && atomic_load(&priv->fingerprint) == true) {
+    /* plugins that are not thread-safe have to be serialized */
+    zathura_document_t* document = zathura_page_get_document(page);
+    const bool concurrent        = zathura_plugin_supports_concurrent_render(zathura_document_get_plugin(document));
+    if (concurrent == false) {
+      zathura_renderer_lock(renderer);
+    }
+    zathura_page_update_fingerprint(page);
+    if (concurrent == false) {
+      zathura_renderer_unlock(renderer);
+    }
+  }
+
+  atomic_store(&request_priv->fingerprint_queued, false);
+  job_free(job);
+}
+
 static bool render_to_cairo_surface(cairo_surface_t* surface, zathura_page_t* page, ZathuraRenderer* renderer,
-                                    double real_scale) {
+                                    double real_scale, double offset_x, double offset_y) {
   cairo_t* cairo = cairo_create(surface);
   if (cairo_status(cairo) != CAIRO_STATUS_SUCCESS) {
     return false;
@@ -789,14 +1081,27 @@ static bool render_to_cairo_surface(cairo_surface_t* surface, zathura_page_t* pa
   cairo_paint(cairo);
   cairo_restore(cairo);
 
+  /* move the rendered part of the page to the origin of the surface */
+  if (offset_x != 0 || offset_y != 0) {
+    cairo_translate(cairo, -offset_x, -offset_y);
+  }
+
   /* apply scale (used by e.g. Poppler as pixels per point) */
   if (fabs(real_scale - 1.0f) > FLT_EPSILON) {
     cairo_scale(cairo, real_scale, real_scale);
   }
 
-  zathura_renderer_lock(renderer);
+  /* plugins that are not thread-safe have to be serialized */
+  zathura_document_t* document = zathura_page_get_document(page);
+  const bool concurrent        = zathura_plugin_supports_concurrent_render(zathura_document_get_plugin(document));
+
+  if (concurrent == false) {
+    zathura_renderer_lock(renderer);
+  }
   const int err = zathura_page_render(page, cairo, false);
-  zathura_renderer_unlock(renderer);
+  if (concurrent == false) {
+    zathura_renderer_unlock(renderer);
+  }
   cairo_destroy(cairo);
 
   return err == ZATHURA_ERROR_OK;
@@ -807,6 +1112,11 @@ static bool render(render_job_t* job, ZathuraRenderRequest* request, ZathuraRend
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
   zathura_page_t* page                      = request_priv->page;
 
+  /* the size of pages is only known after their initialization */
+  if (zathura_page_initialize(page) != ZATHURA_ERROR_OK) {
+    return false;
+  }
+
   /* create cairo surface */
   unsigned int page_width  = 0;
   unsigned int page_height = 0;
@@ -818,13 +1128,32 @@ static bool render(render_job_t* job, ZathuraRenderRequest* request, ZathuraRend
 
   zathura_device_factors_t device_factors = {0};
   double real_scale                       = 1;
+  double offset_x                         = 0;
+  double offset_y                         = 0;
   if (request_priv->render_plain == false) {
     /* page size in user pixels based on document zoom: if PPI information is
      * correct, 100% zoom will result in 72 documents points per inch of screen
      * (i.e. document size on screen matching the physical paper size). */
     real_scale = page_calc_height_width(document, page, &page_height, &page_width, false);
 
+    /* only render the requested tile, clipped to the page */
+    if (request_priv->tile.enabled == true) {
+      if (request_priv->tile.x >= page_width || request_priv->tile.y >= page_height) {
+        return false;
+      }
+
+      offset_x    = request_priv->tile.x;
+      offset_y    = request_priv->tile.y;
+      page_width  = MIN(request_priv->tile.width, page_width - request_priv->tile.x);
+      page_height = MIN(request_priv->tile.height, page_height - request_priv->tile.y);
+    }
+
     device_factors = zathura_document_get_device_factors(document);
+    /* a preview has fewer pixels, but the same size in user pixels */
+    if (job->preview == true) {
+      device_factors.x *= RENDER_PREVIEW_SCALE;
+      device_factors.y *= RENDER_PREVIEW_SCALE;
+    }
     page_width *= device_factors.x;
     page_height *= device_factors.y;
   } else {
@@ -842,6 +1171,9 @@ static bool render(render_job_t* job, ZathuraRenderRequest* request, ZathuraRend
   if (request_priv->render_plain == false) {
     cairo_surface_set_device_scale(surface, device_factors.x, device_factors.y);
   }
+  if (job->preview == true) {
+    cairo_surface_set_user_data(surface, &preview_surface_key, GINT_TO_POINTER(1), NULL);
+  }
 
   if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
     cairo_surface_destroy(surface);
@@ -849,7 +1181,7 @@ static bool render(render_job_t* job, ZathuraRenderRequest* request, ZathuraRend
   }
 
   /* actually render to the surface */
-  if (!render_to_cairo_surface(surface, page, renderer, real_scale)) {
+  if (!render_to_cairo_surface(surface, page, renderer, real_scale, offset_x, offset_y)) {
     cairo_surface_destroy(surface);
     return false;
   }
@@ -857,22 +1189,33 @@ static bool render(render_job_t* job, ZathuraRenderRequest* request, ZathuraRend
   /* before recoloring, check if we've been aborted */
   if (priv->about_to_close == true || job->aborted == true) {
     girara_debug("Rendering of page %d aborted", zathura_page_get_index(request_priv->page) + 1);
-    remove_job_and_free(job);
+    abandon_job(renderer, job);
     cairo_surface_destroy(surface);
     return true;
   }
 
   /* recolor */
   if (request_priv->render_plain == false && priv->recolor.enabled == true) {
-    recolor(priv, page, page_width, page_height, surface, device_factors);
+    if (recolor(renderer, job, page, page_width, page_height, offset_x, offset_y, surface, device_factors) == false) {
+      girara_debug("Recoloring of page %d aborted", zathura_page_get_index(request_priv->page) + 1);
+      abandon_job(renderer, job);
+      cairo_surface_destroy(surface);
+      return true;
+    }
   }
 
+  /* the job is owned by the main thread once the signal is invoked */
+  const bool full_render = request_priv->render_plain == false && job->preview == false;
   if (!invoke_completed_signal(job, surface)) {
     cairo_surface_destroy(surface);
     return false;
   }
 
   cairo_surface_destroy(surface);
+  if (full_render == true) {
+    /* only the first full render of a page queues its fingerprint */
+    fingerprint_push(renderer, request);
+  }
 
   return true;
 }
@@ -884,14 +1227,32 @@ static void render_job(void* data, void* user_data) {
   g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
   g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
 
-  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  if (priv->about_to_close == true || job->aborted == true) {
-    /* back out early */
-    remove_job_and_free(job);
+  if (job->fingerprint == true) {
+    fingerprint_job(job, renderer);
     return;
   }
 
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+
+  /* decide atomically with respect to render_request_push whether the job runs */
+  g_mutex_lock(&request_priv->jobs_mutex);
+  const bool aborted = priv->about_to_close == true || job->aborted == true;
+  if (aborted == true) {
+    girara_list_remove(request_priv->active_jobs, job);
+  } else {
+    job->running = true;
+    job->key     = render_key_get(renderer, request_priv->page);
+  }
+  g_mutex_unlock(&request_priv->jobs_mutex);
+
+  if (aborted == true) {
+    /* back out early */
+    job_free(job);
+    return;
+  }
+
+  atomic_fetch_add(&priv->jobs.executed, 1);
   girara_debug("Rendering page %d ...", zathura_page_get_index(request_priv->page) + 1);
   if (render(job, request, renderer) != true) {
     girara_error("Rendering failed (page %d)\n", zathura_page_get_index(request_priv->page) + 1);
@@ -910,17 +1271,20 @@ void render_all(zathura_t* zathura) {
   /* unmark all pages */
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
   for (unsigned int page_id = 0; page_id < number_of_pages; ++page_id) {
+    /* widgets created later get the new size right away */
+    GtkWidget* widget = zathura_page_get_widget_by_number(zathura, page_id);
+    if (widget == NULL) {
+      continue;
+    }
+
     zathura_page_t* page     = zathura_document_get_page(document, page_id);
     unsigned int page_height = 0, page_width = 0;
 
     page_calc_height_width(document, page, &page_height, &page_width, true);
 
     girara_debug("Queuing resize for page %u to %u x %u.", page_id, page_width, page_height);
-    GtkWidget* widget = zathura_page_get_widget(zathura, page);
-    if (widget != NULL) {
-      zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(widget), page_width, page_height);
-      gtk_widget_queue_resize(widget);
-    }
+    zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(widget), page_width, page_height);
+    gtk_widget_queue_resize(widget);
   }
 }
 
@@ -932,9 +1296,29 @@ static gint render_thread_sort(gconstpointer a, gconstpointer b, gpointer UNUSED
   const render_job_t* job_a = a;
   const render_job_t* job_b = b;
   if (job_a->aborted == job_b->aborted) {
+    /* fingerprints are only taken when there is nothing to render */
+    if (job_a->fingerprint != job_b->fingerprint) {
+      return job_a->fingerprint ? 1 : -1;
+    }
+    /* previews are cheap, so show all of them before rendering full pages */
+    if (job_a->preview != job_b->preview) {
+      return job_a->preview ? -1 : 1;
+    }
+
+    /* pages that are not visible yet come last */
+    if (job_a->prefetch != job_b->prefetch) {
+      return job_a->prefetch ? 1 : -1;
+    }
+
     ZathuraRenderRequestPrivate* priv_a = zathura_render_request_get_instance_private(job_a->request);
     ZathuraRenderRequestPrivate* priv_b = zathura_render_request_get_instance_private(job_b->request);
 
+    /* prefetched pages closer to the viewport have a more recent view time */
+    if (job_a->prefetch == true) {
+      return priv_a->last_view_time > priv_b->last_view_time ? -1
+                                                             : (priv_a->last_view_time < priv_b->last_view_time ? 1 : 0);
+    }
+
     return priv_a->last_view_time < priv_b->last_view_time ? -1
                                                            : (priv_a->last_view_time > priv_b->last_view_time ? 1 : 0);
   }
@@ -945,112 +1329,258 @@ static gint render_thread_sort(gconstpointer a, gconstpointer b, gpointer UNUSED
 
 /* cache functions */
 
-static bool page_cache_is_cached(ZathuraRenderer* renderer, unsigned int page_index) {
-  g_return_val_if_fail(renderer != NULL, false);
+static bool page_cache_entry_less(const page_cache_entry_t* a, const page_cache_entry_t* b) {
+  return a->last_view_time < b->last_view_time;
+}
+
+static void page_cache_heap_swap(GPtrArray* heap, guint i, guint j) {
+  page_cache_entry_t* a = g_ptr_array_index(heap, i);
+  page_cache_entry_t* b = g_ptr_array_index(heap, j);
+
+  g_ptr_array_index(heap, i) = b;
+  g_ptr_array_index(heap, j) = a;
+  a->heap_index              = j;
+  b->heap_index              = i;
+}
+
+static void page_cache_heap_sift_up(GPtrArray* heap, guint idx) {
+  while (idx > 0) {
+    const guint parent = (idx - 1) / 2;
+    if (page_cache_entry_less(g_ptr_array_index(heap, idx), g_ptr_array_index(heap, parent)) == false) {
+      break;
+    }
+    page_cache_heap_swap(heap, idx, parent);
+    idx = parent;
+  }
+}
+
+static void page_cache_heap_sift_down(GPtrArray* heap, guint idx) {
+  while (true) {
+    const guint left  = 2 * idx + 1;
+    const guint right = left + 1;
+    guint smallest    = idx;
+
+    if (left < heap->len &&
+        page_cache_entry_less(g_ptr_array_index(heap, left), g_ptr_array_index(heap, smallest)) == true) {
+      smallest = left;
+    }
+    if (right < heap->len &&
+        page_cache_entry_less(g_ptr_array_index(heap, right), g_ptr_array_index(heap, smallest)) == true) {
+      smallest = right;
+    }
+    if (smallest == idx) {
+      break;
+    }
+
+    page_cache_heap_swap(heap, idx, smallest);
+    idx = smallest;
+  }
+}
+
+static void page_cache_heap_remove(GPtrArray* heap, page_cache_entry_t* entry) {
+  const guint idx  = entry->heap_index;
+  const guint last = heap->len - 1;
+
+  if (idx != last) {
+    page_cache_heap_swap(heap, idx, last);
+  }
+  g_ptr_array_remove_index(heap, last);
+
+  if (idx < heap->len) {
+    page_cache_heap_sift_up(heap, idx);
+    page_cache_heap_sift_down(heap, idx);
+  }
+}
+
+static page_cache_entry_t* page_cache_lookup(ZathuraRendererPrivate* priv, unsigned int page_index) {
+  return g_hash_table_lookup(priv->page_cache.entries, GUINT_TO_POINTER(page_index));
+}
+
+/* Remove the entry from the cache without notifying anyone. The entry is freed. */
+static void page_cache_remove_entry(ZathuraRendererPrivate* priv, page_cache_entry_t* entry) {
+  page_cache_heap_remove(priv->page_cache.heap, entry);
+  priv->page_cache.bytes -= entry->size;
+  g_hash_table_remove(priv->page_cache.entries, GUINT_TO_POINTER(entry->page_index));
+}
+
+static bool page_cache_is_full(ZathuraRendererPrivate* priv) {
+  if (g_hash_table_size(priv->page_cache.entries) > priv->page_cache.max_pages) {
+    return true;
+  }
+
+  return priv->page_cache.max_bytes != 0 &&
+         priv->page_cache.bytes + priv->page_cache.tile_bytes > priv->page_cache.max_bytes;
+}
+
+/* Evict least recently viewed pages until the cache is within its limits. The
+ * entry keep is never evicted. */
+static void page_cache_shrink(ZathuraRenderer* renderer, const page_cache_entry_t* keep) {
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
 
-  if (priv->page_cache.num_cached_pages != 0) {
-    for (size_t i = 0; i < priv->page_cache.size; ++i) {
-      if (priv->page_cache.cache[i] >= 0 && page_index == (unsigned int)priv->page_cache.cache[i]) {
-        girara_debug("Page %d is a cache hit", page_index + 1);
-        return true;
-      }
+  while (page_cache_is_full(priv) == true && priv->page_cache.heap->len > 0) {
+    page_cache_entry_t* lru = g_ptr_array_index(priv->page_cache.heap, 0);
+    if (lru == keep) {
+      break;
     }
+
+    ZathuraRenderRequest* request = g_object_ref(lru->request);
+    const unsigned int page_index = lru->page_index;
+
+    page_cache_remove_entry(priv, lru);
+    ++priv->page_cache.evictions;
+
+    /* emit the signal */
+    g_signal_emit(request, request_signals[REQUEST_CACHE_INVALIDATED], 0);
+    girara_debug("Invalidated page %d (%zu bytes cached)", page_index + 1, priv->page_cache.bytes);
+    g_object_unref(request);
+  }
+}
+
+static void page_cache_update_view_time(ZathuraRenderer* renderer, ZathuraRenderRequest* request) {
+  if (renderer == NULL) {
+    return;
+  }
+
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+
+  page_cache_entry_t* entry = page_cache_lookup(priv, zathura_page_get_index(request_priv->page));
+  if (entry == NULL || entry->request != request) {
+    return;
+  }
+
+  entry->last_view_time = request_priv->last_view_time;
+  page_cache_heap_sift_up(priv->page_cache.heap, entry->heap_index);
+  page_cache_heap_sift_down(priv->page_cache.heap, entry->heap_index);
+}
+
+static void page_cache_update_size(ZathuraRenderer* renderer, ZathuraRenderRequest* request,
+                                   cairo_surface_t* surface) {
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+
+  page_cache_entry_t* entry = page_cache_lookup(priv, zathura_page_get_index(request_priv->page));
+  if (entry == NULL || entry->request != request) {
+    return;
+  }
+
+  const size_t size = (size_t)cairo_image_surface_get_stride(surface) * cairo_image_surface_get_height(surface);
+  priv->page_cache.bytes -= entry->size;
+  priv->page_cache.bytes += size;
+  entry->size = size;
+
+  page_cache_shrink(renderer, entry);
+}
+
+static void page_cache_remove_request(ZathuraRenderer* renderer, ZathuraRenderRequest* request) {
+  ZathuraRendererPrivate* priv              = zathura_renderer_get_instance_private(renderer);
+  ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
+  if (request_priv->page == NULL) {
+    return;
   }
 
-  girara_debug("Page %d is a cache miss", page_index + 1);
-  return false;
+  page_cache_entry_t* entry = page_cache_lookup(priv, zathura_page_get_index(request_priv->page));
+  if (entry != NULL && entry->request == request) {
+    page_cache_remove_entry(priv, entry);
+  }
 }
 
 static int find_request_by_page_index(const void* req, const void* data) {
   ZathuraRenderRequest* request = (void*)req;
-  const unsigned int page_index = *((const int*)data);
+  const unsigned int page_index = *((const unsigned int*)data);
 
   ZathuraRenderRequestPrivate* priv = zathura_render_request_get_instance_private(request);
-  if (zathura_page_get_index(priv->page) == page_index) {
+  /* tiles are managed by their owners and never enter the page cache */
+  if (priv->tile.enabled == false && zathura_page_get_index(priv->page) == page_index) {
     return 0;
   }
   return 1;
 }
 
-static ssize_t page_cache_lru_invalidate(ZathuraRenderer* renderer) {
-  g_return_val_if_fail(renderer != NULL, -1);
+void zathura_renderer_page_cache_add(ZathuraRenderer* renderer, unsigned int page_index) {
+  g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  g_return_val_if_fail(priv->page_cache.size != 0, -1);
-
-  ssize_t lru_index             = 0;
-  gint64 lru_view_time          = G_MAXINT64;
-  ZathuraRenderRequest* request = NULL;
-  for (size_t i = 0; i < priv->page_cache.size; ++i) {
-    ZathuraRenderRequest* tmp_request =
-        girara_list_find(priv->requests, find_request_by_page_index, &priv->page_cache.cache[i]);
-    g_return_val_if_fail(tmp_request != NULL, -1);
-    ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(tmp_request);
-
-    if (request_priv->last_view_time < lru_view_time) {
-      lru_view_time = request_priv->last_view_time;
-      lru_index     = i;
-      request       = tmp_request;
-    }
+  if (page_cache_lookup(priv, page_index) != NULL) {
+    return;
   }
 
+  ZathuraRenderRequest* request = girara_list_find(priv->requests, find_request_by_page_index, &page_index);
+  g_return_if_fail(request != NULL);
   ZathuraRenderRequestPrivate* request_priv = zathura_render_request_get_instance_private(request);
 
-  /* emit the signal */
-  g_signal_emit(request, request_signals[REQUEST_CACHE_INVALIDATED], 0);
-  girara_debug("Invalidated page %d at cache index %zd", zathura_page_get_index(request_priv->page) + 1, lru_index);
-  priv->page_cache.cache[lru_index] = -1;
-  --priv->page_cache.num_cached_pages;
+  page_cache_entry_t* entry = g_try_malloc0(sizeof(page_cache_entry_t));
+  if (entry == NULL) {
+    return;
+  }
 
-  return lru_index;
-}
+  entry->page_index     = page_index;
+  entry->request        = request;
+  entry->last_view_time = request_priv->last_view_time;
+  entry->size           = 0;
+  entry->heap_index     = priv->page_cache.heap->len;
 
-static bool page_cache_is_full(ZathuraRenderer* renderer, bool* result) {
-  g_return_val_if_fail(ZATHURA_IS_RENDERER(renderer) && result != NULL, false);
+  g_hash_table_insert(priv->page_cache.entries, GUINT_TO_POINTER(page_index), entry);
+  g_ptr_array_add(priv->page_cache.heap, entry);
+  page_cache_heap_sift_up(priv->page_cache.heap, entry->heap_index);
 
-  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  *result                      = priv->page_cache.num_cached_pages == priv->page_cache.size;
+  page_cache_shrink(renderer, entry);
+  girara_debug("Page %d is cached (%u pages cached)", page_index + 1, g_hash_table_size(priv->page_cache.entries));
 
-  return true;
+  g_signal_emit(request, request_signals[REQUEST_CACHE_ADDED], 0);
 }
 
-static void page_cache_invalidate_all(ZathuraRenderer* renderer) {
+void zathura_renderer_page_cache_count(ZathuraRenderer* renderer, bool hit) {
   g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  for (size_t i = 0; i < priv->page_cache.size; ++i) {
-    priv->page_cache.cache[i] = -1;
+  if (hit == true) {
+    ++priv->page_cache.hits;
+  } else {
+    ++priv->page_cache.misses;
   }
-  priv->page_cache.num_cached_pages = 0;
 }
 
-void zathura_renderer_page_cache_add(ZathuraRenderer* renderer, unsigned int page_index) {
+void zathura_renderer_tile_cache_update_size(ZathuraRenderer* renderer, size_t added, size_t removed) {
   g_return_if_fail(ZATHURA_IS_RENDERER(renderer));
-  if (page_cache_is_cached(renderer, page_index) == true) {
-    return;
-  }
 
   ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
-  bool full                    = false;
-  if (page_cache_is_full(renderer, &full) == false) {
-    return;
-  } else if (full == true) {
-    const ssize_t idx = page_cache_lru_invalidate(renderer);
-    if (idx == -1) {
-      return;
-    }
+  priv->page_cache.tile_bytes -= MIN(removed, priv->page_cache.tile_bytes);
+  priv->page_cache.tile_bytes += added;
 
-    priv->page_cache.cache[idx] = page_index;
-    ++priv->page_cache.num_cached_pages;
-    girara_debug("Page %d is cached at cache index %zd", page_index + 1, idx);
-  } else {
-    priv->page_cache.cache[priv->page_cache.num_cached_pages++] = page_index;
-    girara_debug("Page %d is cached at cache index %zu", page_index + 1, priv->page_cache.num_cached_pages - 1);
+  /* tiles of the visible pages take precedence over cached pages */
+  if (added > removed) {
+    page_cache_shrink(renderer, NULL);
   }
+}
 
-  ZathuraRenderRequest* request = girara_list_find(priv->requests, find_request_by_page_index, &page_index);
-  g_return_if_fail(request != NULL);
-  g_signal_emit(request, request_signals[REQUEST_CACHE_ADDED], 0);
+bool zathura_renderer_cache_memory_exceeded(ZathuraRenderer* renderer) {
+  g_return_val_if_fail(ZATHURA_IS_RENDERER(renderer), false);
+
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  return priv->page_cache.max_bytes != 0 &&
+         priv->page_cache.bytes + priv->page_cache.tile_bytes > priv->page_cache.max_bytes;
+}
+
+void zathura_renderer_page_cache_get_stats(ZathuraRenderer* renderer, zathura_page_cache_stats_t* stats) {
+  g_return_if_fail(ZATHURA_IS_RENDERER(renderer) && stats != NULL);
+
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  stats->pages                 = g_hash_table_size(priv->page_cache.entries);
+  stats->max_pages             = priv->page_cache.max_pages;
+  stats->bytes                 = priv->page_cache.bytes;
+  stats->tile_bytes            = priv->page_cache.tile_bytes;
+  stats->max_bytes             = priv->page_cache.max_bytes;
+  stats->hits                  = priv->page_cache.hits;
+  stats->misses                = priv->page_cache.misses;
+  stats->evictions             = priv->page_cache.evictions;
+}
+
+void zathura_renderer_get_render_stats(ZathuraRenderer* renderer, zathura_render_stats_t* stats) {
+  g_return_if_fail(ZATHURA_IS_RENDERER(renderer) && stats != NULL);
+
+  ZathuraRendererPrivate* priv = zathura_renderer_get_instance_private(renderer);
+  stats->executed              = atomic_load(&priv->jobs.executed);
+  stats->coalesced             = atomic_load(&priv->jobs.coalesced);
 }
 
 void zathura_render_request_set_render_plain(ZathuraRenderRequest* request, bool render_plain) {
@@ -1066,3 +1596,15 @@ bool zathura_render_request_get_render_plain(ZathuraRenderRequest* request) {
   ZathuraRenderRequestPrivate* priv = zathura_render_request_get_instance_private(request);
   return priv->render_plain;
 }
+
+void zathura_render_request_set_tile(ZathuraRenderRequest* request, unsigned int x, unsigned int y, unsigned int width,
+                                     unsigned int height) {
+  g_return_if_fail(ZATHURA_IS_RENDER_REQUEST(request));
+
+  ZathuraRenderRequestPrivate* priv = zathura_render_request_get_instance_private(request);
+  priv->tile.enabled                = true;
+  priv->tile.x                      = x;
+  priv->tile.y                      = y;
+  priv->tile.width                  = width;
+  priv->tile.height                 = height;
+}
@@ -34,9 +34,11 @@ struct zathura_renderer_class_s {
 GType zathura_renderer_get_type(void) G_GNUC_CONST;
 /**
  * Create a renderer.
+ * @param cache_size maximum number of pages in the page cache
+ * @param cache_memory maximum size of the cached pages in bytes, 0 for no limit
  * @return a renderer object
  */
-ZathuraRenderer* zathura_renderer_new(size_t cache_size);
+ZathuraRenderer* zathura_renderer_new(size_t cache_size, size_t cache_memory);
 
 /**
  * Return whether recoloring is enabled.
@@ -86,6 +88,13 @@ bool zathura_renderer_recolor_adjust_lightness_enabled(ZathuraRenderer* renderer
  * @param enable or disable adjusting lightness
  */
 void zathura_renderer_enable_recolor_adjust_lightness(ZathuraRenderer* renderer, bool enable);
+/**
+ * Enable/disable fingerprinting pages after they were rendered for the first
+ * time. The fingerprints are compared when the document is reloaded.
+ * @param renderer a renderer object
+ * @param enable whether to enable or disable fingerprints
+ */
+void zathura_renderer_enable_fingerprints(ZathuraRenderer* renderer, bool enable);
 /**
  * Set light and dark colors for recoloring.
  * @param renderer a renderer object
@@ -107,6 +116,14 @@ void zathura_renderer_set_recolor_colors_str(ZathuraRenderer* renderer, const ch
  * @param dark dark color
  */
 void zathura_renderer_get_recolor_colors(ZathuraRenderer* renderer, GdkRGBA* light, GdkRGBA* dark);
+/**
+ * Set the number of threads used for rendering. Pages of documents whose
+ * plugin does not support concurrent rendering are still rendered one at a
+ * time, but recoloring is done in parallel.
+ * @param renderer a renderer object
+ * @param threads number of render threads
+ */
+void zathura_renderer_set_render_threads(ZathuraRenderer* renderer, unsigned int threads);
 /**
  * Stop rendering.
  * @param renderer a render object
@@ -115,7 +132,8 @@ void zathura_renderer_stop(ZathuraRenderer* renderer);
 
 /**
  * Lock the render thread. This is useful if you want to render on your own (e.g
- * for printing).
+ * for printing). The lock is recursive, so pages may be initialized while it
+ * is held.
  *
  * @param renderer renderer object
  */
@@ -136,6 +154,76 @@ void zathura_renderer_unlock(ZathuraRenderer* renderer);
  */
 void zathura_renderer_page_cache_add(ZathuraRenderer* renderer, unsigned int page_index);
 
+/**
+ * Count a lookup of the page cache. A page that is drawn from a rendered
+ * surface is a hit, a page that has to be rendered before it can be drawn is
+ * a miss.
+ *
+ * @param renderer renderer object.
+ * @param hit true if the page was found in the cache
+ */
+void zathura_renderer_page_cache_count(ZathuraRenderer* renderer, bool hit);
+
+/**
+ * Account the memory of tiles, which are kept by the page widgets instead of
+ * the page cache. Tiles count towards the memory limit of the page cache, so
+ * cached pages are evicted to make room for them.
+ *
+ * @param renderer renderer object.
+ * @param added Size of the added tile surface in bytes
+ * @param removed Size of the removed tile surface in bytes
+ */
+void zathura_renderer_tile_cache_update_size(ZathuraRenderer* renderer, size_t added, size_t removed);
+
+/**
+ * Check whether the cached pages and tiles exceed the memory limit of the page
+ * cache.
+ *
+ * @param renderer renderer object.
+ * @return true if the limit is exceeded, false otherwise
+ */
+bool zathura_renderer_cache_memory_exceeded(ZathuraRenderer* renderer);
+
+/**
+ * Page cache statistics
+ */
+typedef struct zathura_page_cache_stats_s {
+  size_t pages;      /**< Number of cached pages */
+  size_t max_pages;  /**< Maximum number of cached pages */
+  size_t bytes;      /**< Size of the cached pages in bytes */
+  size_t tile_bytes; /**< Size of the tiles kept by page widgets in bytes */
+  size_t max_bytes;  /**< Maximum size of the cached pages and tiles in bytes, 0 for no limit */
+  size_t hits;       /**< Number of cache hits */
+  size_t misses;     /**< Number of cache misses */
+  size_t evictions;  /**< Number of evicted pages */
+} zathura_page_cache_stats_t;
+
+/**
+ * Get statistics of the page cache.
+ *
+ * @param renderer renderer object.
+ * @param stats The statistics are written to this object.
+ */
+void zathura_renderer_page_cache_get_stats(ZathuraRenderer* renderer, zathura_page_cache_stats_t* stats);
+
+/**
+ * Render job statistics
+ */
+typedef struct zathura_render_stats_s {
+  size_t executed;  /**< Number of executed render jobs */
+  size_t coalesced; /**< Number of render requests that were served by a queued or running job */
+} zathura_render_stats_t;
+
+/**
+ * Get statistics of the render jobs. Requests for a page that already has a
+ * queued job, or a running job rendering the current scale, rotation and
+ * recolor settings, are coalesced with that job.
+ *
+ * @param renderer renderer object.
+ * @param stats The statistics are written to this object.
+ */
+void zathura_renderer_get_render_stats(ZathuraRenderer* renderer, zathura_render_stats_t* stats);
+
 typedef struct zathura_render_request_class_s ZathuraRenderRequestClass;
 
 struct zathura_render_request_s {
@@ -177,6 +265,38 @@ ZathuraRenderRequest* zathura_render_request_new(ZathuraRenderer* renderer, zath
  */
 void zathura_render_request(ZathuraRenderRequest* request, gint64 last_view_time);
 
+/**
+ * Add a page to the render thread list that should be rendered. A low
+ * resolution preview of the page is rendered first and passed to the
+ * "completed" signal before the page is rendered in full resolution. The
+ * preview surface has the same size in user pixels as the full page.
+ *
+ * @param request request object of the page that should be renderer
+ * @param last_view_time last view time of the page
+ */
+void zathura_render_request_with_preview(ZathuraRenderRequest* request, gint64 last_view_time);
+
+/**
+ * Add a page that is not visible yet to the render thread list. It is rendered
+ * after all visible pages, and the last view time should be older than the
+ * one of the visible pages so that the page is evicted from the page cache
+ * before them.
+ *
+ * @param request request object of the page that should be renderer
+ * @param last_view_time last view time of the page
+ */
+void zathura_render_request_prefetch(ZathuraRenderRequest* request, gint64 last_view_time);
+
+/**
+ * Check whether a surface passed to the "completed" signal is a preview. The
+ * full resolution pass of a preview might be aborted, so the page has to be
+ * requested again while only the preview is shown.
+ *
+ * @param surface The rendered surface
+ * @return true if the surface is a low resolution preview
+ */
+bool zathura_render_surface_is_preview(cairo_surface_t* surface);
+
 /**
  * Abort an existing render request.
  *
@@ -184,6 +304,16 @@ void zathura_render_request(ZathuraRenderRequest* request, gint64 last_view_time
  */
 void zathura_render_request_abort(ZathuraRenderRequest* request);
 
+/**
+ * Pass a surface that was rendered before to the "completed" signal as if the
+ * request had rendered it, e.g. a page that did not change when the document
+ * was reloaded. The page is added to the page cache.
+ *
+ * @param request request of the page the surface shows
+ * @param surface the surface
+ */
+void zathura_render_request_reuse_surface(ZathuraRenderRequest* request, cairo_surface_t* surface);
+
 /**
  * Update the time the page associated to the render request has been viewed the
  * last time.
@@ -206,6 +336,21 @@ void zathura_render_request_set_render_plain(ZathuraRenderRequest* request, bool
  */
 bool zathura_render_request_get_render_plain(ZathuraRenderRequest* request);
 
+/**
+ * Restrict rendering to a tile of the page. The tile is given in user pixels
+ * at the current zoom level and is clipped to the page. The surface passed to
+ * the "completed" signal only covers the tile. Tile requests are not tracked
+ * by the page cache.
+ *
+ * @param request request that should be updated
+ * @param x x coordinate of the tile
+ * @param y y coordinate of the tile
+ * @param width width of the tile
+ * @param height height of the tile
+ */
+void zathura_render_request_set_tile(ZathuraRenderRequest* request, unsigned int x, unsigned int y, unsigned int width,
+                                     unsigned int height);
+
 /**
  * This function is used to unmark all pages as not rendered. This should
  * be used if all pages should be rendered again (e.g.: the zoom level or the
@@ -0,0 +1,258 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "search-results.h"
+
+#include <glib.h>
+#include <girara/datastructures.h>
+
+typedef struct search_results_page_s {
+  zathura_rectangle_t* rectangles; /**< Results of the page */
+  unsigned int length;             /**< Number of results */
+} search_results_page_t;
+
+typedef struct search_results_hit_s {
+  unsigned int page;   /**< Page with results */
+  unsigned int before; /**< Number of results on the pages before */
+} search_results_hit_t;
+
+struct zathura_search_results_s {
+  unsigned int number_of_pages; /**< Number of pages of the document */
+  search_results_page_t* pages; /**< Results per page */
+  GArray* hits;                 /**< Pages with results in ascending order */
+  bool hits_counted;            /**< The number of results before each hit page is up to date */
+  unsigned int total;           /**< Number of results */
+
+  struct {
+    bool valid;         /**< There is a current result */
+    unsigned int hit;   /**< Index of its page in hits */
+    unsigned int index; /**< Index of the result on its page */
+  } current;
+};
+
+/* returns the index of the first hit page not before page */
+static unsigned int search_results_lower_bound(zathura_search_results_t* results, unsigned int page) {
+  unsigned int low  = 0;
+  unsigned int high = results->hits->len;
+  while (low < high) {
+    const unsigned int mid = low + (high - low) / 2;
+    if (g_array_index(results->hits, search_results_hit_t, mid).page < page) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+static void search_results_count_hits(zathura_search_results_t* results) {
+  if (results->hits_counted == true) {
+    return;
+  }
+
+  unsigned int before = 0;
+  for (unsigned int idx = 0; idx < results->hits->len; ++idx) {
+    search_results_hit_t* hit = &g_array_index(results->hits, search_results_hit_t, idx);
+    hit->before               = before;
+    before += results->pages[hit->page].length;
+  }
+  results->hits_counted = true;
+}
+
+zathura_search_results_t* zathura_search_results_new(unsigned int number_of_pages) {
+  zathura_search_results_t* results = g_try_malloc0(sizeof(zathura_search_results_t));
+  if (results == NULL) {
+    return NULL;
+  }
+
+  results->number_of_pages = number_of_pages;
+  results->pages           = g_try_malloc0_n(number_of_pages + 1, sizeof(search_results_page_t));
+  if (results->pages == NULL) {
+    g_free(results);
+    return NULL;
+  }
+  results->hits         = g_array_new(FALSE, FALSE, sizeof(search_results_hit_t));
+  results->hits_counted = true;
+
+  return results;
+}
+
+void zathura_search_results_free(zathura_search_results_t* results) {
+  if (results == NULL) {
+    return;
+  }
+
+  zathura_search_results_clear(results);
+  g_array_free(results->hits, TRUE);
+  g_free(results->pages);
+  g_free(results);
+}
+
+void zathura_search_results_clear(zathura_search_results_t* results) {
+  g_return_if_fail(results != NULL);
+
+  for (unsigned int idx = 0; idx < results->hits->len; ++idx) {
+    search_results_page_t* page = &results->pages[g_array_index(results->hits, search_results_hit_t, idx).page];
+    g_clear_pointer(&page->rectangles, g_free);
+    page->length = 0;
+  }
+  g_array_set_size(results->hits, 0);
+  results->hits_counted  = true;
+  results->total         = 0;
+  results->current.valid = false;
+}
+
+void zathura_search_results_set_page(zathura_search_results_t* results, unsigned int page,
+                                     girara_list_t* rectangles) {
+  g_return_if_fail(results != NULL && page < results->number_of_pages);
+
+  search_results_page_t* entry = &results->pages[page];
+  const unsigned int length    = rectangles != NULL ? girara_list_size(rectangles) : 0;
+  const unsigned int position  = search_results_lower_bound(results, page);
+
+  if (entry->length != 0) {
+    if (results->current.valid == true && results->current.hit == position) {
+      results->current.valid = false;
+    }
+    results->total -= entry->length;
+    g_clear_pointer(&entry->rectangles, g_free);
+    entry->length = 0;
+
+    if (length == 0) {
+      g_array_remove_index(results->hits, position);
+      if (results->current.valid == true && results->current.hit > position) {
+        --results->current.hit;
+      }
+    }
+  } else if (length != 0) {
+    const search_results_hit_t hit = {.page = page, .before = 0};
+    g_array_insert_val(results->hits, position, hit);
+    if (results->current.valid == true && results->current.hit >= position) {
+      ++results->current.hit;
+    }
+  }
+
+  if (length != 0) {
+    entry->rectangles = g_new(zathura_rectangle_t, length);
+    for (unsigned int idx = 0; idx < length; ++idx) {
+      entry->rectangles[idx] = *(zathura_rectangle_t*)girara_list_nth(rectangles, idx);
+    }
+    entry->length = length;
+    results->total += length;
+  }
+
+  results->hits_counted = false;
+}
+
+const zathura_rectangle_t* zathura_search_results_get_page(zathura_search_results_t* results, unsigned int page,
+                                                           unsigned int* length) {
+  g_return_val_if_fail(results != NULL && length != NULL, NULL);
+
+  if (page >= results->number_of_pages) {
+    *length = 0;
+    return NULL;
+  }
+
+  *length = results->pages[page].length;
+  return results->pages[page].rectangles;
+}
+
+unsigned int zathura_search_results_get_total(zathura_search_results_t* results) {
+  g_return_val_if_fail(results != NULL, 0);
+
+  return results->total;
+}
+
+bool zathura_search_results_find_page(zathura_search_results_t* results, unsigned int page, bool forward,
+                                      unsigned int* result) {
+  g_return_val_if_fail(results != NULL && result != NULL, false);
+
+  const unsigned int count = results->hits->len;
+  if (count == 0) {
+    return false;
+  }
+
+  unsigned int position = search_results_lower_bound(results, page);
+  if (forward == true) {
+    position = position == count ? 0 : position;
+  } else if (position == count || g_array_index(results->hits, search_results_hit_t, position).page != page) {
+    position = position == 0 ? count - 1 : position - 1;
+  }
+
+  *result = g_array_index(results->hits, search_results_hit_t, position).page;
+  return true;
+}
+
+bool zathura_search_results_get_current(zathura_search_results_t* results, unsigned int* page,
+                                        unsigned int* index) {
+  g_return_val_if_fail(results != NULL, false);
+
+  if (results->current.valid == false) {
+    return false;
+  }
+
+  if (page != NULL) {
+    *page = g_array_index(results->hits, search_results_hit_t, results->current.hit).page;
+  }
+  if (index != NULL) {
+    *index = results->current.index;
+  }
+  return true;
+}
+
+unsigned int zathura_search_results_get_current_number(zathura_search_results_t* results) {
+  g_return_val_if_fail(results != NULL, 0);
+
+  if (results->current.valid == false) {
+    return 0;
+  }
+
+  search_results_count_hits(results);
+  return g_array_index(results->hits, search_results_hit_t, results->current.hit).before + results->current.index + 1;
+}
+
+bool zathura_search_results_set_current(zathura_search_results_t* results, unsigned int page, unsigned int index) {
+  g_return_val_if_fail(results != NULL, false);
+
+  if (page >= results->number_of_pages || index >= results->pages[page].length) {
+    return false;
+  }
+
+  results->current.valid = true;
+  results->current.hit   = search_results_lower_bound(results, page);
+  results->current.index = index;
+  return true;
+}
+
+void zathura_search_results_unset_current(zathura_search_results_t* results) {
+  g_return_if_fail(results != NULL);
+
+  results->current.valid = false;
+}
+
+bool zathura_search_results_move(zathura_search_results_t* results, bool forward) {
+  g_return_val_if_fail(results != NULL, false);
+
+  if (results->current.valid == false) {
+    return false;
+  }
+
+  const unsigned int count = results->hits->len;
+  if (forward == true) {
+    const unsigned int page = g_array_index(results->hits, search_results_hit_t, results->current.hit).page;
+    if (results->current.index + 1 < results->pages[page].length) {
+      ++results->current.index;
+    } else {
+      results->current.hit   = (results->current.hit + 1) % count;
+      results->current.index = 0;
+    }
+  } else if (results->current.index > 0) {
+    --results->current.index;
+  } else {
+    results->current.hit    = (results->current.hit + count - 1) % count;
+    const unsigned int page = g_array_index(results->hits, search_results_hit_t, results->current.hit).page;
+    results->current.index  = results->pages[page].length - 1;
+  }
+
+  return true;
+}
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef SEARCH_RESULTS_H
+#define SEARCH_RESULTS_H
+
+#include <stdbool.h>
+#include <girara/types.h>
+
+#include "types.h"
+
+typedef struct zathura_search_results_s zathura_search_results_t;
+
+/**
+ * Creates an empty store for the search results of a document. The results
+ * of every page are kept in one array of rectangles. The pages that have
+ * results are kept in order together with a cursor to the current result, so
+ * that moving to the next or previous result takes constant time.
+ *
+ * @param number_of_pages Number of pages of the document
+ * @return The search results or NULL if an error occurred
+ */
+zathura_search_results_t* zathura_search_results_new(unsigned int number_of_pages);
+
+/**
+ * Frees the search results
+ *
+ * @param results The search results
+ */
+void zathura_search_results_free(zathura_search_results_t* results);
+
+/**
+ * Removes all results and the current result
+ *
+ * @param results The search results
+ */
+void zathura_search_results_clear(zathura_search_results_t* results);
+
+/**
+ * Replaces the results of a page. The rectangles are copied, the list stays
+ * owned by the caller. If the current result was on the page, it is unset.
+ *
+ * @param results The search results
+ * @param page The page number
+ * @param rectangles List of zathura_rectangle_t or NULL to remove the results
+ *   of the page
+ */
+void zathura_search_results_set_page(zathura_search_results_t* results, unsigned int page,
+                                     girara_list_t* rectangles);
+
+/**
+ * Returns the results of a page
+ *
+ * @param results The search results
+ * @param page The page number
+ * @param length Is set to the number of results on the page
+ * @return The rectangles of the results or NULL if the page has none
+ */
+const zathura_rectangle_t* zathura_search_results_get_page(zathura_search_results_t* results, unsigned int page,
+                                                           unsigned int* length);
+
+/**
+ * Returns the number of results of all pages
+ *
+ * @param results The search results
+ * @return The number of results
+ */
+unsigned int zathura_search_results_get_total(zathura_search_results_t* results);
+
+/**
+ * Finds the closest page with results, starting at the given page
+ *
+ * @param results The search results
+ * @param page The page to start at
+ * @param forward Search for pages after the given page if true, for pages
+ *   before it otherwise; the search wraps around the end of the document
+ * @param result Is set to the page
+ * @return true if a page with results exists, false otherwise
+ */
+bool zathura_search_results_find_page(zathura_search_results_t* results, unsigned int page, bool forward,
+                                      unsigned int* result);
+
+/**
+ * Returns the current result
+ *
+ * @param results The search results
+ * @param page Is set to the page of the current result
+ * @param index Is set to the index of the current result on its page
+ * @return true if there is a current result, false otherwise
+ */
+bool zathura_search_results_get_current(zathura_search_results_t* results, unsigned int* page,
+                                        unsigned int* index);
+
+/**
+ * Returns the position of the current result among all results
+ *
+ * @param results The search results
+ * @return The position starting at 1, or 0 if there is no current result
+ */
+unsigned int zathura_search_results_get_current_number(zathura_search_results_t* results);
+
+/**
+ * Sets the current result
+ *
+ * @param results The search results
+ * @param page The page of the result
+ * @param index The index of the result on its page
+ * @return true if the result exists, false otherwise
+ */
+bool zathura_search_results_set_current(zathura_search_results_t* results, unsigned int page, unsigned int index);
+
+/**
+ * Unsets the current result
+ *
+ * @param results The search results
+ */
+void zathura_search_results_unset_current(zathura_search_results_t* results);
+
+/**
+ * Moves the current result to the next or previous result, wrapping around
+ * the end of the document
+ *
+ * @param results The search results
+ * @param forward Move to the next result if true, to the previous otherwise
+ * @return true if there is a current result, false otherwise
+ */
+bool zathura_search_results_move(zathura_search_results_t* results, bool forward);
+
+#endif // SEARCH_RESULTS_H
@@ -0,0 +1,350 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "search.h"
+
+#include <stdatomic.h>
+#include <string.h>
+#include <girara-gtk/session.h>
+#include <girara-gtk/statusbar.h>
+#include <girara/log.h>
+#include <glib/gi18n.h>
+
+#include "document.h"
+#include "internal.h"
+#include "page.h"
+#include "page-widget.h"
+#include "plugin.h"
+#include "render.h"
+#include "text-index.h"
+#include "utils.h"
+#include "zathura.h"
+
+typedef struct search_page_result_s {
+  unsigned int offset;    /**< Offset of the page from the first searched page */
+  girara_list_t* results; /**< Search results of the page or NULL */
+  bool searched;          /**< False if searching the page failed */
+} search_page_result_t;
+
+struct zathura_search_s {
+  zathura_t* zathura;           /**< Zathura session */
+  zathura_document_t* document; /**< Document that is searched */
+  ZathuraRenderer* renderer;    /**< Renderer to serialize plugin calls with */
+  bool concurrent;              /**< The plugin supports concurrent calls */
+  char* input;                  /**< Text to search for */
+  zathura_text_index_t* index;  /**< Text index to skip pages without matches or NULL */
+  char* normalized_input;       /**< Text to search for in the text index */
+  bool* candidates;             /**< Pages that can contain the text or NULL if all pages can */
+  int direction;                /**< Search direction */
+  bool disable_notify;          /**< Do not notify if the text was not found */
+  unsigned int number_of_pages; /**< Number of pages of the document */
+  unsigned int start;           /**< Page the search started at */
+
+  GThreadPool* pool;     /**< Worker threads */
+  atomic_bool cancelled; /**< Stop searching */
+  atomic_uint next;      /**< Offset of the next page to search */
+  GMutex mutex;          /**< Protects pending and publish_idle */
+  GArray* pending;       /**< Results that were not published yet */
+  guint publish_idle;    /**< Source of a pending publication or 0 */
+
+  /* only accessed from the main thread */
+  int* lengths;           /**< Number of results per offset or -1 if not yet published */
+  bool* searched;         /**< Offsets whose page was searched or cannot contain the text */
+  unsigned int published; /**< Number of published pages */
+  unsigned int frontier;  /**< Number of consecutive published pages from the start */
+  bool found;             /**< A result was found before the frontier */
+  bool jumped;            /**< The view was moved to the closest result */
+  bool finished;          /**< All pages were searched */
+};
+
+static unsigned int search_offset_to_index(zathura_search_t* search, unsigned int offset) {
+  const unsigned int n = search->number_of_pages;
+  if (search->direction == BACKWARD) {
+    return (search->start + n - offset % n) % n;
+  }
+
+  return (search->start + offset) % n;
+}
+
+static void search_update_statusbar(zathura_search_t* search) {
+  zathura_t* zathura   = search->zathura;
+  g_autofree char* tmp = g_strdup_printf(_("[Search %d/%d]"),
+                                         (int)zathura_search_results_get_current_number(zathura->global.search_results),
+                                         (int)zathura_search_results_get_total(zathura->global.search_results));
+  girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.search_count, tmp);
+}
+
+static void search_jump(zathura_search_t* search) {
+  girara_argument_t argument = {.n = FORWARD, .data = search->input};
+  search->jumped             = true;
+  search_document(search->zathura, &argument, search->disable_notify);
+}
+
+static void search_publish_result(zathura_search_t* search, search_page_result_t* result) {
+  zathura_t* zathura       = search->zathura;
+  const unsigned int index = search_offset_to_index(search, result->offset);
+  const int length         = result->results != NULL ? girara_list_size(result->results) : 0;
+
+  search->lengths[result->offset]  = length;
+  search->searched[result->offset] = result->searched;
+  ++search->published;
+
+  if (length != 0) {
+    /* pages without a widget draw their results once they get one */
+    zathura_search_results_set_page(zathura->global.search_results, index, result->results);
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, index);
+    if (page_widget != NULL) {
+      zathura_page_widget_update_search_results(ZATHURA_PAGE_WIDGET(page_widget));
+    }
+  }
+  girara_list_free(result->results);
+}
+
+static gboolean search_publish_idle(gpointer data) {
+  zathura_search_t* search = data;
+
+  g_mutex_lock(&search->mutex);
+  search->publish_idle = 0;
+  GArray* pending      = search->pending;
+  search->pending      = g_array_new(FALSE, FALSE, sizeof(search_page_result_t));
+  g_mutex_unlock(&search->mutex);
+
+  for (unsigned int idx = 0; idx < pending->len; ++idx) {
+    search_publish_result(search, &g_array_index(pending, search_page_result_t, idx));
+  }
+  g_array_free(pending, TRUE);
+
+  /* the closest result is known once all pages before it are searched */
+  while (search->frontier < search->number_of_pages && search->lengths[search->frontier] >= 0) {
+    search->found |= search->lengths[search->frontier] > 0;
+    ++search->frontier;
+  }
+
+  const bool unsupported = atomic_load(&search->cancelled) == true && search->finished == false;
+  if (search->published == search->number_of_pages || unsupported == true) {
+    search->finished = true;
+    girara_debug("search for '%s' finished: %u results", search->input,
+                 zathura_search_results_get_total(search->zathura->global.search_results));
+    if (search->index != NULL) {
+      zathura_text_index_save(search->index);
+    }
+  }
+
+  if (search->jumped == false && (search->found == true || search->finished == true)) {
+    /* also notifies if nothing was found */
+    search_jump(search);
+  } else if (search->jumped == true || zathura_search_results_get_total(search->zathura->global.search_results) > 0) {
+    search_update_statusbar(search);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void search_add_result(zathura_search_t* search, unsigned int offset, girara_list_t* results, bool searched) {
+  search_page_result_t result = {.offset = offset, .results = results, .searched = searched};
+
+  g_mutex_lock(&search->mutex);
+  g_array_append_val(search->pending, result);
+  if (search->publish_idle == 0) {
+    search->publish_idle = g_idle_add(search_publish_idle, search);
+  }
+  g_mutex_unlock(&search->mutex);
+}
+
+/* pages that do not contain the text according to the index are not searched by the plugin */
+static bool search_page_may_match(zathura_search_t* search, zathura_page_t* page) {
+  if (search->index == NULL) {
+    return true;
+  }
+
+  const unsigned int page_number = zathura_page_get_index(page);
+  const char* text               = zathura_text_index_get_page(search->index, page_number);
+  if (text == NULL) {
+    if (search->concurrent == false) {
+      zathura_renderer_lock(search->renderer);
+    }
+    zathura_error_t error      = zathura_page_initialize(page);
+    g_autofree char* page_text = NULL;
+    if (error == ZATHURA_ERROR_OK) {
+      zathura_rectangle_t rectangle = {0, 0, zathura_page_get_width(page), zathura_page_get_height(page)};
+      page_text                     = zathura_page_get_text(page, rectangle, &error);
+    }
+    if (search->concurrent == false) {
+      zathura_renderer_unlock(search->renderer);
+    }
+
+    if (page_text == NULL || error != ZATHURA_ERROR_OK) {
+      return true;
+    }
+
+    text = zathura_text_index_set_page(search->index, page_number, page_text);
+    if (text == NULL) {
+      return true;
+    }
+  }
+
+  return strstr(text, search->normalized_input) != NULL;
+}
+
+static void search_worker(gpointer UNUSED(data), gpointer user_data) {
+  zathura_search_t* search = user_data;
+
+  while (atomic_load(&search->cancelled) == false) {
+    const unsigned int offset = atomic_fetch_add(&search->next, 1);
+    if (offset >= search->number_of_pages) {
+      break;
+    }
+
+    const unsigned int index = search_offset_to_index(search, offset);
+    if (search->candidates != NULL && search->candidates[index] == false) {
+      search_add_result(search, offset, NULL, true);
+      continue;
+    }
+
+    zathura_page_t* page = zathura_document_get_page(search->document, index);
+    if (page == NULL || search_page_may_match(search, page) == false) {
+      search_add_result(search, offset, NULL, true);
+      continue;
+    }
+
+    /* plugins that are not thread-safe have to be serialized */
+    if (search->concurrent == false) {
+      zathura_renderer_lock(search->renderer);
+    }
+    zathura_error_t error  = ZATHURA_ERROR_OK;
+    girara_list_t* results = zathura_page_search_text(page, search->input, &error);
+    if (search->concurrent == false) {
+      zathura_renderer_unlock(search->renderer);
+    }
+
+    if (error == ZATHURA_ERROR_NOT_IMPLEMENTED) {
+      /* no page can be searched, report what was found so far */
+      atomic_store(&search->cancelled, true);
+    }
+    /* pages the plugin failed on are searched again by a narrowed search */
+    search_add_result(search, offset, results, results != NULL || error == ZATHURA_ERROR_OK);
+  }
+}
+
+zathura_search_t* zathura_search_new(zathura_t* zathura, const char* input, int direction, bool disable_notify,
+                                     zathura_search_t* previous) {
+  g_return_val_if_fail(zathura != NULL && zathura->document != NULL && zathura->sync.render_thread != NULL, NULL);
+  g_return_val_if_fail(input != NULL, NULL);
+
+  zathura_search_t* search = g_try_malloc0(sizeof(zathura_search_t));
+  if (search == NULL) {
+    return NULL;
+  }
+
+  search->zathura         = zathura;
+  search->document        = zathura->document;
+  search->renderer        = g_object_ref(zathura->sync.render_thread);
+  search->concurrent      = zathura_plugin_supports_concurrent_render(zathura_document_get_plugin(search->document));
+  search->input           = g_strdup(input);
+  search->index           = zathura->sync.text_index;
+  search->direction       = direction;
+  search->disable_notify  = disable_notify;
+  search->number_of_pages = zathura_document_get_number_of_pages(search->document);
+  search->start           = zathura_document_get_current_page_number(search->document);
+  search->pending         = g_array_new(FALSE, FALSE, sizeof(search_page_result_t));
+  search->lengths         = g_try_malloc_n(search->number_of_pages, sizeof(int));
+  search->searched        = g_try_malloc0_n(search->number_of_pages, sizeof(bool));
+  atomic_init(&search->cancelled, false);
+  atomic_init(&search->next, 0);
+  g_mutex_init(&search->mutex);
+
+  if ((search->lengths == NULL || search->searched == NULL) && search->number_of_pages != 0) {
+    zathura_search_free(search);
+    return NULL;
+  }
+  for (unsigned int idx = 0; idx < search->number_of_pages; ++idx) {
+    search->lengths[idx] = -1;
+  }
+
+  /* pages without a match for a part of the text cannot match the whole text */
+  if (previous != NULL && previous->document == search->document && strstr(input, previous->input) != NULL) {
+    search->candidates = g_try_malloc0_n(search->number_of_pages, sizeof(bool));
+  }
+  if (search->candidates != NULL) {
+    /* pages that were not searched before or where searching failed remain candidates */
+    for (unsigned int offset = 0; offset < search->number_of_pages; ++offset) {
+      search->candidates[search_offset_to_index(previous, offset)] =
+          previous->searched[offset] == false || previous->lengths[offset] != 0;
+    }
+  }
+
+  /* text that vanishes when normalized cannot be looked up in the index */
+  if (search->index != NULL) {
+    search->normalized_input = zathura_text_index_normalize(input);
+    if (search->normalized_input == NULL || search->normalized_input[0] == '\0') {
+      search->index = NULL;
+    }
+  }
+
+  /* clear the results of the previous search */
+  zathura_search_results_clear(zathura->global.search_results);
+  for (unsigned int page_id = 0; page_id < search->number_of_pages; ++page_id) {
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+    if (page_widget != NULL) {
+      g_object_set(G_OBJECT(page_widget), "draw-links", FALSE, NULL);
+      zathura_page_widget_update_search_results(ZATHURA_PAGE_WIDGET(page_widget));
+    }
+  }
+  girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.search_count, "");
+
+  /* plugins that are not thread-safe are searched page by page */
+  const unsigned int threads =
+      search->concurrent == true ? MIN(g_get_num_processors(), MAX(search->number_of_pages, 1)) : 1;
+
+  g_autoptr(GError) error = NULL;
+  search->pool            = g_thread_pool_new(search_worker, search, threads, TRUE, &error);
+  if (search->pool == NULL) {
+    girara_error("Failed to start search: %s", error->message);
+    zathura_search_free(search);
+    return NULL;
+  }
+
+  /* every worker takes pages until none are left */
+  for (unsigned int idx = 0; idx < threads; ++idx) {
+    g_thread_pool_push(search->pool, GUINT_TO_POINTER(idx + 1), NULL);
+  }
+
+  return search;
+}
+
+void zathura_search_cancel(zathura_search_t* search) {
+  if (search == NULL) {
+    return;
+  }
+
+  atomic_store(&search->cancelled, true);
+  if (search->pool != NULL) {
+    g_thread_pool_free(search->pool, TRUE, TRUE);
+    search->pool = NULL;
+  }
+
+  /* the workers are gone, so no new results can be added */
+  g_clear_handle_id(&search->publish_idle, g_source_remove);
+  for (unsigned int idx = 0; idx < search->pending->len; ++idx) {
+    girara_list_free(g_array_index(search->pending, search_page_result_t, idx).results);
+  }
+  g_array_set_size(search->pending, 0);
+  search->finished = true;
+}
+
+void zathura_search_free(zathura_search_t* search) {
+  if (search == NULL) {
+    return;
+  }
+
+  zathura_search_cancel(search);
+
+  g_array_free(search->pending, TRUE);
+  g_mutex_clear(&search->mutex);
+  g_clear_object(&search->renderer);
+  g_free(search->lengths);
+  g_free(search->searched);
+  g_free(search->candidates);
+  g_free(search->normalized_input);
+  g_free(search->input);
+  g_free(search);
+}
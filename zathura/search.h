@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h>
+
+#include "types.h"
+
+typedef struct zathura_search_s zathura_search_t;
+
+/**
+ * Starts to search the open document for the given text on worker threads.
+ * Pages are searched starting from the current page in the search direction.
+ * The results of each page are published to its page widget as they arrive
+ * and the search count in the statusbar is updated accordingly. Once the
+ * closest result is known, the view is moved to it.
+ *
+ * If the text of the previous search is part of the new text, only pages that
+ * contained matches for the previous text or that were not searched yet are
+ * searched again. The previous search needs to be cancelled before.
+ *
+ * @param zathura The zathura session
+ * @param input The text to search for
+ * @param direction The search direction (FORWARD or BACKWARD)
+ * @param disable_notify Do not notify if the text was not found
+ * @param previous The previous search or NULL
+ * @return The search or NULL if an error occurred
+ */
+zathura_search_t* zathura_search_new(zathura_t* zathura, const char* input, int direction, bool disable_notify,
+                                     zathura_search_t* previous);
+
+/**
+ * Cancels the search. Blocks until the worker threads have finished searching
+ * their current page. Results that were already published stay in place.
+ *
+ * @param search The search
+ */
+void zathura_search_cancel(zathura_search_t* search);
+
+/**
+ * Cancels the search and frees it
+ *
+ * @param search The search
+ */
+void zathura_search_free(zathura_search_t* search);
+
+#endif // SEARCH_H
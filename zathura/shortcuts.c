@@ -13,6 +13,7 @@
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 #include <math.h>
+#include <string.h>
 
 #include "adjustment.h"
 #include "callbacks.h"
@@ -35,16 +36,24 @@ static bool draw_links(zathura_t* zathura) {
   unsigned int page_offset           = 0;
   zathura_document_t* document       = zathura_get_document(zathura);
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
+  document_draw_search_results(zathura, false);
   for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
     zathura_page_t* page = zathura_document_get_page(document, page_id);
     if (page == NULL) {
       continue;
     }
 
-    GtkWidget* page_widget   = zathura_page_get_widget(zathura, page);
+    /* only visible pages need a widget to draw their links */
+    const bool visible     = zathura_page_get_visibility(page);
+    GtkWidget* page_widget = visible == true ? zathura_page_acquire_widget(zathura, page_id)
+                                             : zathura_page_get_widget_by_number(zathura, page_id);
+    if (page_widget == NULL) {
+      continue;
+    }
+
     GObject* obj_page_widget = G_OBJECT(page_widget);
-    g_object_set(obj_page_widget, "draw-search-results", FALSE, NULL);
-    if (zathura_page_get_visibility(page) == true) {
+
+    if (visible == true) {
       g_object_set(obj_page_widget, "draw-links", TRUE, NULL);
 
       int number_of_links = 0;
@@ -90,24 +99,28 @@ bool sc_abort(girara_session_t* session, girara_argument_t* UNUSED(argument), gi
   zathura_t* zathura           = session->global.data;
   zathura_document_t* document = zathura_get_document(zathura);
 
+  /* stop opening a document in the background */
+  document_open_cancel(zathura);
+
   bool clear_search = true;
   girara_setting_get(session, "abort-clear-search", &clear_search);
 
   if (document != NULL) {
+    /* stop a running search, the results found so far are kept */
+    zathura_search_cancel(zathura->sync.search);
+
     const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
     for (unsigned int page_id = 0; page_id < number_of_pages; ++page_id) {
-      zathura_page_t* page = zathura_document_get_page(document, page_id);
-      if (page == NULL) {
+      GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+      if (page_widget == NULL) {
         continue;
       }
 
-      GtkWidget* page_widget   = zathura_page_get_widget(zathura, page);
-      GObject* obj_page_widget = G_OBJECT(page_widget);
       zathura_page_widget_clear_selection(ZATHURA_PAGE_WIDGET(page_widget));
-      g_object_set(obj_page_widget, "draw-links", FALSE, NULL);
-      if (clear_search == true) {
-        g_object_set(obj_page_widget, "draw-search-results", FALSE, NULL);
-      }
+      g_object_set(G_OBJECT(page_widget), "draw-links", FALSE, NULL);
+    }
+    if (clear_search == true) {
+      document_draw_search_results(zathura, false);
     }
     girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.search_count, "");
   }
@@ -528,25 +541,7 @@ bool sc_reload(girara_session_t* session, girara_argument_t* UNUSED(argument), g
   g_return_val_if_fail(session->global.data != NULL, false);
   zathura_t* zathura = session->global.data;
 
-  if (zathura->file_monitor.monitor == NULL) {
-    return false;
-  }
-
-  /* Get file info (zoom, current page, etc.) */
-  zathura_fileinfo_t file_info;
-  if (zathura->document == NULL && zathura->predecessor_document != NULL) {
-    /* Try to get the info from the predecessor document if the current does not exist */
-    file_info = zathura_get_prefileinfo(zathura);
-  } else {
-    file_info = zathura_get_fileinfo(zathura);
-  }
-
-  /* close current document */
-  document_close(zathura, true);
-
-  /* reopen document with old file info */
-  document_open(zathura, zathura_filemonitor_get_filepath(zathura->file_monitor.monitor), NULL,
-                zathura->file_monitor.password, file_info.current_page, &file_info);
+  document_reload(zathura);
 
   return false;
 }
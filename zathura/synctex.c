@@ -13,6 +13,7 @@
 #include "page.h"
 #include "document.h"
 #include "document-widget.h"
+#include "page-widget.h"
 #include "utils.h"
 #include "adjustment.h"
 
@@ -248,19 +249,25 @@ void synctex_highlight_rects(zathura_t* zathura, unsigned int page, girara_list_
   zathura_document_t* document       = zathura_get_document(zathura);
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
 
-  for (unsigned int p = 0; p != number_of_pages; ++p) {
-    GObject* widget = G_OBJECT(zathura_page_get_widget_by_number(zathura, p));
+  /* the rectangles replace the results of a running search */
+  zathura_search_cancel(zathura->sync.search);
+  zathura_search_results_clear(zathura->global.search_results);
 
-    g_object_set(widget, "draw-links", FALSE, "search-results", rectangles[p], NULL);
-    if (p == page) {
-      g_object_set(widget, "search-current", 0, NULL);
+  for (unsigned int p = 0; p != number_of_pages; ++p) {
+    zathura_search_results_set_page(zathura->global.search_results, p, rectangles[p]);
+    girara_list_free(rectangles[p]);
+    rectangles[p] = NULL;
+
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, p);
+    if (page_widget != NULL) {
+      g_object_set(G_OBJECT(page_widget), "draw-links", FALSE, NULL);
+      zathura_page_widget_update_search_results(ZATHURA_PAGE_WIDGET(page_widget));
     }
   }
 
   document_draw_search_results(zathura, true);
 
-  girara_list_t* rect_list = rectangles[page];
-  if (rect_list == NULL || girara_list_size(rect_list) == 0) {
+  if (zathura_search_results_set_current(zathura->global.search_results, page, 0) == false) {
     girara_debug("No rectangles for the given page. Jumping to page %u.", page);
     page_set(zathura, page);
     return;
@@ -287,15 +294,10 @@ void synctex_highlight_rects(zathura_t* zathura, unsigned int page, girara_list_
                                             &doc_width);
 
   /* Need to adjust rectangle to page scale and orientation */
-  zathura_page_t* doc_page  = zathura_document_get_page(document, page);
-  zathura_rectangle_t* rect = girara_list_nth(rect_list, 0);
-  if (rect == NULL) {
-    girara_debug("List of rectangles is broken. Jumping to page %u.", page);
-    page_set(zathura, page);
-    return;
-  }
-
-  zathura_rectangle_t rectangle = recalc_rectangle(doc_page, *rect);
+  zathura_page_t* doc_page           = zathura_document_get_page(document, page);
+  unsigned int length                = 0;
+  const zathura_rectangle_t* results = zathura_search_results_get_page(zathura->global.search_results, page, &length);
+  zathura_rectangle_t rectangle      = recalc_rectangle(doc_page, results[0]);
 
   /* compute the center of the rectangle, which will be aligned to the center
      of the viewport */
@@ -0,0 +1,291 @@
+/* SPDX-License-Identifier: Zlib */
+
+#include "text-index.h"
+
+#include <string.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <girara/log.h>
+
+#define TEXT_INDEX_MAGIC "ZTIX"
+#define TEXT_INDEX_VERSION 1
+#define TEXT_INDEX_DIGEST_SIZE 32
+/* length of a page that was not indexed */
+#define TEXT_INDEX_NOT_INDEXED UINT32_MAX
+
+struct zathura_text_index_s {
+  char* path;                   /**< File the index is saved to or NULL */
+  unsigned int number_of_pages; /**< Number of pages of the document */
+  char** pages;                 /**< Normalized text per page, every entry is set at most once */
+  gint dirty;                   /**< Pages were added since the index was loaded or saved */
+  size_t cache_size;            /**< Maximum size of all saved indexes in bytes, 0 for no limit */
+};
+
+/* saved index in the cache directory */
+typedef struct text_index_file_s {
+  char* path;   /**< Path of the file */
+  goffset size; /**< Size of the file in bytes */
+  gint64 mtime; /**< Time the index was saved */
+} text_index_file_t;
+
+static char* text_index_path(const char* cache_dir, const uint8_t* hash_sha256) {
+  char hex[2 * TEXT_INDEX_DIGEST_SIZE + 1];
+  for (unsigned int idx = 0; idx < TEXT_INDEX_DIGEST_SIZE; ++idx) {
+    g_snprintf(hex + 2 * idx, 3, "%02x", hash_sha256[idx]);
+  }
+
+  return g_build_filename(cache_dir, "text-index", hex, NULL);
+}
+
+static bool read_uint32(const char* data, gsize length, gsize* offset, uint32_t* value) {
+  if (length - *offset < sizeof(uint32_t)) {
+    return false;
+  }
+
+  memcpy(value, data + *offset, sizeof(uint32_t));
+  *offset += sizeof(uint32_t);
+  return true;
+}
+
+static bool text_index_parse(zathura_text_index_t* index, const char* data, gsize length) {
+  gsize offset = strlen(TEXT_INDEX_MAGIC);
+  if (length < offset || memcmp(data, TEXT_INDEX_MAGIC, offset) != 0) {
+    return false;
+  }
+
+  uint32_t version         = 0;
+  uint32_t number_of_pages = 0;
+  if (read_uint32(data, length, &offset, &version) == false || version != TEXT_INDEX_VERSION ||
+      read_uint32(data, length, &offset, &number_of_pages) == false || number_of_pages != index->number_of_pages) {
+    return false;
+  }
+
+  for (unsigned int page = 0; page < index->number_of_pages; ++page) {
+    uint32_t page_length = 0;
+    if (read_uint32(data, length, &offset, &page_length) == false) {
+      return false;
+    }
+    if (page_length == TEXT_INDEX_NOT_INDEXED) {
+      continue;
+    }
+    if (length - offset < page_length) {
+      return false;
+    }
+
+    index->pages[page] = g_strndup(data + offset, page_length);
+    offset += page_length;
+  }
+
+  return offset == length;
+}
+
+static void text_index_load(zathura_text_index_t* index) {
+  g_autofree char* data = NULL;
+  gsize length          = 0;
+  if (g_file_get_contents(index->path, &data, &length, NULL) == FALSE) {
+    return;
+  }
+
+  if (text_index_parse(index, data, length) == false) {
+    girara_debug("Ignoring invalid text index '%s'", index->path);
+    for (unsigned int page = 0; page < index->number_of_pages; ++page) {
+      g_clear_pointer(&index->pages[page], g_free);
+    }
+  }
+}
+
+zathura_text_index_t* zathura_text_index_new(const char* cache_dir, const uint8_t* hash_sha256,
+                                             unsigned int number_of_pages, size_t cache_size) {
+  zathura_text_index_t* index = g_try_malloc0(sizeof(zathura_text_index_t));
+  if (index == NULL) {
+    return NULL;
+  }
+
+  index->number_of_pages = number_of_pages;
+  index->cache_size      = cache_size;
+  index->pages           = g_try_malloc0_n(number_of_pages + 1, sizeof(char*));
+  if (index->pages == NULL) {
+    g_free(index);
+    return NULL;
+  }
+
+  if (cache_dir != NULL && hash_sha256 != NULL) {
+    index->path = text_index_path(cache_dir, hash_sha256);
+    text_index_load(index);
+  }
+
+  return index;
+}
+
+void zathura_text_index_free(zathura_text_index_t* index) {
+  if (index == NULL) {
+    return;
+  }
+
+  for (unsigned int page = 0; page < index->number_of_pages; ++page) {
+    g_free(index->pages[page]);
+  }
+  g_free(index->pages);
+  g_free(index->path);
+  g_free(index);
+}
+
+static void text_index_file_free(void* data) {
+  text_index_file_t* file = data;
+  g_free(file->path);
+  g_free(file);
+}
+
+static gint text_index_file_compare(gconstpointer a, gconstpointer b) {
+  const text_index_file_t* file_a = *(text_index_file_t* const*)a;
+  const text_index_file_t* file_b = *(text_index_file_t* const*)b;
+  return file_a->mtime < file_b->mtime ? -1 : (file_a->mtime > file_b->mtime ? 1 : 0);
+}
+
+/* removes the least recently saved indexes until the saved indexes fit into
+ * the cache size again, the index that was just saved is kept */
+static void text_index_prune(const char* dir, const char* keep, size_t cache_size) {
+  GDir* handle = g_dir_open(dir, 0, NULL);
+  if (handle == NULL) {
+    return;
+  }
+
+  g_autoptr(GPtrArray) files = g_ptr_array_new_with_free_func(text_index_file_free);
+  goffset total              = 0;
+  const char* name           = NULL;
+  while ((name = g_dir_read_name(handle)) != NULL) {
+    g_autofree char* path = g_build_filename(dir, name, NULL);
+    GStatBuf buf;
+    if (g_stat(path, &buf) != 0 || S_ISREG(buf.st_mode) == 0) {
+      continue;
+    }
+
+    text_index_file_t* file = g_new0(text_index_file_t, 1);
+    file->path              = g_steal_pointer(&path);
+    file->size              = buf.st_size;
+    file->mtime             = buf.st_mtime;
+    total += file->size;
+    g_ptr_array_add(files, file);
+  }
+  g_dir_close(handle);
+
+  g_ptr_array_sort(files, text_index_file_compare);
+  for (guint idx = 0; idx < files->len && total > (goffset)cache_size; ++idx) {
+    const text_index_file_t* file = g_ptr_array_index(files, idx);
+    if (g_strcmp0(file->path, keep) != 0 && g_remove(file->path) == 0) {
+      girara_debug("Removed text index '%s' to stay within the cache size", file->path);
+      total -= file->size;
+    }
+  }
+}
+
+bool zathura_text_index_save(zathura_text_index_t* index) {
+  g_return_val_if_fail(index != NULL, false);
+
+  if (index->path == NULL || g_atomic_int_compare_and_exchange(&index->dirty, TRUE, FALSE) == FALSE) {
+    return true;
+  }
+
+  g_autoptr(GByteArray) data = g_byte_array_new();
+  const uint32_t version     = TEXT_INDEX_VERSION;
+  const uint32_t count       = index->number_of_pages;
+  g_byte_array_append(data, (const guint8*)TEXT_INDEX_MAGIC, strlen(TEXT_INDEX_MAGIC));
+  g_byte_array_append(data, (const guint8*)&version, sizeof(version));
+  g_byte_array_append(data, (const guint8*)&count, sizeof(count));
+
+  for (unsigned int page = 0; page < index->number_of_pages; ++page) {
+    const char* text      = g_atomic_pointer_get(&index->pages[page]);
+    const uint32_t length = text != NULL ? strlen(text) : TEXT_INDEX_NOT_INDEXED;
+    g_byte_array_append(data, (const guint8*)&length, sizeof(length));
+    if (text != NULL) {
+      g_byte_array_append(data, (const guint8*)text, length);
+    }
+  }
+
+  /* an index that does not fit into the cache on its own is not saved at all */
+  if (index->cache_size != 0 && data->len > index->cache_size) {
+    girara_debug("Not saving text index '%s', it exceeds the cache size", index->path);
+    return true;
+  }
+
+  g_autofree char* dir = g_path_get_dirname(index->path);
+  if (g_mkdir_with_parents(dir, 0700) == -1) {
+    girara_error("Could not create '%s'", dir);
+    g_atomic_int_set(&index->dirty, TRUE);
+    return false;
+  }
+
+  g_autoptr(GError) error = NULL;
+  if (g_file_set_contents(index->path, (const char*)data->data, data->len, &error) == FALSE) {
+    girara_error("Could not save text index: %s", error->message);
+    g_atomic_int_set(&index->dirty, TRUE);
+    return false;
+  }
+
+  if (index->cache_size != 0) {
+    text_index_prune(dir, index->path, index->cache_size);
+  }
+
+  return true;
+}
+
+void zathura_text_index_remove(const char* cache_dir, const uint8_t* hash_sha256) {
+  g_return_if_fail(cache_dir != NULL && hash_sha256 != NULL);
+
+  g_autofree char* path = text_index_path(cache_dir, hash_sha256);
+  if (g_remove(path) == 0) {
+    girara_debug("Removed text index '%s'", path);
+  }
+}
+
+const char* zathura_text_index_get_page(zathura_text_index_t* index, unsigned int page_number) {
+  g_return_val_if_fail(index != NULL && page_number < index->number_of_pages, NULL);
+
+  return g_atomic_pointer_get(&index->pages[page_number]);
+}
+
+const char* zathura_text_index_set_page(zathura_text_index_t* index, unsigned int page_number, const char* text) {
+  g_return_val_if_fail(index != NULL && page_number < index->number_of_pages, NULL);
+
+  char* normalized = zathura_text_index_normalize(text);
+  if (normalized == NULL) {
+    return NULL;
+  }
+
+  /* another thread might have indexed the page in the meantime */
+  if (g_atomic_pointer_compare_and_exchange(&index->pages[page_number], NULL, normalized) == FALSE) {
+    g_free(normalized);
+    return g_atomic_pointer_get(&index->pages[page_number]);
+  }
+
+  g_atomic_int_set(&index->dirty, TRUE);
+  return normalized;
+}
+
+char* zathura_text_index_normalize(const char* text) {
+  if (text == NULL || g_utf8_validate(text, -1, NULL) == FALSE) {
+    return NULL;
+  }
+
+  g_autofree char* folded     = g_utf8_casefold(text, -1);
+  g_autofree char* normalized = g_utf8_normalize(folded, -1, G_NORMALIZE_ALL);
+  if (normalized == NULL) {
+    return NULL;
+  }
+
+  /* plugins may match across line breaks and hyphenations or ignore
+   * diacritics, so none of them may decide whether a page can contain a match */
+  GString* result = g_string_sized_new(strlen(normalized));
+  for (const char* iter = normalized; *iter != '\0'; iter = g_utf8_next_char(iter)) {
+    const gunichar c        = g_utf8_get_char(iter);
+    const GUnicodeType type = g_unichar_type(c);
+    if (g_unichar_isspace(c) == TRUE || type == G_UNICODE_DASH_PUNCTUATION || type == G_UNICODE_FORMAT ||
+        type == G_UNICODE_NON_SPACING_MARK) {
+      continue;
+    }
+    g_string_append_unichar(result, c);
+  }
+
+  return g_string_free(result, FALSE);
+}
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: Zlib */
+
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct zathura_text_index_s zathura_text_index_t;
+
+/**
+ * Creates the text index of a document. If an index for the document was
+ * saved before, it is loaded from the cache directory. The index contains the
+ * text of the document, so it should only be persisted if the user asked for
+ * it and never for password protected documents.
+ *
+ * The index stores the normalized text of every page. It only serves as a
+ * filter: pages whose text does not contain the normalized search text do
+ * not need to be searched by the plugin.
+ *
+ * @param cache_dir The cache directory or NULL if the index should not be
+ *   persisted
+ * @param hash_sha256 SHA256 hash of the document
+ * @param number_of_pages Number of pages of the document
+ * @param cache_size Maximum size in bytes of all indexes in the cache
+ *   directory or 0 for no limit
+ * @return The text index or NULL if an error occurred
+ */
+zathura_text_index_t* zathura_text_index_new(const char* cache_dir, const uint8_t* hash_sha256,
+                                             unsigned int number_of_pages, size_t cache_size);
+
+/**
+ * Frees the text index without saving it
+ *
+ * @param index The text index
+ */
+void zathura_text_index_free(zathura_text_index_t* index);
+
+/**
+ * Saves the text index to the cache directory if pages were added since it
+ * was loaded or saved. The least recently saved indexes are removed if the
+ * cache exceeds its size, and an index that exceeds it on its own is not saved.
+ *
+ * @param index The text index
+ * @return true if no error occurred, false otherwise
+ */
+bool zathura_text_index_save(zathura_text_index_t* index);
+
+/**
+ * Removes the saved text index of a document from the cache directory
+ *
+ * @param cache_dir The cache directory
+ * @param hash_sha256 SHA256 hash of the document
+ */
+void zathura_text_index_remove(const char* cache_dir, const uint8_t* hash_sha256);
+
+/**
+ * Returns the normalized text of a page. This function is thread-safe.
+ *
+ * @param index The text index
+ * @param page_number The page number
+ * @return The normalized text or NULL if the page was not indexed yet
+ */
+const char* zathura_text_index_get_page(zathura_text_index_t* index, unsigned int page_number);
+
+/**
+ * Adds the text of a page to the index. Pages that were already indexed are
+ * left untouched. This function is thread-safe.
+ *
+ * @param index The text index
+ * @param page_number The page number
+ * @param text The text of the page as returned by the plugin
+ * @return The normalized text of the page or NULL if it could not be
+ *   normalized
+ */
+const char* zathura_text_index_set_page(zathura_text_index_t* index, unsigned int page_number, const char* text);
+
+/**
+ * Normalizes text for the index: the text is case folded, compatibility
+ * characters are decomposed, and whitespace, dashes and diacritics are
+ * removed, so that line breaks in the extracted text do not hide matches.
+ *
+ * @param text The text
+ * @return The normalized text (needs to be deallocated with g_free) or NULL
+ *   if the text is not valid UTF-8
+ */
+char* zathura_text_index_normalize(const char* text);
+
+#endif // TEXT_INDEX_H
@@ -16,6 +16,7 @@
 #include <girara/utils.h>
 
 #include "adjustment.h"
+#include "callbacks.h"
 #include "links.h"
 #include "zathura.h"
 #include "internal.h"
@@ -24,6 +25,7 @@
 #include "page.h"
 #include "plugin.h"
 #include "content-type.h"
+#include "render.h"
 
 double zathura_correct_zoom_value(girara_session_t* session, const double zoom) {
   if (session == NULL) {
@@ -76,7 +78,7 @@ void document_index_build(girara_session_t* session, GtkTreeModel* model, GtkTre
     if (type == ZATHURA_LINK_GOTO_DEST) {
       zathura_t* zathura   = session->global.data;
       zathura_page_t* page = zathura_document_get_page(zathura_get_document(zathura), target.page_number);
-      const char* label    = zathura_page_get_label(page, NULL);
+      const char* label = zathura_page_get_label(page, NULL);
 
       if (label != NULL) {
         description  = g_strdup_printf("Page %s", label);
@@ -265,14 +267,36 @@ zathura_rectangle_t recalc_rectangle(zathura_page_t* page, zathura_rectangle_t r
   return tmp;
 }
 
+static GtkWidget* page_widget_create(zathura_t* zathura, zathura_page_t* page) {
+  GtkWidget* page_widget = zathura_page_widget_new(zathura, page);
+  if (page_widget == NULL) {
+    return NULL;
+  }
+
+  g_object_ref(page_widget);
+
+  gtk_widget_set_halign(page_widget, GTK_ALIGN_CENTER);
+  gtk_widget_set_valign(page_widget, GTK_ALIGN_CENTER);
+
+  g_signal_connect(G_OBJECT(page_widget), "text-selected", G_CALLBACK(cb_page_widget_text_selected), zathura);
+  g_signal_connect(G_OBJECT(page_widget), "image-selected", G_CALLBACK(cb_page_widget_image_selected), zathura);
+  g_signal_connect(G_OBJECT(page_widget), "enter-link", G_CALLBACK(cb_page_widget_link), (gpointer) true);
+  g_signal_connect(G_OBJECT(page_widget), "leave-link", G_CALLBACK(cb_page_widget_link), (gpointer) false);
+  g_signal_connect(G_OBJECT(page_widget), "scaled-button-release", G_CALLBACK(cb_page_widget_scaled_button_release),
+                   zathura);
+
+  gtk_container_add(GTK_CONTAINER(zathura->ui.document_widget), page_widget);
+  gtk_widget_show(page_widget);
+
+  return page_widget;
+}
+
 GtkWidget* zathura_page_get_widget(zathura_t* zathura, zathura_page_t* page) {
   if (zathura == NULL || page == NULL || zathura->pages == NULL) {
     return NULL;
   }
 
-  unsigned int page_number = zathura_page_get_index(page);
-
-  return zathura->pages[page_number];
+  return zathura_page_get_widget_by_number(zathura, zathura_page_get_index(page));
 }
 
 GtkWidget* zathura_page_get_widget_by_number(zathura_t* zathura, unsigned int page_number) {
@@ -284,16 +308,72 @@ GtkWidget* zathura_page_get_widget_by_number(zathura_t* zathura, unsigned int pa
   return zathura->pages[page_number];
 }
 
+GtkWidget* zathura_page_acquire_widget(zathura_t* zathura, unsigned int page_number) {
+  if (zathura == NULL || !zathura_has_document(zathura) || zathura->pages == NULL) {
+    return NULL;
+  }
+
+  GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_number);
+  if (page_widget != NULL) {
+    return page_widget;
+  }
+
+  zathura_document_t* document = zathura_get_document(zathura);
+  zathura_page_t* page         = zathura_document_get_page(document, page_number);
+  if (page == NULL) {
+    return NULL;
+  }
+
+  /* widgets released by other pages are bound again before new ones are created */
+  page_widget = zathura_document_widget_take_pooled_page(ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget));
+  if (page_widget != NULL) {
+    zathura_page_widget_set_page(ZATHURA_PAGE_WIDGET(page_widget), page);
+  } else {
+    page_widget = page_widget_create(zathura, page);
+    if (page_widget == NULL) {
+      return NULL;
+    }
+  }
+  zathura->pages[page_number] = page_widget;
+
+  g_object_set(G_OBJECT(page_widget), "draw-search-results", zathura->global.draw_search_results ? TRUE : FALSE,
+               "draw-signatures", zathura->global.draw_signatures ? TRUE : FALSE, NULL);
+
+  unsigned int page_height = 0;
+  unsigned int page_width  = 0;
+  page_calc_height_width(document, page, &page_height, &page_width, true);
+  zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(page_widget), page_width, page_height);
+
+  return page_widget;
+}
+
+bool zathura_page_release_widget(zathura_t* zathura, unsigned int page_number) {
+  GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_number);
+  if (page_widget == NULL || zathura_page_widget_can_release(ZATHURA_PAGE_WIDGET(page_widget)) == false) {
+    return false;
+  }
+
+  zathura->pages[page_number] = NULL;
+  zathura_page_widget_abort_render_request(ZATHURA_PAGE_WIDGET(page_widget));
+  zathura_document_widget_pool_page(ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget), page_widget);
+
+  return true;
+}
+
 void document_draw_search_results(zathura_t* zathura, bool value) {
   if (zathura_has_document(zathura) == false || zathura->pages == NULL) {
     return;
   }
 
+  /* pages without a widget have no search results to draw */
   unsigned int number_of_pages = zathura_document_get_number_of_pages(zathura_get_document(zathura));
   for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
-    g_object_set(G_OBJECT(zathura_page_get_widget_by_number(zathura, page_id)), "draw-search-results",
-                 (value == true) ? TRUE : FALSE, NULL);
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page_id);
+    if (page_widget != NULL) {
+      g_object_set(G_OBJECT(page_widget), "draw-search-results", (value == true) ? TRUE : FALSE, NULL);
+    }
   }
+  zathura->global.draw_search_results = value;
 }
 
 char* zathura_get_version_string(const zathura_plugin_manager_t* plugin_manager, bool markup) {
@@ -467,26 +547,6 @@ bool parse_color(GdkRGBA* color, const char* str) {
   return true;
 }
 
-typedef struct zathura_point_s {
-  uintptr_t x;
-  uintptr_t y;
-} zathura_point_t;
-
-static int cmp_point(const void* va, const void* vb) {
-  const zathura_point_t* a = va;
-  const zathura_point_t* b = vb;
-
-  if (a->x == b->x) {
-    if (a->y == b->y) {
-      return 0;
-    }
-
-    return a->y < b->y ? -1 : 1;
-  }
-
-  return a->x < b->x ? -1 : 1;
-}
-
 static inline uintptr_t ufloor(double f) {
   return floor(f);
 }
@@ -495,104 +555,129 @@ static inline uintptr_t uceil(double f) {
   return ceil(f);
 }
 
-static int cmp_uint(const void* vx, const void* vy) {
-  const uintptr_t x = (uintptr_t)vx;
-  const uintptr_t y = (uintptr_t)vy;
+static int cmp_uint(const void* va, const void* vb) {
+  const uintptr_t a = *(const uintptr_t*)va;
+  const uintptr_t b = *(const uintptr_t*)vb;
 
-  return x == y ? 0 : (x > y ? 1 : -1);
+  return a == b ? 0 : (a > b ? 1 : -1);
 }
 
-static int cmp_rectangle(const void* vr1, const void* vr2) {
-  const zathura_rectangle_t* r1 = vr1;
-  const zathura_rectangle_t* r2 = vr2;
-
-  // we only care about equlity here, no ordering
-  return (ufloor(r1->x1) == ufloor(r2->x1) && uceil(r1->x2) == uceil(r2->x2) && ufloor(r1->y1) == ufloor(r2->y1) &&
-          uceil(r1->y2) == uceil(r2->y2))
-             ? 0
-             : -1;
-}
+// sort coordinates and remove duplicates, returns the number of unique coordinates
+static size_t sort_unique(uintptr_t* values, size_t n) {
+  qsort(values, n, sizeof(uintptr_t), cmp_uint);
 
-static bool girara_list_append_unique(girara_list_t* l, girara_compare_function_t cmp, void* item) {
-  if (girara_list_find(l, cmp, item) != NULL) {
-    return false;
+  size_t length = 0;
+  for (size_t idx = 0; idx != n; ++idx) {
+    if (length == 0 || values[length - 1] != values[idx]) {
+      values[length++] = values[idx];
+    }
   }
-
-  girara_list_append(l, item);
-  return true;
+  return length;
 }
 
-static void append_unique_point(girara_list_t* list, const uintptr_t x, const uintptr_t y) {
-  zathura_point_t* p = g_try_malloc(sizeof(zathura_point_t));
-  if (p == NULL) {
-    return;
+// index of the first coordinate greater than value
+static size_t upper_bound(const uintptr_t* values, size_t n, uintptr_t value) {
+  size_t low  = 0;
+  size_t high = n;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (values[mid] <= value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
   }
+  return low;
+}
 
-  p->x = x;
-  p->y = y;
+// cells only have integer coordinates, so they can be hashed and compared exactly
+static guint hash_rectangle(gconstpointer vr) {
+  const zathura_rectangle_t* r = vr;
 
-  if (girara_list_append_unique(list, cmp_point, p) == false) {
-    g_free(p);
-  }
+  guint hash = 17;
+  hash       = hash * 31 + (guint)r->x1;
+  hash       = hash * 31 + (guint)r->y1;
+  hash       = hash * 31 + (guint)r->x2;
+  hash       = hash * 31 + (guint)r->y2;
+  return hash;
 }
 
-static void rectangle_to_points(void* vrect, void* vlist) {
-  const zathura_rectangle_t* rect = vrect;
-  girara_list_t* list             = vlist;
+static gboolean equal_rectangle(gconstpointer vr1, gconstpointer vr2) {
+  const zathura_rectangle_t* r1 = vr1;
+  const zathura_rectangle_t* r2 = vr2;
 
-  append_unique_point(list, ufloor(rect->x1), ufloor(rect->y1));
-  append_unique_point(list, ufloor(rect->x1), uceil(rect->y2));
-  append_unique_point(list, uceil(rect->x2), ufloor(rect->y1));
-  append_unique_point(list, uceil(rect->x2), uceil(rect->y2));
+  return r1->x1 == r2->x1 && r1->y1 == r2->y1 && r1->x2 == r2->x2 && r1->y2 == r2->y2;
 }
 
-static void append_unique_uint(girara_list_t* list, const uintptr_t v) {
-  girara_list_append_unique(list, cmp_uint, (void*)v);
-}
+static void append_unique_cell(GHashTable* cells, girara_list_t* rectangles, zathura_rectangle_t cell) {
+  if (g_hash_table_contains(cells, &cell) == TRUE) {
+    return;
+  }
 
-// transform a rectangle into multiple new ones according a grid of points
-static void cut_rectangle(const zathura_rectangle_t* rect, girara_list_t* points, girara_list_t* rectangles) {
-  // Lists of ordred relevant points
-  g_autoptr(girara_list_t) xs = girara_sorted_list_new(cmp_uint);
-  g_autoptr(girara_list_t) ys = girara_sorted_list_new(cmp_uint);
+  zathura_rectangle_t* r = g_try_malloc(sizeof(zathura_rectangle_t));
+  if (r == NULL) {
+    return;
+  }
 
-  append_unique_uint(xs, uceil(rect->x2));
-  append_unique_uint(ys, uceil(rect->y2));
+  *r = cell;
+  g_hash_table_add(cells, r);
+  girara_list_append(rectangles, r);
+}
 
-  for (size_t idx = 0; idx != girara_list_size(points); ++idx) {
-    const zathura_point_t* pt = girara_list_nth(points, idx);
-    if (pt->x > ufloor(rect->x1) && pt->x < uceil(rect->x2)) {
-      append_unique_uint(xs, pt->x);
-    }
-    if (pt->y > ufloor(rect->y1) && pt->y < uceil(rect->y2)) {
-      append_unique_uint(ys, pt->y);
-    }
-  }
+// transform a rectangle into multiple new ones according to the grid of all rectangle borders
+static void cut_rectangle(const zathura_rectangle_t* rect, const uintptr_t* xs, size_t nx, const uintptr_t* ys,
+                          size_t ny, GHashTable* cells, girara_list_t* rectangles) {
+  const uintptr_t x1 = ufloor(rect->x1);
+  const uintptr_t x2 = uceil(rect->x2);
+  const uintptr_t y1 = ufloor(rect->y1);
+  const uintptr_t y2 = uceil(rect->y2);
 
-  double x = ufloor(rect->x1);
-  for (size_t idx = 0; idx != girara_list_size(xs); ++idx) {
-    const uintptr_t cx = (uintptr_t)girara_list_nth(xs, idx);
-    double y           = ufloor(rect->y1);
-    for (size_t inner_idx = 0; inner_idx != girara_list_size(ys); ++inner_idx) {
-      const uintptr_t cy     = (uintptr_t)girara_list_nth(ys, inner_idx);
-      zathura_rectangle_t* r = g_try_malloc(sizeof(zathura_rectangle_t));
+  // the borders inside of the rectangle are consecutive in the sorted coordinates
+  uintptr_t x = x1;
+  for (size_t ix = upper_bound(xs, nx, x1);;) {
+    const uintptr_t cx = (ix < nx && xs[ix] < x2) ? xs[ix++] : x2;
 
-      *r = (zathura_rectangle_t){x, y, cx, cy};
-      y  = cy;
-      girara_list_append_unique(rectangles, cmp_rectangle, r);
+    uintptr_t y = y1;
+    for (size_t iy = upper_bound(ys, ny, y1);;) {
+      const uintptr_t cy = (iy < ny && ys[iy] < y2) ? ys[iy++] : y2;
+      append_unique_cell(cells, rectangles, (zathura_rectangle_t){x, y, cx, cy});
+      y = cy;
+      if (cy == y2) {
+        break;
+      }
     }
+
     x = cx;
+    if (cx == x2) {
+      break;
+    }
   }
 }
 
 girara_list_t* flatten_rectangles(girara_list_t* rectangles) {
-  girara_list_t* new_rectangles   = girara_list_new_with_free(g_free);
-  g_autoptr(girara_list_t) points = girara_list_new_with_free(g_free);
-  girara_list_foreach(rectangles, rectangle_to_points, points);
+  girara_list_t* new_rectangles = girara_list_new_with_free(g_free);
+  const size_t n                = girara_list_size(rectangles);
+  if (n == 0) {
+    return new_rectangles;
+  }
+
+  // sorted borders of all rectangles
+  g_autofree uintptr_t* xs = g_new(uintptr_t, 2 * n);
+  g_autofree uintptr_t* ys = g_new(uintptr_t, 2 * n);
+  for (size_t idx = 0; idx != n; ++idx) {
+    const zathura_rectangle_t* r = girara_list_nth(rectangles, idx);
+    xs[2 * idx]                  = ufloor(r->x1);
+    xs[2 * idx + 1]              = uceil(r->x2);
+    ys[2 * idx]                  = ufloor(r->y1);
+    ys[2 * idx + 1]              = uceil(r->y2);
+  }
+  const size_t nx = sort_unique(xs, 2 * n);
+  const size_t ny = sort_unique(ys, 2 * n);
 
-  for (size_t idx = 0; idx != girara_list_size(rectangles); ++idx) {
+  g_autoptr(GHashTable) cells = g_hash_table_new(hash_rectangle, equal_rectangle);
+  for (size_t idx = 0; idx != n; ++idx) {
     const zathura_rectangle_t* r = girara_list_nth(rectangles, idx);
-    cut_rectangle(r, points, new_rectangles);
+    cut_rectangle(r, xs, nx, ys, ny, cells, new_rectangles);
   }
   return new_rectangles;
 }
@@ -601,93 +686,74 @@ bool search_document(zathura_t* zathura, girara_argument_t* argument, bool disab
   g_return_val_if_fail(argument != NULL, false);
   g_return_val_if_fail(zathura->document != NULL, false);
 
-  girara_session_t* session = zathura->ui.session;
+  girara_session_t* session         = zathura->ui.session;
+  zathura_search_results_t* results = zathura->global.search_results;
 
-  const unsigned int num_pages = zathura_document_get_number_of_pages(zathura->document);
-  const unsigned int cur_page  = zathura_document_get_current_page_number(zathura->document);
-  GtkWidget* cur_page_widget = zathura_page_get_widget(zathura, zathura_document_get_page(zathura->document, cur_page));
-  bool new_search            = argument->data != NULL;
-  bool nohlsearch            = false;
+  const unsigned int cur_page = zathura_document_get_current_page_number(zathura->document);
+  bool new_search             = argument->data != NULL;
+  bool nohlsearch             = false;
   bool first_time_after_abort = false;
 
   girara_setting_get(session, "nohlsearch", &nohlsearch);
   if (nohlsearch == false) {
-    gboolean draw = FALSE;
-    g_object_get(G_OBJECT(cur_page_widget), "draw-search-results", &draw, NULL);
-
-    if (draw == false) {
+    if (zathura->global.draw_search_results == false) {
       first_time_after_abort = true;
     }
 
     document_draw_search_results(zathura, true);
   }
 
-  int diff = argument->n == FORWARD ? 1 : -1;
+  bool forward = argument->n == FORWARD;
   if (zathura->global.search_direction == BACKWARD) {
-    diff = -diff;
+    forward = !forward;
   }
 
-  zathura_page_t* target_page = NULL;
-  int target_idx              = 0;
-
-  for (unsigned int page_id = 0; page_id < num_pages; ++page_id) {
-    int tmp              = cur_page + diff * page_id;
-    zathura_page_t* page = zathura_document_get_page(zathura->document, (tmp + num_pages) % num_pages);
-    if (page == NULL) {
-      continue;
-    }
+  unsigned int old_page  = 0;
+  const bool had_current = zathura_search_results_get_current(results, &old_page, NULL);
 
-    GtkWidget* page_widget = zathura_page_get_widget(zathura, page);
-
-    int num_search_results = 0, current = -1;
-    g_object_get(G_OBJECT(page_widget), "search-current", &current, "search-length", &num_search_results, NULL);
-    if (num_search_results == 0 || current == -1) {
-      continue;
+  /* continue from the current result if it is still in view, otherwise start
+   * at the closest page with results */
+  zathura_page_t* target_page = NULL;
+  unsigned int target_idx     = 0;
+  const bool current_in_view =
+      had_current == true &&
+      (old_page == cur_page || zathura_page_get_visibility(zathura_document_get_page(zathura->document, old_page)));
+  if (new_search == false && first_time_after_abort == false && current_in_view == true) {
+    zathura_search_results_move(results, forward);
+  } else {
+    unsigned int page_number = 0;
+    if (zathura_search_results_find_page(results, cur_page, forward, &page_number) == true) {
+      unsigned int length = 0;
+      zathura_search_results_get_page(results, page_number, &length);
+      zathura_search_results_set_current(results, page_number, forward == true ? 0 : length - 1);
+    } else {
+      zathura_search_results_unset_current(results);
     }
+  }
 
-    if (new_search == true || first_time_after_abort == true || (tmp + num_pages) % num_pages != cur_page) {
-      target_page = page;
-      target_idx  = diff == 1 ? 0 : num_search_results - 1;
-      break;
-    }
+  unsigned int target_page_number = 0;
+  if (zathura_search_results_get_current(results, &target_page_number, &target_idx) == true) {
+    target_page = zathura_document_get_page(zathura->document, target_page_number);
+  }
 
-    if (diff == 1 && (current < num_search_results - 1 || num_pages == 1)) {
-      /* the next result is on the same page */
-      target_page = page;
-      target_idx  = (current + 1) % num_search_results;
-    } else if (diff == -1 && (current > 0 || num_pages == 1)) {
-      target_page = page;
-      target_idx  = (current - 1 + num_search_results) % num_search_results;
-    } else {
-      /* the next result is on a different page */
-      g_object_set(G_OBJECT(page_widget), "search-current", -1, NULL);
-
-      for (unsigned int npage_id = 1; npage_id < num_pages; ++npage_id) {
-        int ntmp                     = cur_page + diff * (page_id + npage_id);
-        zathura_page_t* npage        = zathura_document_get_page(zathura->document, (ntmp + 2 * num_pages) % num_pages);
-        GtkWidget* npage_page_widget = zathura_page_get_widget(zathura, npage);
-        g_object_get(G_OBJECT(npage_page_widget), "search-length", &num_search_results, NULL);
-        if (num_search_results != 0) {
-          target_page = npage;
-          target_idx  = diff == 1 ? 0 : num_search_results - 1;
-          break;
-        }
-      }
+  /* redraw the pages of the old and the new current result */
+  if (had_current == true) {
+    GtkWidget* old_page_widget = zathura_page_get_widget_by_number(zathura, old_page);
+    if (old_page_widget != NULL) {
+      zathura_page_widget_update_search_results(ZATHURA_PAGE_WIDGET(old_page_widget));
     }
-
-    break;
   }
 
   if (target_page != NULL) {
-    girara_list_t* results   = NULL;
-    GtkWidget* page_widget   = zathura_page_get_widget(zathura, target_page);
-    GObject* obj_page_widget = G_OBJECT(page_widget);
-    g_object_set(obj_page_widget, "search-current", target_idx, NULL);
-    g_object_get(obj_page_widget, "search-results", &results, NULL);
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, target_page_number);
+    if (page_widget != NULL) {
+      zathura_page_widget_update_search_results(ZATHURA_PAGE_WIDGET(page_widget));
+    }
 
     /* Need to adjust rectangle to page scale and orientation */
-    zathura_rectangle_t* rect     = girara_list_nth(results, target_idx);
-    zathura_rectangle_t rectangle = recalc_rectangle(target_page, *rect);
+    unsigned int length                   = 0;
+    const zathura_rectangle_t* rectangles = zathura_search_results_get_page(results, target_page_number, &length);
+    zathura_rectangle_t rectangle         = recalc_rectangle(target_page, rectangles[target_idx]);
 
     bool search_hadjust = true;
     girara_setting_get(session, "search-hadjust", &search_hadjust);
@@ -724,12 +790,8 @@ bool search_document(zathura_t* zathura, girara_argument_t* argument, bool disab
     position_set(zathura, pos_x, pos_y);
     zathura_jumplist_add(zathura);
 
-    unsigned int current_page_number = zathura_document_get_current_page_number(zathura->document);
-    zathura_set_current_search_result_previous_pages(zathura, current_page_number);
-    zathura_modify_current_search_result(zathura, target_idx + 1);
-
-    g_autofree char* tmp = g_strdup_printf(_("[Search %d/%d]"), zathura->global.current_search_result,
-                                           zathura->global.total_search_results);
+    g_autofree char* tmp = g_strdup_printf(_("[Search %d/%d]"), (int)zathura_search_results_get_current_number(results),
+                                           (int)zathura_search_results_get_total(results));
     girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.search_count, tmp);
   } else if (argument->data != NULL && !disable_notify) {
     const char* input             = argument->data;
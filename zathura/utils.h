@@ -68,17 +68,46 @@ void index_scroll_to_current_page(zathura_t* zathura);
 zathura_rectangle_t recalc_rectangle(zathura_page_t* page, zathura_rectangle_t rectangle);
 
 /**
- * Returns the page widget of the page
+ * Returns the page widget of the page. Page widgets only exist for pages
+ * close to the viewport and for pages that carry state, see
+ * zathura_page_acquire_widget.
  *
  * @param zathura The zathura instance
  * @param page The page object
- * @return The page widget of the page
- * @return NULL if an error occurred
+ * @return The page widget of the page or NULL if the page has no widget
  */
 GtkWidget* zathura_page_get_widget(zathura_t* zathura, zathura_page_t* page);
 
+/**
+ * Returns the page widget of the page with the given number
+ *
+ * @param zathura The zathura instance
+ * @param page_number The page number
+ * @return The page widget of the page or NULL if the page has no widget
+ */
 GtkWidget* zathura_page_get_widget_by_number(zathura_t* zathura, unsigned int page_number);
 
+/**
+ * Binds a page widget to the page if it does not have one yet. Widgets from
+ * the pool of the document widget are reused before new ones are created.
+ *
+ * @param zathura The zathura instance
+ * @param page_number The page number
+ * @return The page widget of the page
+ * @return NULL if an error occurred
+ */
+GtkWidget* zathura_page_acquire_widget(zathura_t* zathura, unsigned int page_number);
+
+/**
+ * Releases the page widget of the page if it does not carry any state that
+ * would be lost. The widget is returned to the pool of the document widget.
+ *
+ * @param zathura The zathura instance
+ * @param page_number The page number
+ * @return true if the widget was released, false otherwise
+ */
+bool zathura_page_release_widget(zathura_t* zathura, unsigned int page_number);
+
 /**
  * Set if the search results should be drawn or not
  *
@@ -174,7 +203,9 @@ char* increment_first_page_column(const char* first_page_column_list, const unsi
 bool parse_color(GdkRGBA* color, const char* str);
 
 /**
- * Flatten list of overlapping rectangles.
+ * Flatten list of overlapping rectangles. Every rectangle is cut along the
+ * borders of all rectangles and cells covered by multiple rectangles are only
+ * returned once.
  *
  * @param[in] rectangles A list of rectangles
  *
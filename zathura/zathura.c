@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <locale.h>
 #include <girara/datastructures.h>
 #include <girara/utils.h>
@@ -48,6 +49,12 @@
 #include "resources.h"
 #include "synctex.h"
 #include "content-type.h"
+#include "internal.h"
+
+/* interval in milliseconds of the progress updates while a document is opened */
+#define DOCUMENT_OPEN_PROGRESS_INTERVAL 100
+/* size of the chunks in which documents are copied to temporary files */
+#define DOCUMENT_OPEN_SPOOL_CHUNK_SIZE 65536
 
 typedef struct zathura_document_info_s {
   zathura_t* zathura;
@@ -58,9 +65,15 @@ typedef struct zathura_document_info_s {
   char* bookmark_name;
   char* search_string;
   int page_number;
+  bool reload;
 } zathura_document_info_t;
 
 static gboolean document_info_open(gpointer data);
+static bool document_open_view(zathura_t* zathura, zathura_document_t* document, zathura_error_t error,
+                               const char* path, const char* uri, int page_number, zathura_fileinfo_t* file_info_p);
+static bool document_synctex_view(zathura_t* zathura, const char* synctex);
+static gboolean document_open_done(gpointer data);
+static void document_open_wait(zathura_t* zathura);
 
 #ifdef G_OS_UNIX
 static gboolean zathura_signal_sigterm(gpointer data);
@@ -78,6 +91,34 @@ static void free_document_info(zathura_document_info_t* document_info) {
   }
 }
 
+/* steps of opening a document on the worker thread */
+typedef enum document_open_stage_e {
+  DOCUMENT_OPEN_STAGE_COPY, /**< Copying the file to a temporary file */
+  DOCUMENT_OPEN_STAGE_OPEN, /**< Detecting the file type and opening the file */
+} document_open_stage_t;
+
+struct zathura_document_open_task_s {
+  zathura_t* zathura;
+  zathura_document_info_t* info; /**< The document to open */
+  zathura_document_info_t* next; /**< Document to open once the cancelled task has finished */
+  GCancellable* cancellable;     /**< Cancelled by Escape or when another document is opened */
+  GThread* thread;               /**< Worker thread */
+  guint progress_timeout;        /**< Source that shows the progress in the statusbar */
+  guint done_idle;               /**< Source that finishes opening on the main thread */
+  atomic_int stage;              /**< Current step of the worker thread */
+  atomic_int_fast64_t copied;    /**< Bytes copied to the temporary file */
+  atomic_int_fast64_t total;     /**< Size of the file that is copied or 0 if unknown */
+  char* file;                    /**< Path of the file that is opened */
+  char* uri;                     /**< URI of the file if it was copied from GIO */
+  bool temporary;                /**< The file is a temporary copy */
+  uint8_t hash_sha256[32];       /**< SHA256 hash of the temporary copy */
+  bool has_hash;                 /**< The hash was computed while copying */
+  const char* message;           /**< Error message if the file could not be read */
+  zathura_document_t* document;  /**< The opened document */
+  zathura_error_t error;         /**< Error of opening the document */
+  ZathuraRenderer* renderer;     /**< Renderer of the document that was shown when the task started */
+};
+
 /* function implementation */
 zathura_t* zathura_create(void) {
   zathura_t* zathura = g_try_malloc0(sizeof(zathura_t));
@@ -480,6 +521,7 @@ void zathura_free(zathura_t* zathura) {
     return;
   }
 
+  document_open_wait(zathura);
   document_close(zathura, false);
   document_predecessor_free(zathura);
 
@@ -592,8 +634,12 @@ static bool setup_renderer(zathura_t* zathura, zathura_document_t* document) {
     cache_size = ZATHURA_PAGE_CACHE_DEFAULT_SIZE;
   }
 
-  girara_debug("starting renderer with cache size %u", cache_size);
-  ZathuraRenderer* renderer = zathura_renderer_new(cache_size);
+  /* page cache memory budget in MiB */
+  unsigned int cache_memory = 0;
+  girara_setting_get(zathura->ui.session, "page-cache-memory", &cache_memory);
+
+  girara_debug("starting renderer with cache size %u and memory limit %u MiB", cache_size, cache_memory);
+  ZathuraRenderer* renderer = zathura_renderer_new(cache_size, (size_t)cache_memory * 1024 * 1024);
   if (renderer == NULL) {
     return false;
   }
@@ -615,7 +661,22 @@ static bool setup_renderer(zathura_t* zathura, zathura_document_t* document) {
   girara_setting_get(zathura->ui.session, "recolor-adjust-lightness", &recolor);
   zathura_renderer_enable_recolor_adjust_lightness(renderer, recolor);
 
+  /* number of render threads */
+  unsigned int render_threads = 1;
+  girara_setting_get(zathura->ui.session, "render-threads", &render_threads);
+  if (render_threads == 0) {
+    girara_warning("render-threads is not positive, using 1 instead");
+    render_threads = 1;
+  }
+  zathura_renderer_set_render_threads(renderer, render_threads);
+
+  /* remember the rendered pages to reuse them after a reload */
+  bool incremental_reload = false;
+  girara_setting_get(zathura->ui.session, "incremental-reload", &incremental_reload);
+  zathura_renderer_enable_fingerprints(renderer, incremental_reload);
+
   zathura->sync.render_thread = renderer;
+  zathura_document_set_renderer(document, renderer);
 
   /* create render request to render window icon */
   bool window_icon = false;
@@ -632,8 +693,37 @@ static bool setup_renderer(zathura_t* zathura, zathura_document_t* document) {
   return true;
 }
 
+/* copies the stream to the temporary file and hashes the data on the way, so
+ * the copy does not have to be read again to compute the hash */
+static bool spool_to_tmpfile(GInputStream* input, GFileIOStream* iostream, zathura_document_open_task_t* task,
+                             GError** error) {
+  GOutputStream* output = g_io_stream_get_output_stream(G_IO_STREAM(iostream));
+
+  g_autoptr(GChecksum) checksum = g_checksum_new(G_CHECKSUM_SHA256);
+  g_autofree uint8_t* buf       = g_malloc(DOCUMENT_OPEN_SPOOL_CHUNK_SIZE);
+  gint64 copied                 = 0;
+  gssize read;
+  while ((read = g_input_stream_read(input, buf, DOCUMENT_OPEN_SPOOL_CHUNK_SIZE, task->cancellable, error)) > 0) {
+    if (g_output_stream_write_all(output, buf, read, NULL, task->cancellable, error) == FALSE) {
+      return false;
+    }
+    g_checksum_update(checksum, buf, read);
+    copied += read;
+    atomic_store(&task->copied, copied);
+  }
+
+  if (read < 0 || g_io_stream_close(G_IO_STREAM(iostream), task->cancellable, error) == FALSE) {
+    return false;
+  }
+
+  gsize hash_size = sizeof(task->hash_sha256);
+  g_checksum_get_digest(checksum, task->hash_sha256, &hash_size);
+  task->has_hash = true;
+  return true;
+}
+
 #ifdef G_OS_UNIX
-static gchar* prepare_document_open_from_stdin(const char* path) {
+static gchar* prepare_document_open_from_stdin(const char* path, zathura_document_open_task_t* task) {
   int infileno = -1;
   if (g_strcmp0(path, "-") == 0) {
     infileno = fileno(stdin);
@@ -669,9 +759,7 @@ static gchar* prepare_document_open_from_stdin(const char* path) {
     return NULL;
   }
 
-  const ssize_t count = g_output_stream_splice(g_io_stream_get_output_stream(G_IO_STREAM(iostream)), input_stream,
-                                               G_OUTPUT_STREAM_SPLICE_NONE, NULL, &error);
-  if (count == -1) {
+  if (spool_to_tmpfile(input_stream, iostream, task, &error) == false) {
     if (error != NULL) {
       girara_error("Can not write to temporary file: %s", error->message);
     }
@@ -683,7 +771,7 @@ static gchar* prepare_document_open_from_stdin(const char* path) {
 }
 #endif
 
-static gchar* prepare_document_open_from_gfile(GFile* source) {
+static gchar* prepare_document_open_from_gfile(GFile* source, zathura_document_open_task_t* task) {
   g_autofree gchar* basename = g_file_get_basename(source);
   g_autofree gchar* template = g_strdup_printf("zathura.gio.XXXXXX.%s", basename);
 
@@ -700,99 +788,377 @@ static gchar* prepare_document_open_from_gfile(GFile* source) {
   g_autofree gchar* tmpfile_path = g_file_get_path(tmpfile);
   girara_debug("Copying to temporary file: %s", tmpfile_path);
 
-  gboolean rc = g_file_copy(source, tmpfile, G_FILE_COPY_OVERWRITE, NULL, NULL, NULL, &error);
-  if (rc == FALSE) {
+  g_autoptr(GFileInfo) info = g_file_query_info(source, G_FILE_ATTRIBUTE_STANDARD_SIZE, G_FILE_QUERY_INFO_NONE,
+                                                task->cancellable, NULL);
+  if (info != NULL) {
+    atomic_store(&task->total, g_file_info_get_size(info));
+  }
+
+  g_autoptr(GFileInputStream) input_stream = g_file_read(source, task->cancellable, &error);
+  if (input_stream == NULL || spool_to_tmpfile(G_INPUT_STREAM(input_stream), iostream, task, &error) == false) {
     if (error != NULL) {
       girara_error("Can not copy to temporary file: %s", error->message);
     }
+    g_file_delete(tmpfile, NULL, NULL);
     return NULL;
   }
 
   return g_file_get_path(tmpfile);
 }
 
-static gboolean document_info_open(gpointer data) {
-  zathura_document_info_t* document_info = data;
-  g_return_val_if_fail(document_info != NULL, FALSE);
-  g_autofree char* uri = NULL;
+static void document_open_task_free(zathura_document_open_task_t* task) {
+  if (task->progress_timeout != 0) {
+    g_source_remove(task->progress_timeout);
+  }
+  if (task->temporary == true && task->file != NULL) {
+    g_unlink(task->file);
+  }
+  if (task->document != NULL) {
+    zathura_document_free(task->document);
+  }
 
-  if (document_info->zathura != NULL && document_info->path != NULL) {
-    g_autofree char* file = NULL;
-    if (g_strcmp0(document_info->path, "-") == 0 || g_str_has_prefix(document_info->path, "/proc/self/fd/") == true) {
+  g_clear_object(&task->cancellable);
+  g_clear_object(&task->renderer);
+  free_document_info(task->info);
+  free_document_info(task->next);
+  g_free(task->file);
+  g_free(task->uri);
+  g_free(task);
+}
+
+/**
+ * Reads the file and opens the document without touching the user interface.
+ *
+ * Besides the task itself, the worker only touches the following state of the
+ * session, all of which may be used from several threads:
+ *  - zathura->content_type_context: guesses are serialized by the context
+ *  - zathura->plugins.manager: read-only once the plugins have been loaded
+ *  - zathura->database: set up before any document is opened, the sqlite
+ *    database is opened in serialized mode
+ *  - task->renderer: the renderer of the document that is shown, plugins that
+ *    are not thread-safe take its lock while they open the new document
+ *
+ * Settings, the document that is shown, the file monitor and all widgets
+ * belong to the main thread and are only used in document_open_done.
+ */
+static gpointer document_open_thread(gpointer data) {
+  zathura_document_open_task_t* task     = data;
+  zathura_document_info_t* document_info = task->info;
+
+  if (g_strcmp0(document_info->path, "-") == 0 || g_str_has_prefix(document_info->path, "/proc/self/fd/") == true) {
 #ifdef G_OS_UNIX
-      file = prepare_document_open_from_stdin(document_info->path);
+    task->file = prepare_document_open_from_stdin(document_info->path, task);
 #endif
-      if (file == NULL) {
-        girara_notify(document_info->zathura->ui.session, GIRARA_ERROR,
-                      _("Could not read file from stdin and write it to a temporary file."));
-      } else {
-        if (document_info->zathura->stdin_support.file != NULL) {
-          g_unlink(document_info->zathura->stdin_support.file);
-          g_free(document_info->zathura->stdin_support.file);
-        }
-        document_info->zathura->stdin_support.file = g_strdup(file);
-      }
-    } else {
-      /* expand ~ and ~user in paths if present */
-      g_autofree char* tmp_path = *document_info->path == '~' ? girara_fix_path(document_info->path) : NULL;
-      g_autoptr(GFile) gf       = g_file_new_for_commandline_arg(tmp_path != NULL ? tmp_path : document_info->path);
+    if (task->file == NULL) {
+      task->message = _("Could not read file from stdin and write it to a temporary file.");
+    }
+    task->temporary = true;
+  } else {
+    /* expand ~ and ~user in paths if present */
+    g_autofree char* tmp_path = *document_info->path == '~' ? girara_fix_path(document_info->path) : NULL;
+    g_autoptr(GFile) gf       = g_file_new_for_commandline_arg(tmp_path != NULL ? tmp_path : document_info->path);
 
-      if (g_file_is_native(gf) == TRUE) {
-        /* file was given as a native path */
-        file = g_file_get_path(gf);
-      } else {
-        /* copy file with GIO */
-        uri  = g_file_get_uri(gf);
-        file = prepare_document_open_from_gfile(gf);
-        if (file == NULL) {
-          girara_notify(document_info->zathura->ui.session, GIRARA_ERROR,
-                        _("Could not read file from GIO and copy it to a temporary file."));
-        } else {
-          if (document_info->zathura->stdin_support.file != NULL) {
-            g_unlink(document_info->zathura->stdin_support.file);
-            g_free(document_info->zathura->stdin_support.file);
-          }
-          document_info->zathura->stdin_support.file = g_strdup(file);
-        }
+    if (g_file_is_native(gf) == TRUE) {
+      /* file was given as a native path */
+      task->file = g_file_get_path(gf);
+    } else {
+      /* copy file with GIO */
+      task->uri  = g_file_get_uri(gf);
+      task->file = prepare_document_open_from_gfile(gf, task);
+      if (task->file == NULL) {
+        task->message = _("Could not read file from GIO and copy it to a temporary file.");
       }
+      task->temporary = true;
     }
+  }
 
-    if (file != NULL) {
-      if (document_info->synctex != NULL) {
-        document_open_synctex(document_info->zathura, file, uri, document_info->password, document_info->synctex);
-      } else {
-        document_open(document_info->zathura, file, uri, document_info->password, document_info->page_number, NULL);
-      }
+  if (task->file != NULL && g_cancellable_is_cancelled(task->cancellable) == FALSE) {
+    atomic_store(&task->stage, DOCUMENT_OPEN_STAGE_OPEN);
+    girara_debug("opening document: %s", task->file);
+    task->document = zathura_document_open_with_hash(task->zathura, task->file, task->uri, document_info->password,
+                                                     task->has_hash == true ? task->hash_sha256 : NULL, task->renderer,
+                                                     &task->error);
+  }
 
-      if (document_info->mode != NULL) {
-        if (g_strcmp0(document_info->mode, "presentation") == 0) {
-          sc_toggle_presentation(document_info->zathura->ui.session, NULL, NULL, 0);
-        } else if (g_strcmp0(document_info->mode, "fullscreen") == 0) {
-          sc_toggle_fullscreen(document_info->zathura->ui.session, NULL, NULL, 0);
-        } else {
-          girara_error("Unknown mode: %s", document_info->mode);
-        }
-      }
+  task->done_idle = gdk_threads_add_idle(document_open_done, task);
+  return NULL;
+}
 
-      if (document_info->bookmark_name != NULL) {
-        g_autoptr(girara_list_t) arg_list = girara_list_new();
-        girara_list_append(arg_list, document_info->bookmark_name);
-        cmd_bookmark_open(document_info->zathura->ui.session, arg_list);
-      }
+static gboolean document_open_progress(gpointer data) {
+  zathura_document_open_task_t* task = data;
+  zathura_t* zathura                 = task->zathura;
+  if (zathura->ui.session == NULL || zathura->ui.statusbar.file == NULL) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  g_autofree char* basename = g_path_get_basename(task->info->path);
+  g_autofree char* text     = NULL;
+  const gint64 copied       = atomic_load(&task->copied);
+  const gint64 total        = atomic_load(&task->total);
+  if (atomic_load(&task->stage) == DOCUMENT_OPEN_STAGE_COPY && total > 0) {
+    text = g_strdup_printf(_("Copying %s (%d%%) ..."), basename, (int)(copied * 100 / total));
+  } else if (atomic_load(&task->stage) == DOCUMENT_OPEN_STAGE_COPY) {
+    text = g_strdup_printf(_("Copying %s ..."), basename);
+  } else {
+    text = g_strdup_printf(_("Opening %s ..."), basename);
+  }
+  girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.file, text);
 
-      if (document_info->search_string != NULL) {
-        girara_argument_t search_arg;
-        search_arg.n    = 1; // Forward search
-        search_arg.data = NULL;
-        cmd_search(document_info->zathura->ui.session, document_info->search_string, &search_arg);
-      }
+  return G_SOURCE_CONTINUE;
+}
+
+static void document_open_start(zathura_t* zathura, zathura_document_info_t* document_info) {
+  zathura_document_open_task_t* task = g_try_malloc0(sizeof(zathura_document_open_task_t));
+  if (task == NULL) {
+    free_document_info(document_info);
+    return;
+  }
+
+  task->zathura     = zathura;
+  task->info        = document_info;
+  task->cancellable = g_cancellable_new();
+  atomic_init(&task->stage, DOCUMENT_OPEN_STAGE_COPY);
+  atomic_init(&task->copied, 0);
+  atomic_init(&task->total, 0);
+  if (zathura_has_document(zathura) == true && zathura->sync.render_thread != NULL) {
+    task->renderer = g_object_ref(zathura->sync.render_thread);
+  }
+
+  zathura->sync.document_open = task;
+  task->thread                = g_thread_new("document-open", document_open_thread, task);
+  /* fast opens finish before the progress is shown, reloads keep showing the document */
+  if (document_info->reload == false) {
+    task->progress_timeout = g_timeout_add(DOCUMENT_OPEN_PROGRESS_INTERVAL, document_open_progress, task);
+  }
+}
+
+/* replaces the shown document by its reopened version and keeps the view */
+static void document_reload_finish(zathura_document_open_task_t* task) {
+  zathura_t* zathura = task->zathura;
+
+  if (zathura->file_monitor.monitor == NULL ||
+      g_strcmp0(zathura_filemonitor_get_filepath(zathura->file_monitor.monitor), task->info->path) != 0) {
+    girara_debug("the document was closed in the meantime, dropping reloaded %s", task->file);
+    return;
+  }
+
+  /* Get file info (zoom, current page, etc.) */
+  zathura_fileinfo_t file_info;
+  if (zathura->document == NULL && zathura->predecessor_document != NULL) {
+    /* Try to get the info from the predecessor document if the current does not exist */
+    file_info = zathura_get_prefileinfo(zathura);
+  } else {
+    file_info = zathura_get_fileinfo(zathura);
+  }
+
+  /* remember the hash to drop the outdated text index */
+  uint8_t old_hash[32] = {0};
+  const bool had_hash  = zathura->document != NULL;
+  if (had_hash == true) {
+    memcpy(old_hash, zathura_document_get_hash(zathura->document), sizeof(old_hash));
+  }
+
+  /* the old document is only closed now, so it stays visible while the new one is opened */
+  document_close(zathura, true);
+  document_open_view(zathura, g_steal_pointer(&task->document), task->error, task->info->path, task->uri,
+                     file_info.current_page, &file_info);
+
+  /* only render the pages that changed */
+  document_predecessor_reuse_pages(zathura);
+
+  if (had_hash == true && (zathura->document == NULL ||
+                           memcmp(old_hash, zathura_document_get_hash(zathura->document), sizeof(old_hash)) != 0)) {
+    zathura_text_index_remove(zathura->config.cache_dir, old_hash);
+  }
+}
+
+/* applies the options given on the command line to the opened document */
+static void document_open_finish(zathura_document_open_task_t* task) {
+  zathura_t* zathura                     = task->zathura;
+  zathura_document_info_t* document_info = task->info;
+
+  if (document_info->reload == true) {
+    document_reload_finish(task);
+    return;
+  }
+
+  if (zathura->document != NULL) {
+    girara_debug("another document was opened in the meantime, dropping %s", task->file);
+    return;
+  }
+
+  if (task->temporary == true) {
+    if (zathura->stdin_support.file != NULL) {
+      g_unlink(zathura->stdin_support.file);
+      g_free(zathura->stdin_support.file);
     }
+    zathura->stdin_support.file = g_strdup(task->file);
+    task->temporary             = false;
+  }
+
+  const int page_number =
+      document_info->synctex != NULL ? ZATHURA_PAGE_NUMBER_UNSPECIFIED : document_info->page_number;
+  const bool opened = document_open_view(zathura, g_steal_pointer(&task->document), task->error, task->file,
+                                         task->uri, page_number, NULL);
+  if (opened == true && document_info->synctex != NULL) {
+    document_synctex_view(zathura, document_info->synctex);
+  }
+
+  if (document_info->mode != NULL) {
+    if (g_strcmp0(document_info->mode, "presentation") == 0) {
+      sc_toggle_presentation(zathura->ui.session, NULL, NULL, 0);
+    } else if (g_strcmp0(document_info->mode, "fullscreen") == 0) {
+      sc_toggle_fullscreen(zathura->ui.session, NULL, NULL, 0);
+    } else {
+      girara_error("Unknown mode: %s", document_info->mode);
+    }
+  }
+
+  if (document_info->bookmark_name != NULL) {
+    g_autoptr(girara_list_t) arg_list = girara_list_new();
+    girara_list_append(arg_list, document_info->bookmark_name);
+    cmd_bookmark_open(zathura->ui.session, arg_list);
+  }
+
+  if (document_info->search_string != NULL) {
+    girara_argument_t search_arg;
+    search_arg.n    = 1; // Forward search
+    search_arg.data = NULL;
+    cmd_search(zathura->ui.session, document_info->search_string, &search_arg);
+  }
+}
+
+static gboolean document_open_done(gpointer data) {
+  zathura_document_open_task_t* task = data;
+  zathura_t* zathura                 = task->zathura;
+
+  /* the worker has returned, so the source id is set */
+  g_thread_join(task->thread);
+  task->thread    = NULL;
+  task->done_idle = 0;
+  if (task->progress_timeout != 0) {
+    g_source_remove(task->progress_timeout);
+    task->progress_timeout = 0;
+  }
+  zathura->sync.document_open = NULL;
+  /* the new document gets its own renderer, the shown one may be closed first */
+  if (task->document != NULL) {
+    zathura_document_set_renderer(task->document, NULL);
+  }
+
+  if (g_cancellable_is_cancelled(task->cancellable) == TRUE) {
+    girara_debug("opening %s was cancelled", task->info->path);
+  } else if (task->message != NULL) {
+    girara_notify(zathura->ui.session, GIRARA_ERROR, "%s", task->message);
+  } else {
+    document_open_finish(task);
+  }
+
+  zathura_document_info_t* next = g_steal_pointer(&task->next);
+  document_open_task_free(task);
+  if (next != NULL) {
+    document_open_start(zathura, next);
+  }
+
+  return FALSE;
+}
+
+bool document_open_cancel(zathura_t* zathura) {
+  g_return_val_if_fail(zathura != NULL, false);
+
+  zathura_document_open_task_t* task = zathura->sync.document_open;
+  if (task == NULL || g_cancellable_is_cancelled(task->cancellable) == TRUE) {
+    return false;
+  }
+  /* reloads happen in the background while the document is still shown */
+  if (task->info->reload == true) {
+    return false;
+  }
+
+  /* the plugin cannot be interrupted, its result is dropped once it returns */
+  g_cancellable_cancel(task->cancellable);
+  if (task->progress_timeout != 0) {
+    g_source_remove(task->progress_timeout);
+    task->progress_timeout = 0;
+  }
+  if (zathura->ui.session != NULL && zathura->ui.statusbar.file != NULL) {
+    girara_statusbar_item_set_text(zathura->ui.session, zathura->ui.statusbar.file, _("[No name]"));
+  }
+  girara_notify(zathura->ui.session, GIRARA_INFO, _("Opening the document was cancelled."));
+
+  return true;
+}
+
+static void document_open_wait(zathura_t* zathura) {
+  zathura_document_open_task_t* task = g_steal_pointer(&zathura->sync.document_open);
+  if (task == NULL) {
+    return;
+  }
+
+  g_cancellable_cancel(task->cancellable);
+  g_thread_join(task->thread);
+  if (task->done_idle != 0) {
+    g_source_remove(task->done_idle);
+  }
+  document_open_task_free(task);
+}
+
+static gboolean document_info_open(gpointer data) {
+  zathura_document_info_t* document_info = data;
+  g_return_val_if_fail(document_info != NULL, FALSE);
+
+  if (document_info->zathura == NULL || document_info->path == NULL) {
+    free_document_info(document_info);
+    return FALSE;
   }
 
-  free_document_info(document_info);
+  /* a document that is still being opened is replaced by the new one */
+  zathura_t* zathura                 = document_info->zathura;
+  zathura_document_open_task_t* task = zathura->sync.document_open;
+  if (task != NULL) {
+    g_cancellable_cancel(task->cancellable);
+    free_document_info(task->next);
+    task->next = document_info;
+    return FALSE;
+  }
+
+  document_open_start(zathura, document_info);
   return FALSE;
 }
 
+void document_reload(zathura_t* zathura) {
+  g_return_if_fail(zathura != NULL);
+
+  if (zathura->file_monitor.monitor == NULL) {
+    return;
+  }
+
+  zathura_document_info_t* document_info = g_try_malloc0(sizeof(zathura_document_info_t));
+  if (document_info == NULL) {
+    return;
+  }
+
+  document_info->zathura     = zathura;
+  document_info->path        = g_strdup(zathura_filemonitor_get_filepath(zathura->file_monitor.monitor));
+  document_info->password    = g_strdup(zathura->file_monitor.password);
+  document_info->page_number = ZATHURA_PAGE_NUMBER_UNSPECIFIED;
+  document_info->reload      = true;
+
+  /* a reload that is still running reads an outdated file, but another
+   * document that is being opened is not replaced by a reload */
+  zathura_document_open_task_t* task = zathura->sync.document_open;
+  if (task != NULL) {
+    zathura_document_info_t* pending = task->next != NULL ? task->next : task->info;
+    if (pending->reload == false) {
+      girara_debug("another document is being opened, not reloading %s", document_info->path);
+      free_document_info(document_info);
+      return;
+    }
+  }
+
+  document_info_open(document_info);
+}
+
 char* get_formatted_filename(zathura_t* zathura, bool statusbar) {
   bool basename_only           = false;
   const char* file_path        = NULL;
@@ -855,6 +1221,12 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
   zathura_document_t* document =
       zathura_document_open(zathura, tmp_path != NULL ? tmp_path : path, uri, password, &error);
 
+  return document_open_view(zathura, document, error, path, uri, page_number, file_info_p);
+}
+
+/* shows a document that was opened by the plugin, or reports why it could not be opened */
+static bool document_open_view(zathura_t* zathura, zathura_document_t* document, zathura_error_t error,
+                               const char* path, const char* uri, int page_number, zathura_fileinfo_t* file_info_p) {
   if (document == NULL) {
     if (error == ZATHURA_ERROR_INVALID_PASSWORD) {
       girara_debug("Invalid or no password.");
@@ -1019,6 +1391,11 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
     if (zathura->file_monitor.monitor == NULL) {
       goto error_free;
     }
+
+    unsigned int quiet_period = ZATHURA_FILEMONITOR_DEFAULT_QUIET_PERIOD;
+    girara_setting_get(zathura->ui.session, "filemonitor-quiet-period", &quiet_period);
+    g_object_set(zathura->file_monitor.monitor, "quiet-period", quiet_period, NULL);
+
     g_signal_connect(G_OBJECT(zathura->file_monitor.monitor), "reload-file", G_CALLBACK(cb_file_monitor),
                      zathura->ui.session);
 
@@ -1052,36 +1429,19 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
   const int device_factor = gtk_widget_get_scale_factor(zathura->ui.session->gtk.view);
   zathura_document_set_device_factors(document, device_factor, device_factor);
 
-  /* create blank pages */
+  /* page widgets are created once they are needed */
   zathura->pages = g_try_malloc0_n(number_of_pages, sizeof(GtkWidget*));
   if (zathura->pages == NULL) {
     goto error_free;
   }
-
-  for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
-    zathura_page_t* page = zathura_document_get_page(document, page_id);
-    if (page == NULL) {
-      goto error_free;
-    }
-
-    GtkWidget* page_widget = zathura_page_widget_new(zathura, page);
-    if (page_widget == NULL) {
-      goto error_free;
-    }
-
-    g_object_ref(page_widget);
-    zathura->pages[page_id] = page_widget;
-
-    gtk_widget_set_halign(page_widget, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(page_widget, GTK_ALIGN_CENTER);
-
-    g_signal_connect(G_OBJECT(page_widget), "text-selected", G_CALLBACK(cb_page_widget_text_selected), zathura);
-    g_signal_connect(G_OBJECT(page_widget), "image-selected", G_CALLBACK(cb_page_widget_image_selected), zathura);
-    g_signal_connect(G_OBJECT(page_widget), "enter-link", G_CALLBACK(cb_page_widget_link), (gpointer) true);
-    g_signal_connect(G_OBJECT(page_widget), "leave-link", G_CALLBACK(cb_page_widget_link), (gpointer) false);
-    g_signal_connect(G_OBJECT(page_widget), "scaled-button-release", G_CALLBACK(cb_page_widget_scaled_button_release),
-                     zathura);
+  zathura->global.search_results = zathura_search_results_new(number_of_pages);
+  if (zathura->global.search_results == NULL) {
+    goto error_free;
   }
+  zathura->global.draw_search_results = false;
+  zathura->global.visible_pages.valid = false;
+  zathura->global.prefetch.valid      = false;
+  zathura_prefetch_reset(&zathura->global.prefetch.tracker);
 
   /* view mode */
   unsigned int pages_per_row   = 1;
@@ -1138,22 +1498,6 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
 
   /* adjust_view */
   adjust_view(zathura);
-  for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
-    /* set widget size */
-    zathura_page_t* page     = zathura_document_get_page(document, page_id);
-    unsigned int page_height = 0;
-    unsigned int page_width  = 0;
-    GtkWidget* widget        = zathura_page_get_widget(zathura, page);
-
-    /* adjust_view calls render_all in some cases and render_all calls
-     * gtk_widget_set_size_request. To be sure that it's really called, do it
-     * here once again. */
-    page_calc_height_width(zathura->document, page, &page_height, &page_width, true);
-    zathura_page_widget_set_size_request(ZATHURA_PAGE_WIDGET(widget), page_width, page_height);
-
-    /* show widget */
-    gtk_widget_show(widget);
-  }
 
   /* Set page */
   const unsigned int page = zathura_document_get_current_page_number(document);
@@ -1171,6 +1515,25 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
   zathura_show_signature_information(zathura, show_signature_information);
   update_visible_pages(zathura);
 
+  /* load the remaining pages in the background */
+  zathura->sync.page_loader = zathura_page_loader_new(zathura);
+  /* searches use the text of the pages that was extracted before, it is only
+   * kept on disk if requested and never for password protected documents */
+  const char* text_index_dir   = NULL;
+  unsigned int text_index_size = 0;
+#ifndef WITH_SANDBOX
+  bool text_index_cache = false;
+  girara_setting_get(zathura->ui.session, "text-index-cache", &text_index_cache);
+  girara_setting_get(zathura->ui.session, "text-index-cache-size", &text_index_size);
+  const char* password = zathura_document_get_password(document);
+  if (text_index_cache == true && (password == NULL || *password == '\0')) {
+    text_index_dir = zathura->config.cache_dir;
+  }
+#endif
+  zathura->sync.text_index = zathura_text_index_new(text_index_dir, zathura_document_get_hash(document),
+                                                    zathura_document_get_number_of_pages(document),
+                                                    (size_t)text_index_size * 1024 * 1024);
+
   /* this needs to run at the end since it will refresh the view via zathura_view_update_ppi */
   /* call screen-changed callback to connect monitors-changed signal on initial screen */
   cb_widget_screen_changed(zathura->ui.session->gtk.view, NULL, zathura);
@@ -1178,6 +1541,7 @@ bool document_open(zathura_t* zathura, const char* path, const char* uri, const
   return true;
 
 error_free:
+  g_clear_pointer(&zathura->global.search_results, zathura_search_results_free);
   zathura_document_free(document);
   zathura->document = NULL;
 
@@ -1191,6 +1555,11 @@ bool document_open_synctex(zathura_t* zathura, const char* path, const char* uri
   if (ret == false) {
     return false;
   }
+
+  return document_synctex_view(zathura, synctex);
+}
+
+static bool document_synctex_view(zathura_t* zathura, const char* synctex) {
   if (synctex == NULL) {
     return true;
   }
@@ -1313,14 +1682,41 @@ static void save_fileinfo_to_db(zathura_t* zathura) {
   g_free(file_info.first_page_column_list);
 }
 
+/**
+ * State of the comparison of the pages of a reloaded document with the pages
+ * of its predecessor. The fingerprints of the predecessor were taken after
+ * its pages were rendered, as its file has been replaced by now. The thread
+ * only reads the pages of both documents, so the comparison is stopped before
+ * either of them is freed.
+ */
+struct zathura_predecessor_reuse_s {
+  zathura_t* zathura;                       /**< Zathura session */
+  zathura_document_t* document;             /**< The reloaded document */
+  zathura_document_t* predecessor_document; /**< The document from before the reload */
+  ZathuraRenderer* renderer;                /**< Renderer to serialize plugin calls with */
+  GArray* candidates;                       /**< Pages with a rendered and fingerprinted predecessor */
+  GArray* unchanged;                        /**< Pages whose fingerprints match, filled by the thread */
+  GThread* thread;                          /**< Thread computing the fingerprints */
+  atomic_bool cancelled;                    /**< Stop comparing pages */
+  guint idle;                               /**< Source taking over the unchanged pages or 0 */
+};
+
+static void predecessor_reuse_free(zathura_predecessor_reuse_t* reuse);
+
 bool document_predecessor_free(zathura_t* zathura) {
-  if (zathura == NULL || (zathura->predecessor_document == NULL && zathura->predecessor_pages == NULL)) {
+  if (zathura == NULL) {
+    return false;
+  }
+  g_clear_pointer(&zathura->sync.predecessor_reuse, predecessor_reuse_free);
+  if (zathura->predecessor_document == NULL && zathura->predecessor_pages == NULL) {
     return false;
   }
 
   if (zathura->predecessor_pages != NULL) {
     for (unsigned int i = 0; i < zathura_document_get_number_of_pages(zathura->predecessor_document); i++) {
-      g_object_unref(zathura->predecessor_pages[i]);
+      if (zathura->predecessor_pages[i] != NULL) {
+        g_object_unref(zathura->predecessor_pages[i]);
+      }
     }
     g_free(zathura->predecessor_pages);
     zathura->predecessor_pages = NULL;
@@ -1336,6 +1732,143 @@ bool document_predecessor_free(zathura_t* zathura) {
   return true;
 }
 
+static void predecessor_reuse_free(zathura_predecessor_reuse_t* reuse) {
+  /* the pages of both documents are used until the thread is done */
+  atomic_store(&reuse->cancelled, true);
+  if (reuse->thread != NULL) {
+    g_thread_join(reuse->thread);
+  }
+  g_clear_handle_id(&reuse->idle, g_source_remove);
+
+  g_object_unref(reuse->renderer);
+  g_array_free(reuse->candidates, TRUE);
+  g_array_free(reuse->unchanged, TRUE);
+  g_free(reuse);
+}
+
+/* only the pages of the reloaded document are fingerprinted here */
+static bool predecessor_reuse_update_fingerprint(zathura_predecessor_reuse_t* reuse, zathura_page_t* page) {
+  /* plugins that are not thread-safe have to be serialized with the render thread */
+  zathura_document_t* document = zathura_page_get_document(page);
+  const bool concurrent        = zathura_plugin_supports_concurrent_render(zathura_document_get_plugin(document));
+  if (concurrent == false) {
+    zathura_renderer_lock(reuse->renderer);
+  }
+  const bool ret = zathura_page_update_fingerprint(page);
+  if (concurrent == false) {
+    zathura_renderer_unlock(reuse->renderer);
+  }
+
+  return ret;
+}
+
+static gboolean predecessor_reuse_finish(gpointer data) {
+  zathura_predecessor_reuse_t* reuse = data;
+  zathura_t* zathura                 = reuse->zathura;
+
+  reuse->idle = 0;
+  g_thread_join(reuse->thread);
+  reuse->thread                   = NULL;
+  zathura->sync.predecessor_reuse = NULL;
+
+  /* pages that were rendered in the meantime keep their own surface */
+  unsigned int reused = 0;
+  for (unsigned int idx = 0; idx < reuse->unchanged->len; ++idx) {
+    const unsigned int page_id = g_array_index(reuse->unchanged, unsigned int, idx);
+    GtkWidget* predecessor     = zathura->predecessor_pages[page_id];
+    GtkWidget* page_widget     = zathura_page_acquire_widget(zathura, page_id);
+    if (page_widget != NULL &&
+        zathura_page_widget_reuse_surface(ZATHURA_PAGE_WIDGET(page_widget), ZATHURA_PAGE_WIDGET(predecessor)) == true) {
+      reused++;
+    }
+  }
+
+  girara_debug("reused %u of %u rendered pages of the predecessor document", reused, reuse->candidates->len);
+  predecessor_reuse_free(reuse);
+
+  return G_SOURCE_REMOVE;
+}
+
+static gpointer predecessor_reuse_thread(gpointer data) {
+  zathura_predecessor_reuse_t* reuse = data;
+
+  for (unsigned int idx = 0; idx < reuse->candidates->len && atomic_load(&reuse->cancelled) == false; ++idx) {
+    const unsigned int page_id = g_array_index(reuse->candidates, unsigned int, idx);
+    zathura_page_t* old_page   = zathura_document_get_page(reuse->predecessor_document, page_id);
+    zathura_page_t* page       = zathura_document_get_page(reuse->document, page_id);
+    if (old_page == NULL || page == NULL || predecessor_reuse_update_fingerprint(reuse, page) == false) {
+      continue;
+    }
+
+    if (memcmp(zathura_page_get_fingerprint(old_page), zathura_page_get_fingerprint(page), 32) == 0) {
+      g_array_append_val(reuse->unchanged, page_id);
+    }
+  }
+
+  if (atomic_load(&reuse->cancelled) == false) {
+    reuse->idle = g_idle_add(predecessor_reuse_finish, reuse);
+  }
+
+  return NULL;
+}
+
+void document_predecessor_reuse_pages(zathura_t* zathura) {
+  if (zathura_has_document(zathura) == false || zathura->predecessor_document == NULL ||
+      zathura->predecessor_pages == NULL) {
+    return;
+  }
+
+  bool incremental_reload = false;
+  girara_setting_get(zathura->ui.session, "incremental-reload", &incremental_reload);
+  if (incremental_reload == false) {
+    return;
+  }
+
+  g_clear_pointer(&zathura->sync.predecessor_reuse, predecessor_reuse_free);
+
+  zathura_predecessor_reuse_t* reuse = g_try_malloc0(sizeof(zathura_predecessor_reuse_t));
+  if (reuse == NULL) {
+    return;
+  }
+
+  reuse->zathura              = zathura;
+  reuse->document             = zathura->document;
+  reuse->predecessor_document = zathura->predecessor_document;
+  reuse->renderer             = g_object_ref(zathura->sync.render_thread);
+  reuse->candidates           = g_array_new(FALSE, FALSE, sizeof(unsigned int));
+  reuse->unchanged            = g_array_new(FALSE, FALSE, sizeof(unsigned int));
+  atomic_init(&reuse->cancelled, false);
+
+  /* only pages that were rendered and fingerprinted before the reload are
+   * compared, the file of the predecessor must not be read anymore */
+  const unsigned int number_of_pages = MIN(zathura_document_get_number_of_pages(zathura->document),
+                                           zathura_document_get_number_of_pages(zathura->predecessor_document));
+  for (unsigned int page_id = 0; page_id < number_of_pages; page_id++) {
+    GtkWidget* predecessor = zathura->predecessor_pages[page_id];
+    zathura_page_t* page   = zathura_document_get_page(zathura->predecessor_document, page_id);
+    if (predecessor != NULL && zathura_page_widget_have_surface(ZATHURA_PAGE_WIDGET(predecessor)) == true &&
+        zathura_page_get_fingerprint(page) != NULL) {
+      g_array_append_val(reuse->candidates, page_id);
+    }
+  }
+
+  if (reuse->candidates->len == 0) {
+    predecessor_reuse_free(reuse);
+    return;
+  }
+
+  /* the fingerprints call into the plugin, which can take a while for large pages */
+  g_autoptr(GError) error = NULL;
+  reuse->thread           = g_thread_try_new("predecessor-reuse", predecessor_reuse_thread, reuse, &error);
+  if (reuse->thread == NULL) {
+    girara_error("Failed to compare pages with the predecessor document: %s", error->message);
+    predecessor_reuse_free(reuse);
+    return;
+  }
+
+  zathura->sync.predecessor_reuse = reuse;
+}
+
 bool document_close(zathura_t* zathura, bool keep_monitor) {
   if (zathura_has_document(zathura) == false) {
     return false;
@@ -1346,9 +1879,16 @@ bool document_close(zathura_t* zathura, bool keep_monitor) {
     girara_set_window_icon(zathura->ui.session, "org.pwmt.zathura");
   }
 
-  /* stop rendering */
+  /* stop rendering and loading pages */
+  g_clear_pointer(&zathura->sync.predecessor_reuse, predecessor_reuse_free);
   zathura_renderer_stop(zathura->sync.render_thread);
   g_clear_object(&zathura->window_icon_render_request);
+  g_clear_pointer(&zathura->sync.page_loader, zathura_page_loader_free);
+  g_clear_pointer(&zathura->sync.search, zathura_search_free);
+  if (zathura->sync.text_index != NULL) {
+    zathura_text_index_save(zathura->sync.text_index);
+  }
+  g_clear_pointer(&zathura->sync.text_index, zathura_text_index_free);
 
   /* remove monitor */
   if (keep_monitor == false) {
@@ -1381,8 +1921,8 @@ bool document_close(zathura_t* zathura, bool keep_monitor) {
   if (override_predecessor) {
     /* do not override predecessor buffer with empty pages */
     unsigned int cur_page_num   = zathura_document_get_current_page_number(document);
-    ZathuraPageWidget* cur_page = ZATHURA_PAGE_WIDGET(zathura_page_get_widget_by_number(zathura, cur_page_num));
-    if (!zathura_page_widget_have_surface(cur_page)) {
+    GtkWidget* cur_page         = zathura_page_get_widget_by_number(zathura, cur_page_num);
+    if (cur_page == NULL || !zathura_page_widget_have_surface(ZATHURA_PAGE_WIDGET(cur_page))) {
       override_predecessor = false;
     }
   }
@@ -1402,10 +1942,13 @@ bool document_close(zathura_t* zathura, bool keep_monitor) {
 
   /* remove widgets */
   zathura_document_widget_clear_pages(ZATHURA_DOCUMENT_WIDGET(zathura->ui.document_widget));
+  g_clear_pointer(&zathura->global.search_results, zathura_search_results_free);
 
   if (!override_predecessor) {
     for (unsigned int i = 0; i < zathura_document_get_number_of_pages(document); i++) {
-      g_object_unref(zathura->pages[i]);
+      if (zathura->pages[i] != NULL) {
+        g_object_unref(zathura->pages[i]);
+      }
     }
     g_free(zathura->pages);
     zathura->pages = NULL;
@@ -1484,7 +2027,7 @@ void statusbar_page_number_update(zathura_t* zathura) {
     unsigned int current_page_number = zathura_document_get_current_page_number(document);
     unsigned int page_number_percent = number_of_pages ? 100 * (current_page_number + 1) / number_of_pages : 0;
 
-    zathura_page_t* page   = zathura_document_get_page(document, current_page_number);
+    zathura_page_t* page = zathura_document_get_page(document, current_page_number);
     const char* page_label = zathura_page_get_label(page, NULL);
 
     bool show_percent = false;
@@ -1669,11 +2212,16 @@ void zathura_show_signature_information(zathura_t* zathura, bool show) {
   g_value_init(&show_sig_info_value, G_TYPE_BOOLEAN);
   g_value_set_boolean(&show_sig_info_value, show);
 
+  /* widgets created later pick the setting up on their own */
+  zathura->global.draw_signatures = show;
+
   const unsigned int number_of_pages = zathura_document_get_number_of_pages(document);
   for (unsigned int page = 0; page != number_of_pages; ++page) {
     // draw signature info
-    GObject* page_widget = G_OBJECT(zathura_page_get_widget_by_number(zathura, page));
-    g_object_set_property(page_widget, "draw-signatures", &show_sig_info_value);
+    GtkWidget* page_widget = zathura_page_get_widget_by_number(zathura, page);
+    if (page_widget != NULL) {
+      g_object_set_property(G_OBJECT(page_widget), "draw-signatures", &show_sig_info_value);
+    }
   }
 }
 
@@ -1705,40 +2253,3 @@ zathura_document_t* zathura_get_document(zathura_t* zathura) {
 
   return zathura->document;
 }
-
-void zathura_modify_current_search_result(zathura_t* zathura, int diff) {
-  if (zathura->global.total_search_results == 0)
-    return;
-
-  if (diff == 0)
-    return;
-
-  int current = zathura->global.current_search_result;
-  int total   = zathura->global.total_search_results;
-  current += diff;
-  if (current >= total) {
-    current = current % total;
-  } else if (current < 0) {
-    current = total + (current % total);
-  }
-
-  if (current == 0) {
-    current = total;
-  }
-
-  zathura->global.current_search_result = current;
-}
-
-void zathura_set_current_search_result_previous_pages(zathura_t* zathura, unsigned int current_page_number) {
-  zathura->global.current_search_result = 0;
-  for (unsigned int page_id = 0; page_id < current_page_number; ++page_id) {
-    zathura_page_t* page = zathura_document_get_page(zathura->document, page_id);
-    if (page == NULL) {
-      continue;
-    }
-    int num_search_results = 0;
-    GtkWidget* page_widget = zathura_page_get_widget(zathura, page);
-    g_object_get(G_OBJECT(page_widget), "search-length", &num_search_results, NULL);
-    zathura->global.current_search_result += num_search_results;
-  }
-}
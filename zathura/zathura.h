@@ -17,6 +17,11 @@
 #include "types.h"
 #include "jumplist.h"
 #include "file-monitor.h"
+#include "page-loader.h"
+#include "prefetch.h"
+#include "search.h"
+#include "search-results.h"
+#include "text-index.h"
 
 enum {
   NEXT,
@@ -88,6 +93,7 @@ enum {
 enum {
   ZATHURA_PAGE_CACHE_DEFAULT_SIZE     = 16,
   ZATHURA_PAGE_CACHE_MAX_SIZE         = 1024,
+  ZATHURA_PAGE_CACHE_DEFAULT_MEMORY   = 512,
   ZATHURA_PAGE_THUMBNAIL_DEFAULT_SIZE = 4 * 1024 * 1024
 };
 
@@ -96,6 +102,10 @@ typedef struct _ZathuraDatabase zathura_database_t;
 typedef struct zathura_fileinfo_s zathura_fileinfo_t;
 /* forward declaration for types from content-type.h */
 typedef struct zathura_content_type_context_s zathura_content_type_context_t;
+/* document that is opened in the background */
+typedef struct zathura_document_open_task_s zathura_document_open_task_t;
+/* comparison of the pages of a reloaded document with its predecessor */
+typedef struct zathura_predecessor_reuse_s zathura_predecessor_reuse_t;
 
 struct zathura_s {
   struct {
@@ -125,7 +135,12 @@ struct zathura_s {
   } ui;
 
   struct {
-    ZathuraRenderer* render_thread; /**< The thread responsible for rendering the pages */
+    ZathuraRenderer* render_thread;                 /**< The thread responsible for rendering the pages */
+    zathura_page_loader_t* page_loader;             /**< Loads the sizes and labels of pages in the background */
+    zathura_search_t* search;                       /**< The last search */
+    zathura_text_index_t* text_index;               /**< Text of the pages to speed up searching */
+    zathura_document_open_task_t* document_open;    /**< The document that is being opened */
+    zathura_predecessor_reuse_t* predecessor_reuse; /**< Finds the pages that did not change on reload */
   } sync;
 
   struct {
@@ -151,8 +166,23 @@ struct zathura_s {
     GdkModifierType highlighter_modmask;  /**< Modifier to draw with a highlighter */
     bool double_click_follow;             /**< Double/Single click to follow link */
     GtkTreePath* current_index_path;      /**< Current index path */
-    int current_search_result;
-    int total_search_results;
+
+    zathura_search_results_t* search_results; /**< Search results of the open document */
+    bool draw_search_results;                 /**< Draw search results on new page widgets */
+    bool draw_signatures;                     /**< Draw signatures on new page widgets */
+
+    struct {
+      unsigned int first; /**< First page of the range checked for visibility */
+      unsigned int last;  /**< Last page of the range checked for visibility */
+      bool valid;         /**< The range belongs to the current layout */
+    } visible_pages;
+
+    struct {
+      zathura_prefetch_t tracker; /**< Vertical scroll velocity */
+      unsigned int first;         /**< First page of the prefetched range */
+      unsigned int last;          /**< Last page of the prefetched range */
+      bool valid;                 /**< A range was prefetched */
+    } prefetch;
   } global;
 
   struct {
@@ -371,7 +401,18 @@ bool document_open_synctex(zathura_t* zathura, const char* path, const char* uri
                            const char* synctex);
 
 /**
- * Opens a file (idle)
+ * Cancels opening the document that is opened in the background. The plugin
+ * cannot be interrupted, so the document is dropped once it is opened. Reloads
+ * of the shown document are not cancelled.
+ *
+ * @param zathura The zathura session
+ * @return true if a document was being opened, false otherwise
+ */
+bool document_open_cancel(zathura_t* zathura);
+
+/**
+ * Opens a file (idle). Reading, hashing and opening the file by the plugin
+ * happen on a worker thread, and the document is shown once it is opened.
  *
  * @param zathura The zathura session
  * @param path The path to the file
@@ -383,6 +424,15 @@ bool document_open_synctex(zathura_t* zathura, const char* path, const char* uri
 void document_open_idle(zathura_t* zathura, const char* path, const char* password, int page_number, const char* mode,
                         const char* synctex, const char* bookmark_name, const char* search_string);
 
+/**
+ * Reopens the monitored file (idle). The shown document is only replaced once
+ * the file has been opened again, and pages that did not change keep their
+ * rendered content.
+ *
+ * @param zathura The zathura session
+ */
+void document_reload(zathura_t* zathura);
+
 /**
  * Save a open file
  *
@@ -420,6 +470,16 @@ zathura_fileinfo_t zathura_get_prefileinfo(zathura_t* zathura);
  */
 bool document_predecessor_free(zathura_t* zathura);
 
+/**
+ * Shows the rendered pages of the predecessor document in the open document
+ * if their content did not change, so that only changed pages are rendered
+ * again after a reload. The pages are compared in a background thread and
+ * the rendered pages are taken over once the comparison is done.
+ *
+ * @param zathura The zathura session
+ */
+void document_predecessor_reuse_pages(zathura_t* zathura);
+
 /**
  * Closes the current opened document
  *
@@ -504,21 +564,4 @@ bool zathura_has_document(zathura_t* zathura);
  */
 zathura_document_t* zathura_get_document(zathura_t* zathura);
 
-/**
- * Modify and normalize the current search result count
- * so that it always inferior or equal to the total count
- *
- * @param zathura The zathura session
- * @param diff The amount to modify
- */
-void zathura_modify_current_search_result(zathura_t* zathura, int diff);
-
-/**
- * Set the current search result count to the last one before the current page
- *
- * @param zathura The zathura session
- * @param current_page_number The current page number
- */
-void zathura_set_current_search_result_previous_pages(zathura_t* zathura, unsigned int current_page_number);
-
 #endif // ZATHURA_H